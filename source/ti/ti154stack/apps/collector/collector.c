@@ -1801,41 +1801,24 @@ static void processSensorData(ApiMac_mcpsDataInd_t *pDataInd)
 }
 
 /*!
- * @brief      Find the associated device table entry matching pAddr.
+ * @brief      Find the associated device table entry matching an address.
+ *             Only short addresses are matched.
  *
- * @param      pAddr - pointer to device's address
+ * @param      pAddr - address to find
  *
  * @return     pointer to the associated device table entry,
  *             NULL if not found.
  */
 static Cllc_associated_devices_t *findDevice(ApiMac_sAddr_t *pAddr)
 {
-    int x;
-    Cllc_associated_devices_t *pItem = NULL;
-
     /* Check for invalid parameters */
-    if((pAddr == NULL) || (pAddr->addrMode == ApiMac_addrType_none))
+    if((pAddr == NULL) || (pAddr->addrMode != ApiMac_addrType_short)
+       || (pAddr->addr.shortAddr == CSF_INVALID_SHORT_ADDR))
     {
         return (NULL);
     }
 
-    for(x = 0; x < CONFIG_MAX_DEVICES; x++)
-    {
-        /* Make sure the entry is valid. */
-        if(Cllc_associatedDevList[x].shortAddr != CSF_INVALID_SHORT_ADDR)
-        {
-            if(pAddr->addrMode == ApiMac_addrType_short)
-            {
-                if(pAddr->addr.shortAddr == Cllc_associatedDevList[x].shortAddr)
-                {
-                    pItem = &Cllc_associatedDevList[x];
-                    break;
-                }
-            }
-        }
-    }
-
-    return (pItem);
+    return (Cllc_findDevice(pAddr->addr.shortAddr));
 }
 
 /*!
@@ -2511,24 +2494,19 @@ void smFailCMProcessCb(ApiMac_deviceDescriptor_t *devInfo, bool rxOnIdle,
         /* sensor not responding to process start message in key recovery mode */
         if ((fCommissionRequired) && (smErrorCode == SMMsgs_errorCode_reComm_sensor_notResp))
         {
-            int8_t i = 0;
+            Cllc_associated_devices_t *pDev;
 
-            /* find the index of the device with the above short address*/
-            for(i = 0; i <CONFIG_MAX_DEVICES ; i++)
+            /* find the device with the above short address*/
+            pDev = Cllc_findDevice(devInfo->shortAddress);
+            if(pDev != NULL)
             {
-                if(Cllc_associatedDevList[i].shortAddr == devInfo->shortAddress)
-                {
-                    /* found the index; so break */
-                    break;
-                }
-            }
-
-            /* set the reCM_status to pending*/
-            Cllc_associatedDevList[i].reCM_status = SM_RE_CM_PENDING;
+                /* set the reCM_status to pending*/
+                pDev->reCM_status = SM_RE_CM_PENDING;
 
-            /* mark the device not alive*/
-            Cllc_associatedDevList[i].status &=
-                                    ~(CLLC_ASSOC_STATUS_ALIVE| ASSOC_CONFIG_SENT | ASSOC_CONFIG_RSP);
+                /* mark the device not alive*/
+                pDev->status &=
+                        ~(CLLC_ASSOC_STATUS_ALIVE| ASSOC_CONFIG_SENT | ASSOC_CONFIG_RSP);
+            }
         }
         else
         {
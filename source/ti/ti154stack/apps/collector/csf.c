@@ -150,6 +150,15 @@
 /* Value returned from findDeviceListIndex() when not found */
 #define DEVICE_INDEX_NOT_FOUND  -1
 
+/* Number of hash buckets of the device list cache, must be a power of 2 */
+#ifndef CSF_DEV_CACHE_HASH_SIZE
+#define CSF_DEV_CACHE_HASH_SIZE       32
+#endif
+/* Bucket mask of the device list cache */
+#define CSF_DEV_CACHE_HASH_MASK       (CSF_DEV_CACHE_HASH_SIZE - 1)
+/* End of a device list cache chain */
+#define CSF_DEV_CACHE_INVALID_IDX     0xFFFF
+
 /*! NV driver item ID for reset reason */
 #define NVID_RESET {NVINTF_SYSID_APP, CSF_NV_RESET_REASON_ID, 0}
 
@@ -218,6 +227,29 @@ static bool started = false;
 /* The last saved coordinator frame counter */
 static uint32_t lastSavedCoordinatorFrameCounter = 0;
 
+/*
+ RAM copy of the device list stored in NV. Writes go to NV first and then to
+ the cache, so the cache always matches the NV records and lookups never
+ have to scan the flash.
+ */
+typedef struct
+{
+    /* copy of the NV device list record */
+    Llc_deviceListItem_t item;
+    /* NV sub ID of the record, CSF_INVALID_SUBID if the entry is free */
+    uint16_t subId;
+    /* next entry in the same short address bucket */
+    uint16_t shortNext;
+    /* next entry in the same extended address bucket */
+    uint16_t extNext;
+} devCacheEntry_t;
+
+static devCacheEntry_t devCache[CSF_MAX_DEVICELIST_ENTRIES];
+static uint16_t devCacheShortHead[CSF_DEV_CACHE_HASH_SIZE];
+static uint16_t devCacheExtHead[CSF_DEV_CACHE_HASH_SIZE];
+/* true once the cache has been filled from NV */
+static bool devCacheLoaded = false;
+
 #if defined(MT_CSF)
 /*! NV driver item ID for reset reason */
 static const NVINTF_itemID_t nvResetId = NVID_RESET;
@@ -269,6 +301,13 @@ static void updateDeviceListItem(Llc_deviceListItem_t *pItem);
 static int findDeviceListIndex(ApiMac_sAddrExt_t *pAddr);
 static int findUnusedDeviceListIndex(void);
 static void saveNumDeviceListEntries(uint16_t numEntries);
+static void devCacheReset(void);
+static void devCacheLoad(void);
+static uint16_t devCacheFind(ApiMac_sAddr_t *pDevAddr);
+static void devCachePut(uint16_t subId, Llc_deviceListItem_t *pItem);
+static void devCacheRemove(uint16_t idx);
+static uint16_t devCacheShortHash(uint16_t shortAddr);
+static uint16_t devCacheExtHash(ApiMac_sAddrExt_t *pExtAddr);
 #if defined(TEST_REMOVE_DEVICE)
 static void removeTheFirstDevice(void);
 #else
@@ -1257,39 +1296,14 @@ bool Csf_getDevice(ApiMac_sAddr_t *pDevAddr, Llc_deviceListItem_t *pItem)
 {
     if((pNV != NULL) && (pItem != NULL))
     {
-        uint16_t numEntries;
+        uint16_t idx;
 
-        numEntries = Csf_getNumDeviceListEntries();
-
-        if(numEntries > 0)
+        /* Served from the RAM copy of the device list */
+        idx = devCacheFind(pDevAddr);
+        if(idx != CSF_DEV_CACHE_INVALID_IDX)
         {
-            NVINTF_itemID_t id;
-
-            /* Setup NV ID for the device list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = CSF_NV_DEVICELIST_ID;
-            id.subID = 0;
-            /* Read Network Information from NV */
-            if(pDevAddr->addrMode == ApiMac_addrType_short)
-            {
-                pNV->readContItem(id, 0, sizeof(Llc_deviceListItem_t), pItem,
-                                      sizeof(uint16_t),
-                                      (uint16_t)((uint32_t)&pItem->devInfo.shortAddress-(uint32_t)&pItem->devInfo.panID),
-                                      &pDevAddr->addr.shortAddr, &id.subID);
-            }
-            else
-            {
-                pNV->readContItem(id, 0, sizeof(Llc_deviceListItem_t), pItem,
-                                      APIMAC_SADDR_EXT_LEN,
-                                      (uint16_t)((uint32_t)&pItem->devInfo.extAddress-(uint32_t)&pItem->devInfo.panID),
-                                      &pDevAddr->addr.extAddr, &id.subID);
-            }
-
-
-            if(id.subID != CSF_INVALID_SUBID)
-            {
-                return(true);
-            }
+            memcpy(pItem, &devCache[idx].item, sizeof(Llc_deviceListItem_t));
+            return(true);
         }
     }
     return (false);
@@ -1514,6 +1528,12 @@ void Csf_removeDeviceListItem(ApiMac_sAddrExt_t *pAddr)
             stat = pNV->deleteItem(id);
             if(stat == NVINTF_SUCCESS)
             {
+                ApiMac_sAddr_t devAddr;
+
+                devAddr.addrMode = ApiMac_addrType_extended;
+                memcpy(&devAddr.addr.extAddr, pAddr, sizeof(ApiMac_sAddrExt_t));
+                devCacheRemove(devCacheFind(&devAddr));
+
                 /* Update the number of entries */
                 uint16_t numEntries = Csf_getNumDeviceListEntries();
                 if(numEntries > 0)
@@ -1598,6 +1618,10 @@ void Csf_clearAllNVItems(void)
         pNV->deleteItem(id);
     }
 #endif /* end if for ONE_PAGE_NV */
+
+    /* Reload the device list cache from the cleared NV on next use */
+    devCacheReset();
+    devCacheLoaded = false;
 }
 
 /*!
@@ -1917,6 +1941,8 @@ static bool addDeviceListItem(Llc_deviceListItem_t *pItem, bool *pNewDevice)
                     stat = pNV->writeItem(id, sizeof(Llc_deviceListItem_t), pItem);
                     if(stat == NVINTF_SUCCESS)
                     {
+                        devCachePut(id.subID, pItem);
+
                         /* Update the number of entries */
                         numEntries++;
                         saveNumDeviceListEntries(numEntries);
@@ -1974,7 +2000,11 @@ static void updateDeviceListItem(Llc_deviceListItem_t *pItem)
             id.subID = (uint16_t)idx;
 
             /* write the device list record */
-            pNV->writeItem(id, sizeof(Llc_deviceListItem_t), pItem);
+            if(pNV->writeItem(id, sizeof(Llc_deviceListItem_t), pItem)
+                            == NVINTF_SUCCESS)
+            {
+                devCachePut(id.subID, pItem);
+            }
         }
     }
 }
@@ -1991,29 +2021,16 @@ static int findDeviceListIndex(ApiMac_sAddrExt_t *pAddr)
 {
     if((pNV != NULL) && (pAddr != NULL))
     {
-        uint16_t numEntries;
+        ApiMac_sAddr_t devAddr;
+        uint16_t idx;
 
-        numEntries = Csf_getNumDeviceListEntries();
+        devAddr.addrMode = ApiMac_addrType_extended;
+        memcpy(&devAddr.addr.extAddr, pAddr, sizeof(ApiMac_sAddrExt_t));
 
-        if(numEntries > 0)
+        idx = devCacheFind(&devAddr);
+        if(idx != CSF_DEV_CACHE_INVALID_IDX)
         {
-            NVINTF_itemID_t id;
-            Llc_deviceListItem_t item;
-
-            /* Setup NV ID for the device list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = CSF_NV_DEVICELIST_ID;
-            id.subID = 0;
-
-            /* Read Network Information from NV */
-            pNV->readContItem(id, 0, sizeof(Llc_deviceListItem_t), &item,
-                                  APIMAC_SADDR_EXT_LEN,
-                                  (uint16_t)((uint32_t)&item.devInfo.extAddress-(uint32_t)&item), pAddr, &id.subID);
-
-            if(id.subID != CSF_INVALID_SUBID)
-            {
-                return(id.subID);
-            }
+            return(devCache[idx].subId);
         }
     }
     return (DEVICE_INDEX_NOT_FOUND);
@@ -2060,6 +2077,221 @@ static void saveNumDeviceListEntries(uint16_t numEntries)
     }
 }
 
+/*!
+ * @brief       Empty the device list cache
+ */
+static void devCacheReset(void)
+{
+    uint16_t x;
+
+    for(x = 0; x < CSF_MAX_DEVICELIST_ENTRIES; x++)
+    {
+        devCache[x].subId = CSF_INVALID_SUBID;
+        devCache[x].shortNext = CSF_DEV_CACHE_INVALID_IDX;
+        devCache[x].extNext = CSF_DEV_CACHE_INVALID_IDX;
+    }
+    memset(devCacheShortHead, 0xFF, sizeof(devCacheShortHead));
+    memset(devCacheExtHead, 0xFF, sizeof(devCacheExtHead));
+}
+
+/*!
+ * @brief       Fill the device list cache from NV, once
+ */
+static void devCacheLoad(void)
+{
+    if((devCacheLoaded == false) && (pNV != NULL) && (pNV->readItem != NULL))
+    {
+        uint16_t numEntries;
+
+        devCacheReset();
+
+        numEntries = Csf_getNumDeviceListEntries();
+        if(numEntries > 0)
+        {
+            NVINTF_itemID_t id;
+            uint16_t readItems = 0;
+
+            /* Setup NV ID for the device list records */
+            id.systemID = NVINTF_SYSID_APP;
+            id.itemID = CSF_NV_DEVICELIST_ID;
+            id.subID = 0;
+
+            while((readItems < numEntries)
+                  && (id.subID < CSF_MAX_DEVICELIST_IDS))
+            {
+                Llc_deviceListItem_t item;
+
+                if(pNV->readItem(id, 0, sizeof(Llc_deviceListItem_t), &item)
+                                == NVINTF_SUCCESS)
+                {
+                    devCachePut(id.subID, &item);
+                    readItems++;
+                }
+                id.subID++;
+            }
+        }
+
+        devCacheLoaded = true;
+    }
+}
+
+/*!
+ * @brief       Find a device in the device list cache
+ *
+ * @param       pDevAddr - short or extended address of the device
+ *
+ * @return      index into the cache, CSF_DEV_CACHE_INVALID_IDX if not found
+ */
+static uint16_t devCacheFind(ApiMac_sAddr_t *pDevAddr)
+{
+    uint16_t idx = CSF_DEV_CACHE_INVALID_IDX;
+
+    devCacheLoad();
+
+    if(pDevAddr->addrMode == ApiMac_addrType_short)
+    {
+        idx = devCacheShortHead[devCacheShortHash(pDevAddr->addr.shortAddr)];
+        while((idx != CSF_DEV_CACHE_INVALID_IDX)
+              && (devCache[idx].item.devInfo.shortAddress
+                              != pDevAddr->addr.shortAddr))
+        {
+            idx = devCache[idx].shortNext;
+        }
+    }
+    else
+    {
+        idx = devCacheExtHead[devCacheExtHash(&pDevAddr->addr.extAddr)];
+        while((idx != CSF_DEV_CACHE_INVALID_IDX)
+              && (memcmp(devCache[idx].item.devInfo.extAddress,
+                         pDevAddr->addr.extAddr, APIMAC_SADDR_EXT_LEN) != 0))
+        {
+            idx = devCache[idx].extNext;
+        }
+    }
+
+    return (idx);
+}
+
+/*!
+ * @brief       Add or refresh a record in the device list cache, after it
+ *              has been written to NV
+ *
+ * @param       subId - NV sub ID of the record
+ * @param       pItem - pointer to the device list entry
+ */
+static void devCachePut(uint16_t subId, Llc_deviceListItem_t *pItem)
+{
+    uint16_t idx;
+    uint16_t bucket;
+
+    /* Drop any stale copy of the record first */
+    for(idx = 0; idx < CSF_MAX_DEVICELIST_ENTRIES; idx++)
+    {
+        if(devCache[idx].subId == subId)
+        {
+            devCacheRemove(idx);
+            break;
+        }
+    }
+
+    for(idx = 0; idx < CSF_MAX_DEVICELIST_ENTRIES; idx++)
+    {
+        if(devCache[idx].subId == CSF_INVALID_SUBID)
+        {
+            break;
+        }
+    }
+    if(idx == CSF_MAX_DEVICELIST_ENTRIES)
+    {
+        /* No room, lookups for this record will simply fail */
+        return;
+    }
+
+    memcpy(&devCache[idx].item, pItem, sizeof(Llc_deviceListItem_t));
+    devCache[idx].subId = subId;
+
+    bucket = devCacheShortHash(pItem->devInfo.shortAddress);
+    devCache[idx].shortNext = devCacheShortHead[bucket];
+    devCacheShortHead[bucket] = idx;
+
+    bucket = devCacheExtHash(&pItem->devInfo.extAddress);
+    devCache[idx].extNext = devCacheExtHead[bucket];
+    devCacheExtHead[bucket] = idx;
+}
+
+/*!
+ * @brief       Remove a record from the device list cache
+ *
+ * @param       idx - index into the cache, ignored if
+ *              CSF_DEV_CACHE_INVALID_IDX
+ */
+static void devCacheRemove(uint16_t idx)
+{
+    uint16_t *pLink;
+
+    if(idx >= CSF_MAX_DEVICELIST_ENTRIES)
+    {
+        return;
+    }
+
+    pLink = &devCacheShortHead[
+                devCacheShortHash(devCache[idx].item.devInfo.shortAddress)];
+    while((*pLink != CSF_DEV_CACHE_INVALID_IDX) && (*pLink != idx))
+    {
+        pLink = &devCache[*pLink].shortNext;
+    }
+    if(*pLink == idx)
+    {
+        *pLink = devCache[idx].shortNext;
+    }
+
+    pLink = &devCacheExtHead[
+                devCacheExtHash(&devCache[idx].item.devInfo.extAddress)];
+    while((*pLink != CSF_DEV_CACHE_INVALID_IDX) && (*pLink != idx))
+    {
+        pLink = &devCache[*pLink].extNext;
+    }
+    if(*pLink == idx)
+    {
+        *pLink = devCache[idx].extNext;
+    }
+
+    devCache[idx].subId = CSF_INVALID_SUBID;
+    devCache[idx].shortNext = CSF_DEV_CACHE_INVALID_IDX;
+    devCache[idx].extNext = CSF_DEV_CACHE_INVALID_IDX;
+}
+
+/*!
+ * @brief       Short address bucket of the device list cache
+ *
+ * @param       shortAddr - device's short address
+ *
+ * @return      bucket index
+ */
+static uint16_t devCacheShortHash(uint16_t shortAddr)
+{
+    return (shortAddr & CSF_DEV_CACHE_HASH_MASK);
+}
+
+/*!
+ * @brief       Extended address bucket of the device list cache
+ *
+ * @param       pExtAddr - device's extended address
+ *
+ * @return      bucket index
+ */
+static uint16_t devCacheExtHash(ApiMac_sAddrExt_t *pExtAddr)
+{
+    uint16_t hash = 0;
+    uint8_t x;
+
+    for(x = 0; x < APIMAC_SADDR_EXT_LEN; x++)
+    {
+        hash = (hash * 31) + (*pExtAddr)[x];
+    }
+    return (hash & CSF_DEV_CACHE_HASH_MASK);
+}
+
 #if defined(TEST_REMOVE_DEVICE)
 /*!
  * @brief       This is an example function on how to remove a device
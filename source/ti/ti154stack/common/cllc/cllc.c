@@ -127,6 +127,11 @@
 /*! percent filter */
 #define CONFIG_PERCENTFILTER              0xFF
 
+/*! End of an association table index chain */
+#define CLLC_DEV_INVALID_IDX              0xFFFF
+/*! Bucket mask of the association table indexes */
+#define CLLC_DEV_HASH_MASK                (CLLC_DEV_HASH_SIZE - 1)
+
 /******************************************************************************
  Security constants and definitions
  *****************************************************************************/
@@ -209,6 +214,12 @@ STATIC uint8_t chanMask[APIMAC_154G_CHANNEL_BITMAP_SIZ];
 STATIC panDescList_t *pPANDesclist = NULL;
 /* number of devices associated with the coordinator */
 STATIC uint16_t Cllc_numOfDevices = 0;
+/* association table index by short address: bucket heads and chain links */
+STATIC uint16_t devShortHashHead[CLLC_DEV_HASH_SIZE];
+STATIC uint16_t devShortHashNext[CONFIG_MAX_DEVICES];
+/* association table index by extended address: bucket heads and chain links */
+STATIC uint16_t devExtHashHead[CLLC_DEV_HASH_SIZE];
+STATIC uint16_t devExtHashNext[CONFIG_MAX_DEVICES];
 /* copy of MAC API callbacks */
 STATIC ApiMac_callbacks_t macCallbacksCopy = { 0 };
 /* copy of CLLC callbacks */
@@ -362,6 +373,11 @@ static void sendScanReq(ApiMac_scantype_t type);
 static void setTrickleTime(uint32_t *pTrickleTime, uint8_t frameType);
 static void processIncomingFHframe(uint8_t frameType);
 static void processIncomingAsyncUSIE(uint8_t frameType, uint8_t* pIEContent);
+static void devIndexReset(void);
+static void devIndexAdd(uint16_t idx);
+static void devIndexRemove(uint16_t idx);
+static uint16_t devShortHash(uint16_t shortAddr);
+static uint16_t devExtHash(ApiMac_sAddrExt_t *pExtAddr);
 
 /******************************************************************************
  Public Functions
@@ -417,6 +433,7 @@ void Cllc_init(ApiMac_callbacks_t *pMacCbs, Cllc_callbacks_t *pCllcCbs)
     /* initialize association table */
     memset(Cllc_associatedDevList, 0xFF,
            (sizeof(Cllc_associated_devices_t) * CONFIG_MAX_DEVICES));
+    devIndexReset();
 
     ApiMac_mlmeSetReqBool(ApiMac_attribute_RxOnWhenIdle,true);
 
@@ -893,42 +910,38 @@ ApiMac_status_t Cllc_setJoinPermit(uint32_t duration)
  */
 void Cllc_removeDevice(ApiMac_sAddrExt_t *pExtAddr)
 {
-    int8_t i = 0;
+    Cllc_associated_devices_t *pItem;
     uint16_t shortAddr = Csf_getDeviceShort(pExtAddr);
 
     if(shortAddr != CSF_INVALID_SHORT_ADDR)
     {
-        for(i = 0; i < CONFIG_MAX_DEVICES; i++)
+        pItem = Cllc_findDevice(shortAddr);
+        if(pItem != NULL)
         {
-            if(Cllc_associatedDevList[i].shortAddr == shortAddr)
-            {
 #ifdef FEATURE_MAC_SECURITY
-                /* Delete the device from the key table */
-                ApiMac_secDeleteDevice(pExtAddr);
+            /* Delete the device from the key table */
+            ApiMac_secDeleteDevice(pExtAddr);
 #endif
 
 #ifdef FEATURE_SECURE_COMMISSIONING
-                SM_removeEntryFromSeedKeyTable(pExtAddr);
+            SM_removeEntryFromSeedKeyTable(pExtAddr);
 #endif
-                /* Clear the entry - delete */
-                memset(&Cllc_associatedDevList[i], 0xFF,
-                       sizeof(Cllc_associated_devices_t));
-                /* remove from NV */
-                Csf_removeDeviceListItem(pExtAddr);
-
-                /* update CUI */
-                #ifndef __unix__
-                Csf_deviceDisassocUpdate(shortAddr);
-                #else
-                ApiMac_sAddr_t sAddr;
-                sAddr.addr.shortAddr = shortAddr;
-                sAddr.addrMode = ApiMac_addrType_short;
-
-                Csf_deviceDisassocUpdate(&sAddr);
-                #endif
-                /* The corresponding device is removed, return from the function call */
-                return;
-            }
+            /* Clear the entry - delete */
+            devIndexRemove((uint16_t)(pItem - Cllc_associatedDevList));
+            memset(pItem, 0xFF, sizeof(Cllc_associated_devices_t));
+            /* remove from NV */
+            Csf_removeDeviceListItem(pExtAddr);
+
+            /* update CUI */
+            #ifndef __unix__
+            Csf_deviceDisassocUpdate(shortAddr);
+            #else
+            ApiMac_sAddr_t sAddr;
+            sAddr.addr.shortAddr = shortAddr;
+            sAddr.addrMode = ApiMac_addrType_short;
+
+            Csf_deviceDisassocUpdate(&sAddr);
+            #endif
         }
     }
 }
@@ -1106,13 +1119,57 @@ ApiMac_status_t Cllc_addSecDevice(uint16_t panID, uint16_t shortAddr,
 Cllc_associated_devices_t *Cllc_findDevice(uint16_t shortAddr)
 {
     int x;
+    uint16_t idx;
+
+    if(shortAddr == CSF_INVALID_SHORT_ADDR)
+    {
+        /* Free entries are not indexed, look for the first one */
+        for(x = 0; (x < CONFIG_MAX_DEVICES); x++)
+        {
+            if(shortAddr == Cllc_associatedDevList[x].shortAddr)
+            {
+                return (&Cllc_associatedDevList[x]);
+            }
+        }
+        return (NULL);
+    }
+
+    for(idx = devShortHashHead[devShortHash(shortAddr)];
+        idx != CLLC_DEV_INVALID_IDX; idx = devShortHashNext[idx])
+    {
+        if(shortAddr == Cllc_associatedDevList[idx].shortAddr)
+        {
+            return (&Cllc_associatedDevList[idx]);
+        }
+    }
+    return (NULL);
+}
+
+/*!
+ * @brief      Find the associated device table entry matching an
+ *             extended address.
+ *
+ * @param      pExtAddr - device's extended address
+ *
+ * @return     pointer to the associated device table entry,
+ *             NULL if not found.
+ */
+Cllc_associated_devices_t *Cllc_findDeviceExt(ApiMac_sAddrExt_t *pExtAddr)
+{
+    uint16_t idx;
 
-    for(x = 0; (x < CONFIG_MAX_DEVICES); x++)
+    if(pExtAddr == NULL)
     {
-        /* Make sure the entry is valid. */
-        if(shortAddr == Cllc_associatedDevList[x].shortAddr)
+        return (NULL);
+    }
+
+    for(idx = devExtHashHead[devExtHash(pExtAddr)];
+        idx != CLLC_DEV_INVALID_IDX; idx = devExtHashNext[idx])
+    {
+        if(memcmp(Cllc_associatedDevList[idx].extAddr, *pExtAddr,
+                  APIMAC_SADDR_EXT_LEN) == 0)
         {
-            return (&Cllc_associatedDevList[x]);
+            return (&Cllc_associatedDevList[idx]);
         }
     }
     return (NULL);
@@ -1583,6 +1640,103 @@ static void disassocIndCb(ApiMac_mlmeDisassociateInd_t *pData)
     }
 }
 
+/*!
+ * @brief       Empty the association table short and extended address
+ *              indexes.
+ */
+static void devIndexReset(void)
+{
+    memset(devShortHashHead, 0xFF, sizeof(devShortHashHead));
+    memset(devExtHashHead, 0xFF, sizeof(devExtHashHead));
+    memset(devShortHashNext, 0xFF, sizeof(devShortHashNext));
+    memset(devExtHashNext, 0xFF, sizeof(devExtHashNext));
+}
+
+/*!
+ * @brief       Link an association table entry into the address indexes.
+ *
+ * @param       idx - index of the entry in Cllc_associatedDevList
+ */
+static void devIndexAdd(uint16_t idx)
+{
+    uint16_t bucket;
+
+    bucket = devShortHash(Cllc_associatedDevList[idx].shortAddr);
+    devShortHashNext[idx] = devShortHashHead[bucket];
+    devShortHashHead[bucket] = idx;
+
+    bucket = devExtHash(&Cllc_associatedDevList[idx].extAddr);
+    devExtHashNext[idx] = devExtHashHead[bucket];
+    devExtHashHead[bucket] = idx;
+}
+
+/*!
+ * @brief       Unlink an association table entry from the address
+ *              indexes. Must be called before the entry is cleared.
+ *
+ * @param       idx - index of the entry in Cllc_associatedDevList
+ */
+static void devIndexRemove(uint16_t idx)
+{
+    uint16_t *pLink;
+
+    pLink = &devShortHashHead[devShortHash(Cllc_associatedDevList[idx].shortAddr)];
+    while((*pLink != CLLC_DEV_INVALID_IDX) && (*pLink != idx))
+    {
+        pLink = &devShortHashNext[*pLink];
+    }
+    if(*pLink == idx)
+    {
+        *pLink = devShortHashNext[idx];
+    }
+
+    pLink = &devExtHashHead[devExtHash(&Cllc_associatedDevList[idx].extAddr)];
+    while((*pLink != CLLC_DEV_INVALID_IDX) && (*pLink != idx))
+    {
+        pLink = &devExtHashNext[*pLink];
+    }
+    if(*pLink == idx)
+    {
+        *pLink = devExtHashNext[idx];
+    }
+
+    devShortHashNext[idx] = CLLC_DEV_INVALID_IDX;
+    devExtHashNext[idx] = CLLC_DEV_INVALID_IDX;
+}
+
+/*!
+ * @brief       Short address index bucket. Short addresses are handed out
+ *              sequentially, so the low bits spread them evenly.
+ *
+ * @param       shortAddr - device's short address
+ *
+ * @return      bucket index
+ */
+static uint16_t devShortHash(uint16_t shortAddr)
+{
+    return (shortAddr & CLLC_DEV_HASH_MASK);
+}
+
+/*!
+ * @brief       Extended address index bucket.
+ *
+ * @param       pExtAddr - device's extended address
+ *
+ * @return      bucket index
+ */
+static uint16_t devExtHash(ApiMac_sAddrExt_t *pExtAddr)
+{
+    uint8_t i;
+    uint16_t hash = 0;
+
+    for(i = 0; i < APIMAC_SADDR_EXT_LEN; i++)
+    {
+        hash = (hash * 31) + (*pExtAddr)[i];
+    }
+
+    return (hash & CLLC_DEV_HASH_MASK);
+}
+
 /*!
  * @brief       Function to add or update a device in association table
  *
@@ -1614,24 +1768,24 @@ static void maintainAssocTable(ApiMac_deviceDescriptor_t *pDevInfo,
 
             /* insert one of the blank spaces in the table */
             pItem->shortAddr = pDevInfo->shortAddress;
+            Util_copyExtAddr(&pItem->extAddr, &pDevInfo->extAddress);
             memcpy(&pItem->capInfo, pCapInfo, sizeof(ApiMac_capabilityInfo_t));
             pItem->rssi = rssi;
             pItem->status = status;
+
+            devIndexAdd((uint16_t)(pItem - Cllc_associatedDevList));
         }
     }
     else if(mode == true)
     {
-        uint16_t shortAddr = Csf_getDeviceShort(&pDevInfo->extAddress);
-        if(shortAddr != CSF_INVALID_SHORT_ADDR)
-        {
-            static Cllc_associated_devices_t *pItem;
+        Cllc_associated_devices_t *pItem;
 
-            pItem = Cllc_findDevice(shortAddr);
-            if(pItem != NULL)
-            {
-                pItem->rssi = rssi;
-                pItem->status = status;
-            }
+        /* the extended address index avoids looking it up in NV */
+        pItem = Cllc_findDeviceExt(&pDevInfo->extAddress);
+        if(pItem != NULL)
+        {
+            pItem->rssi = rssi;
+            pItem->status = status;
         }
     }
 }
@@ -77,6 +77,14 @@ extern "C"
 /*! Association status */
 #define CLLC_ASSOC_STATUS_ALIVE 0x0001
 
+/*!
+ Number of buckets in each association table address index, must be a
+ power of 2. Sized for about one device per bucket.
+ */
+#ifndef CLLC_DEV_HASH_SIZE
+#define CLLC_DEV_HASH_SIZE      64
+#endif
+
 /*!
  Coordinator State Values
  */
@@ -122,6 +130,8 @@ typedef struct
 {
     /*! Short address of associated device */
     uint16_t shortAddr;
+    /*! Extended address of associated device */
+    ApiMac_sAddrExt_t extAddr;
     /*! capability information */
     ApiMac_capabilityInfo_t capInfo;
     /*! RSSI */
@@ -425,8 +435,8 @@ extern ApiMac_status_t Cllc_addSecDevice(uint16_t panID,
                                               uint32_t frameCounter);
 
 /*!
- * @brief      Find the associated device table entry matching an
- *             extended address.
+ * @brief      Find the associated device table entry matching a
+ *             short address. CSF_INVALID_SHORT_ADDR finds a free entry.
  *
  * @param      shortAddr - device's short address
  *
@@ -434,6 +444,17 @@ extern ApiMac_status_t Cllc_addSecDevice(uint16_t panID,
  *             NULL if not found.
  */
 extern Cllc_associated_devices_t *Cllc_findDevice(uint16_t shortAddr);
+
+/*!
+ * @brief      Find the associated device table entry matching an
+ *             extended address.
+ *
+ * @param      pExtAddr - device's extended address
+ *
+ * @return     pointer to the associated device table entry,
+ *             NULL if not found.
+ */
+extern Cllc_associated_devices_t *Cllc_findDeviceExt(ApiMac_sAddrExt_t *pExtAddr);
 //*****************************************************************************
 //*****************************************************************************
 
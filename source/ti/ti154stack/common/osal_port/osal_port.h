@@ -73,6 +73,10 @@ extern "C"
 #define OsalPort_MSG_LEN(pMsg)      ((OsalPort_MsgHdr *) (pMsg) - 1)->len
 #define OsalPort_MSG_ID(pMsg)      ((OsalPort_MsgHdr *) (pMsg) - 1)->dest_id
 
+#define OsalPort_MSG_TQ_EMPTY(pTQ)   ((pTQ)->head == NULL)
+#define OsalPort_MSG_TQ_HEAD(pTQ)    ((pTQ)->head)
+#define OsalPort_MSG_TQ_COUNT(pTQ)   ((pTQ)->count)
+
 #define OsalPort_OFFSET_OF(type, member) ((uint32) &(((type *) 0)->member))
 
 /*********************************************************************
@@ -129,6 +133,20 @@ typedef struct
 
 typedef void * OsalPort_MsgQ;
 
+/* Called instead of freeing a message that lives in a registered static
+ * message pool, so the owner of the pool can reuse its slot. */
+typedef void (*OsalPort_MsgPoolRelease)(uint8_t *pMsg);
+
+/* Message queue with tail pointer and element count, so enqueue, dequeue
+ * and count are constant time. head is the first member, so the address of
+ * an OsalPort_MsgTailQ can be read as an OsalPort_MsgQ to walk the queue. */
+typedef struct
+{
+  void     *head;
+  void     *tail;
+  uint16_t  count;
+} OsalPort_MsgTailQ;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -209,6 +227,27 @@ extern uint8_t * OsalPort_msgAllocate(uint16_t len );
  */
 extern uint8_t OsalPort_msgDeallocate( uint8_t *pMsg );
 
+/*********************************************************************
+ * @fn      OsalPort_msgPoolRegister
+ *
+ * @brief
+ *
+ *    Register a block of preallocated message buffers.  Each buffer in the
+ *    block must start with an OsalPort_MsgHdr laid out as by
+ *    OsalPort_msgAllocate().  OsalPort_msgDeallocate() hands any message
+ *    inside [pStart, pEnd) to pfnRelease instead of freeing it.
+ *
+ *
+ * @param   uint8_t *pStart - first byte of the pool
+ * @param   uint8_t *pEnd - first byte past the end of the pool
+ * @param   OsalPort_MsgPoolRelease pfnRelease - slot release callback
+ *
+ * @return  OsalPort_SUCCESS, OsalPort_INVALIDPARAMETER, or
+ *          OsalPort_FAILURE if the pool table is full
+ */
+extern uint8_t OsalPort_msgPoolRegister( uint8_t *pStart, uint8_t *pEnd,
+                                         OsalPort_MsgPoolRelease pfnRelease );
+
 /*********************************************************************
  * @fn      OsalPort_msgSend
  *
@@ -409,6 +448,108 @@ extern void OsalPort_msgPush( OsalPort_MsgQ *pQ, void *pMsg );
  */
 extern void OsalPort_msgExtract( OsalPort_MsgQ *pQ, void *pMsg, void *pPrev );
 
+/*********************************************************************
+ * @fn      OsalPort_msgTailQInit
+ *
+ * @brief
+ *
+ *    This function initializes an empty OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  none
+ */
+extern void OsalPort_msgTailQInit( OsalPort_MsgTailQ *pTQ );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQEnqueue
+ *
+ * @brief
+ *
+ *    This function enqueues an OSAL message at the tail of an OSAL
+ *    tail queue in constant time.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ *
+ * @return  none
+ */
+extern void OsalPort_msgTailQEnqueue( OsalPort_MsgTailQ *pTQ, void *pMsg );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQEnqueueMax
+ *
+ * @brief
+ *
+ *    This function enqueues an OSAL message into an OSAL tail queue if
+ *    the length of the queue is less than max.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ * @param   uint8_t max - maximum length of queue
+ *
+ * @return  true if message was enqueued, false otherwise
+ */
+extern uint8_t OsalPort_msgTailQEnqueueMax( OsalPort_MsgTailQ *pTQ, void *pMsg, uint8_t max );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQDequeue
+ *
+ * @brief
+ *
+ *    This function dequeues an OSAL message from the head of an OSAL
+ *    tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  void * - pointer to OSAL message or NULL if queue is empty.
+ */
+extern void *OsalPort_msgTailQDequeue( OsalPort_MsgTailQ *pTQ );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQPush
+ *
+ * @brief
+ *
+ *    This function pushes an OSAL message to the head of an OSAL
+ *    tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ *
+ * @return  none
+ */
+extern void OsalPort_msgTailQPush( OsalPort_MsgTailQ *pTQ, void *pMsg );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQExtract
+ *
+ * @brief
+ *
+ *    This function extracts and removes an OSAL message from the
+ *    middle of an OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message to be extracted
+ * @param   void *pPrev  - OSAL message before pMsg in queue, NULL if head
+ *
+ * @return  none
+ */
+extern void OsalPort_msgTailQExtract( OsalPort_MsgTailQ *pTQ, void *pMsg, void *pPrev );
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQCount
+ *
+ * @brief
+ *
+ *    This function returns the number of messages in an OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  number of queued messages
+ */
+extern uint16_t OsalPort_msgTailQCount( OsalPort_MsgTailQ *pTQ );
+
 /*********************************************************************
  * @fn      OsalPort_pwrmgr_task_state
  *
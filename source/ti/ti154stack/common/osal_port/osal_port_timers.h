@@ -76,10 +76,32 @@ extern "C"
  */
 #define OsalPortTimers_TIMERS_MAX_TIMEOUT 0x28f5c28e /* unit is ms*/
 
+/* Number of pooled timers. Each slot holds a statically allocated Clock
+ * object that is reused between timers. Timers started while the pool is
+ * full are allocated from the heap and freed again when they stop.
+ */
+#ifndef OsalPortTimers_POOL_SIZE
+#define OsalPortTimers_POOL_SIZE 32
+#endif
+
+/* Pool slots are indexed with a uint8_t and 0xFF marks the end of a chain */
+#if OsalPortTimers_POOL_SIZE >= 0xFF
+#error "OsalPortTimers_POOL_SIZE must be less than 255"
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+/* Timer pool usage counters */
+typedef struct
+{
+  uint16_t activeTimers;     /* timers currently running */
+  uint16_t peakActiveTimers; /* highest activeTimers seen */
+  uint16_t heapTimers;       /* running timers allocated from the heap */
+  uint16_t allocFailures;    /* starts rejected because the heap was full too */
+} OsalPortTimers_Stats_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -172,6 +194,17 @@ extern uint8_t OsalPortTimers_stopTimer(uint8_t taskId, uint32_t eventId);
  */
 extern uint32_t OsalPortTimers_getTimerTimeout(uint8_t taskId, uint32_t eventId); 
 
+/*********************************************************************
+ * @fn      OsalPortTimers_getStats
+ *
+ * @brief   Get the timer pool usage counters
+ *
+ * @param   pStats - where to copy the counters
+ *
+ * @return  void
+ */
+extern void OsalPortTimers_getStats(OsalPortTimers_Stats_t *pStats);
+
 
 /*********************************************************************
 *********************************************************************/
@@ -72,6 +72,9 @@ extern void halAssertHandler(void);
 /* Only 1 application can talk to the MAC */
 #define MAX_TASKS 15
 
+/* Number of static message pools that can be registered */
+#define MAX_MSG_POOLS 2
+
 /***** Variable declarations *****/
 
 
@@ -93,7 +96,7 @@ typedef struct
 {
     uint8_t taskId;
     Task_Handle taskHndl;
-    OsalPort_MsgQ qHandle;
+    OsalPort_MsgTailQ qHandle;
     Semaphore_Handle taskSem;
     bool conservePower;
     uint32_t* pEventFlag;
@@ -108,9 +111,19 @@ typedef struct
   uint32_t largestFreeSize;
 } ICall_heapStats_t;
 
+typedef struct
+{
+    uint8_t *pStart;
+    uint8_t *pEnd;
+    OsalPort_MsgPoolRelease pfnRelease;
+} MsgPoolEntry;
+
 /*static*/ TaskEntry taskTbl[MAX_TASKS];
 /*static*/ uint8_t taskCnt = 0;
 
+static MsgPoolEntry msgPoolTbl[MAX_MSG_POOLS];
+static uint8_t msgPoolCnt = 0;
+
 /* instantiate variable referenced in ROM but not used */
 uint16_t *macTasksEvents = 0;
 
@@ -208,7 +221,7 @@ uint8_t OsalPort_registerTask(Task_Handle taskHndl, Semaphore_Handle taskSem, ui
         taskTbl[taskCnt].taskId = taskCnt;
         taskTbl[taskCnt].taskHndl = taskHndl;
         taskTbl[taskCnt].taskSem = taskSem;
-        taskTbl[taskCnt].qHandle = NULL;
+        OsalPort_msgTailQInit(&taskTbl[taskCnt].qHandle);
         taskTbl[taskCnt].conservePower = false;
         taskTbl[taskCnt].pEventFlag = pEvent;
     }
@@ -306,6 +319,7 @@ uint8_t * OsalPort_msgAllocate(uint16_t len )
 uint8_t OsalPort_msgDeallocate( uint8_t *pMsg )
 {
     uint8_t *x;
+    uint8_t i;
 
     if ( pMsg == NULL )
         return ( OsalPort_INVALID_MSG_POINTER );
@@ -314,6 +328,16 @@ uint8_t OsalPort_msgDeallocate( uint8_t *pMsg )
     if ( OsalPort_MSG_ID( pMsg ) != OsalPort_TASK_NO_TASK )
         return ( OsalPort_MSG_BUFFER_NOT_AVAIL );
 
+    // give preallocated buffers back to their pool
+    for ( i = 0; i < msgPoolCnt; i++ )
+    {
+        if ( (pMsg >= msgPoolTbl[i].pStart) && (pMsg < msgPoolTbl[i].pEnd) )
+        {
+            msgPoolTbl[i].pfnRelease( pMsg );
+            return ( OsalPort_SUCCESS );
+        }
+    }
+
     x = (uint8_t *)((uint8_t *)pMsg - sizeof( OsalPort_MsgHdr ));
 
     OsalPort_free( (void *)x );
@@ -321,6 +345,45 @@ uint8_t OsalPort_msgDeallocate( uint8_t *pMsg )
     return ( OsalPort_SUCCESS );
 }
 
+/*********************************************************************
+ * @fn      OsalPort_msgPoolRegister
+ *
+ * @brief
+ *
+ *    Register a block of preallocated message buffers.  Messages inside
+ *    [pStart, pEnd) are handed to pfnRelease by OsalPort_msgDeallocate()
+ *    instead of being freed.
+ *
+ *
+ * @param   uint8_t *pStart - first byte of the pool
+ * @param   uint8_t *pEnd - first byte past the end of the pool
+ * @param   OsalPort_MsgPoolRelease pfnRelease - slot release callback
+ *
+ * @return  OsalPort_SUCCESS, OsalPort_FAILURE
+ */
+uint8_t OsalPort_msgPoolRegister( uint8_t *pStart, uint8_t *pEnd,
+                                  OsalPort_MsgPoolRelease pfnRelease )
+{
+    uint32_t key;
+    uint8_t status = OsalPort_FAILURE;
+
+    if ( (pStart == NULL) || (pEnd <= pStart) || (pfnRelease == NULL) )
+        return ( OsalPort_INVALIDPARAMETER );
+
+    key = OsalPort_enterCS();
+    if ( msgPoolCnt < MAX_MSG_POOLS )
+    {
+        msgPoolTbl[msgPoolCnt].pStart = pStart;
+        msgPoolTbl[msgPoolCnt].pEnd = pEnd;
+        msgPoolTbl[msgPoolCnt].pfnRelease = pfnRelease;
+        msgPoolCnt++;
+        status = OsalPort_SUCCESS;
+    }
+    OsalPort_leaveCS(key);
+
+    return ( status );
+}
+
 /*********************************************************************
  * @fn      OsalPort_msgSend
  *
@@ -355,7 +418,7 @@ uint8_t OsalPort_msgSend( uint8_t destinationTask, uint8_t *pMsg )
         {
             key = OsalPort_enterCS();
 
-            OsalPort_msgEnqueue(&taskTbl[taskIdx].qHandle, pMsg );
+            OsalPort_msgTailQEnqueue(&taskTbl[taskIdx].qHandle, pMsg );
             OsalPort_setEvent(destinationTask, OsalPort_SYS_EVENT_MSG);
 
             OsalPort_leaveCS(key);
@@ -398,7 +461,7 @@ OsalPort_EventHdr* OsalPort_msgFind(uint8_t taskId, uint8_t event)
     {
         if(taskTbl[taskIdx].taskId == taskId)
         {
-            pHdr = (OsalPort_MsgHdr*) taskTbl[taskIdx].qHandle;
+            pHdr = (OsalPort_MsgHdr*) OsalPort_MSG_TQ_HEAD(&taskTbl[taskIdx].qHandle);
 
             // Look through the tasks queue for a message that matches the task_id and event parameters.
             while (pHdr != NULL)
@@ -441,10 +504,10 @@ uint8_t *OsalPort_msgReceive( uint8_t destinationTask )
     {
         if(taskTbl[taskIdx].taskId == destinationTask)
         {
-            pMsg = OsalPort_msgDequeue( &taskTbl[taskIdx].qHandle );
+            pMsg = OsalPort_msgTailQDequeue( &taskTbl[taskIdx].qHandle );
 
             // Are there any more messages?
-            if ( OsalPort_MSG_Q_EMPTY(&taskTbl[taskIdx].qHandle) )
+            if ( OsalPort_MSG_TQ_EMPTY(&taskTbl[taskIdx].qHandle) )
             {
                 // Clear message event
                 OsalPort_clearEvent(taskIdx, OsalPort_SYS_EVENT_MSG);
@@ -644,7 +707,7 @@ void OsalPort_msgEnqueue( OsalPort_MsgQ *pQ, void *pMsg )
  */
 uint8_t OsalPort_msgEnqueueMax( OsalPort_MsgQ *pQ, void *pMsg, uint8_t max )
 {
-    void *list;
+    void *list = NULL;
     uint32_t key;
     uint32_t qCount = 0;
     uint8_t status = 0;
@@ -652,15 +715,24 @@ uint8_t OsalPort_msgEnqueueMax( OsalPort_MsgQ *pQ, void *pMsg, uint8_t max )
     // Hold off interrupts
     key = OsalPort_enterCS();
 
-    // Find element count
+    // Find element count and end of queue in a single walk
     if(*pQ != NULL)
     {
         for ( list = *pQ; OsalPort_MSG_NEXT( list ) != NULL; list = OsalPort_MSG_NEXT( list ), qCount++ );
     }
 
-    if(qCount < max)
+    if((qCount < max) && (pMsg != NULL))
     {
-        OsalPort_msgEnqueue(pQ, pMsg);
+        OsalPort_MSG_NEXT( pMsg ) = NULL;
+
+        if ( list == NULL )
+        {
+            *pQ = pMsg;
+        }
+        else
+        {
+            OsalPort_MSG_NEXT( list ) = pMsg;
+        }
         status = 1;
     }
 
@@ -732,24 +804,14 @@ OsalPort_EventHdr* OsalPort_msgFindDequeue(uint8_t taskId, uint8_t event)
     {
         if(taskTbl[taskIdx].taskId == taskId)
         {
-            pHdr = (OsalPort_MsgHdr*) taskTbl[taskIdx].qHandle;
+            pHdr = (OsalPort_MsgHdr*) OsalPort_MSG_TQ_HEAD(&taskTbl[taskIdx].qHandle);
 
             // Look through the tasks queue for a message that matches the task_id and event parameters.
             while (pHdr != NULL)
             {
               if (((OsalPort_EventHdr *)pHdr)->event == event)
               {
-
-                if(pPrev == NULL)
-                {
-                  OsalPort_MSG_Q_HEAD(&taskTbl[taskIdx].qHandle) = OsalPort_MSG_NEXT(pHdr);
-                }
-                else
-                {
-                  OsalPort_MSG_NEXT(pPrev) = OsalPort_MSG_NEXT(pHdr);
-                }
-                OsalPort_MSG_NEXT( pHdr ) = NULL;
-                OsalPort_MSG_ID( pHdr ) = OsalPort_TASK_NO_TASK;
+                OsalPort_msgTailQExtract(&taskTbl[taskIdx].qHandle, pHdr, pPrev);
                 break;
               }
 
@@ -831,6 +893,234 @@ void OsalPort_msgExtract( OsalPort_MsgQ *pQ, void *pMsg, void *pPrev )
     OsalPort_leaveCS(key);
 }
 
+/*********************************************************************
+ * @fn      OsalPort_msgTailQInit
+ *
+ * @brief
+ *
+ *    This function initializes an empty OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  none
+ */
+void OsalPort_msgTailQInit( OsalPort_MsgTailQ *pTQ )
+{
+    pTQ->head = NULL;
+    pTQ->tail = NULL;
+    pTQ->count = 0;
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQEnqueue
+ *
+ * @brief
+ *
+ *    This function enqueues an OSAL message at the tail of an OSAL
+ *    tail queue in constant time.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ *
+ * @return  none
+ */
+void OsalPort_msgTailQEnqueue( OsalPort_MsgTailQ *pTQ, void *pMsg )
+{
+    uint32_t key;
+
+    // Hold off interrupts
+    key = OsalPort_enterCS();
+
+    if (pMsg) {
+        OsalPort_MSG_NEXT( pMsg ) = NULL;
+        // If first message in queue
+        if ( pTQ->head == NULL )
+        {
+            pTQ->head = pMsg;
+        }
+        else
+        {
+            // Add message to end of queue
+            OsalPort_MSG_NEXT( pTQ->tail ) = pMsg;
+        }
+        pTQ->tail = pMsg;
+        pTQ->count++;
+    }
+
+    // Re-enable interrupts
+    OsalPort_leaveCS(key);
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQEnqueueMax
+ *
+ * @brief
+ *
+ *    This function enqueues an OSAL message into an OSAL tail queue if
+ *    the length of the queue is less than max.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ * @param   uint8_t max - maximum length of queue
+ *
+ * @return  true if message was enqueued, false otherwise
+ */
+uint8_t OsalPort_msgTailQEnqueueMax( OsalPort_MsgTailQ *pTQ, void *pMsg, uint8_t max )
+{
+    uint32_t key;
+    uint8_t status = 0;
+
+    // Hold off interrupts
+    key = OsalPort_enterCS();
+
+    if((pTQ->count < max) && (pMsg != NULL))
+    {
+        OsalPort_msgTailQEnqueue(pTQ, pMsg);
+        status = 1;
+    }
+
+    // Re-enable interrupts
+    OsalPort_leaveCS(key);
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQDequeue
+ *
+ * @brief
+ *
+ *    This function dequeues an OSAL message from the head of an OSAL
+ *    tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  void * - pointer to OSAL message or NULL if queue is empty.
+ */
+void *OsalPort_msgTailQDequeue( OsalPort_MsgTailQ *pTQ )
+{
+    void *pMsg = NULL;
+    uint32_t key;
+
+    // Hold off interrupts
+    key = OsalPort_enterCS();
+
+    if ( pTQ->head != NULL )
+    {
+        // Dequeue message
+        pMsg = pTQ->head;
+        pTQ->head = OsalPort_MSG_NEXT( pMsg );
+        if ( pTQ->head == NULL )
+        {
+            pTQ->tail = NULL;
+        }
+        pTQ->count--;
+
+        OsalPort_MSG_NEXT( pMsg ) = NULL;
+        OsalPort_MSG_ID( pMsg ) = OsalPort_TASK_NO_TASK;
+    }
+
+    // Re-enable interrupts
+    OsalPort_leaveCS(key);
+
+    return pMsg;
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQPush
+ *
+ * @brief
+ *
+ *    This function pushes an OSAL message to the head of an OSAL
+ *    tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message
+ *
+ * @return  none
+ */
+void OsalPort_msgTailQPush( OsalPort_MsgTailQ *pTQ, void *pMsg )
+{
+    uint32_t key;
+
+    // Hold off interrupts
+    key = OsalPort_enterCS();
+
+    // Push message to head of queue
+    OsalPort_MSG_NEXT( pMsg ) = pTQ->head;
+    pTQ->head = pMsg;
+    if ( pTQ->tail == NULL )
+    {
+        pTQ->tail = pMsg;
+    }
+    pTQ->count++;
+
+    // Re-enable interrupts
+    OsalPort_leaveCS(key);
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQExtract
+ *
+ * @brief
+ *
+ *    This function extracts and removes an OSAL message from the
+ *    middle of an OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ * @param   void *pMsg  - OSAL message to be extracted
+ * @param   void *pPrev  - OSAL message before pMsg in queue, NULL if head
+ *
+ * @return  none
+ */
+void OsalPort_msgTailQExtract( OsalPort_MsgTailQ *pTQ, void *pMsg, void *pPrev )
+{
+    uint32_t key;
+
+    // Hold off interrupts
+    key = OsalPort_enterCS();
+
+    if ( pMsg == pTQ->head )
+    {
+        // remove from first
+        pTQ->head = OsalPort_MSG_NEXT( pMsg );
+        pPrev = NULL;
+    }
+    else
+    {
+        // remove from middle
+        OsalPort_MSG_NEXT( pPrev ) = OsalPort_MSG_NEXT( pMsg );
+    }
+
+    if ( pMsg == pTQ->tail )
+    {
+        pTQ->tail = pPrev;
+    }
+    pTQ->count--;
+
+    OsalPort_MSG_NEXT( pMsg ) = NULL;
+    OsalPort_MSG_ID( pMsg ) = OsalPort_TASK_NO_TASK;
+
+    // Re-enable interrupts
+    OsalPort_leaveCS(key);
+}
+
+/*********************************************************************
+ * @fn      OsalPort_msgTailQCount
+ *
+ * @brief
+ *
+ *    This function returns the number of messages in an OSAL tail queue.
+ *
+ * @param   OsalPort_MsgTailQ *pTQ - OSAL tail queue
+ *
+ * @return  number of queued messages
+ */
+uint16_t OsalPort_msgTailQCount( OsalPort_MsgTailQ *pTQ )
+{
+    return pTQ->count;
+}
+
 /*********************************************************************
  * @fn      OsalPort_pwrmgr_task_state
  *
@@ -55,29 +55,56 @@
 
 /***** Defines *****/
 
+/* Number of index buckets, must be a power of 2 */
+#define TIMER_HASH_SIZE     16
+#define TIMER_HASH_MASK     (TIMER_HASH_SIZE - 1)
+
+/* End of a bucket chain / free list */
+#define TIMER_INVALID_IDX   0xFF
+
 /***** Typedefs *****/
 
 typedef struct
 {
-    Clock_Handle clockHandle;
-    uint8_t taskId;
+    Clock_Struct clockStruct;
     uint32_t eventId;
+    uint8_t taskId;
     bool reload;
-    void* pNext;
+    bool active;
+    bool constructed;
+    bool fromHeap; /* allocated because the pool was full */
+    uint8_t next; /* next slot in the bucket chain or free list */
 } TimerEntry_t;
 
+/* Timer taken from the heap once the pool is exhausted */
+typedef struct TimerHeapEntry
+{
+    TimerEntry_t entry; /* must be first */
+    struct TimerHeapEntry* pNext;
+} TimerHeapEntry_t;
+
 /***** Variable declarations *****/
 static uint8_t stackTaskID;
 static uint32_t stackEventID;
 
 /***** Private variables *****/
-static TimerEntry_t* pTimerEntries = NULL;
-static TimerEntry_t* pDeleteTimerEntries = NULL;
+static TimerEntry_t timerPool[OsalPortTimers_POOL_SIZE];
+static uint8_t timerHash[TIMER_HASH_SIZE];
+static uint8_t timerFreeHead;
+static bool timerPoolInitialized = false;
+static OsalPortTimers_Stats_t timerStats;
+static TimerHeapEntry_t* pHeapTimerEntries = NULL;
+static TimerHeapEntry_t* pDeleteTimerEntries = NULL;
 
 /***** Private function definitions *****/
 static void timerCb(xdc_UArg arg);
 static uint8_t createTimerEntry(uint8_t taskId, uint32_t eventId, uint32_t timeout, bool reload);
 static TimerEntry_t* getTimerEntry(uint8_t taskId, uint32_t eventId);
+static TimerEntry_t* allocTimerEntry(uint8_t taskId, uint32_t eventId);
+static void freeHeapTimerEntry(TimerEntry_t* pTimerEntry);
+static void initTimerPool(void);
+static uint8_t timerHashIdx(uint8_t taskId, uint32_t eventId);
+static void releaseTimerEntry(TimerEntry_t* pTimerEntry);
 
 /***** Public function definitions *****/
 
@@ -151,28 +178,15 @@ uint8_t OsalPortTimers_stopTimer(uint8_t taskId, uint32_t eventId)
 
     pTimerEntry = getTimerEntry(taskId, eventId);
 
-    //Stop clock, remove from list and free memory
+    //Stop clock and return the entry to the pool or the heap
     if(pTimerEntry != NULL)
     {
-        Clock_stop(pTimerEntry->clockHandle);
-        Clock_delete(&(pTimerEntry->clockHandle));
+        Clock_stop(Clock_handle(&pTimerEntry->clockStruct));
+        releaseTimerEntry(pTimerEntry);
 
-        //is it first in list
-        if(pTimerEntry == pTimerEntries)
-        {
-            pTimerEntries = pTimerEntry->pNext;
-            OsalPort_free(pTimerEntry);
-        }
-        else
+        if(pTimerEntry->fromHeap)
         {
-            //find prev entry
-            TimerEntry_t* pTimerEntryPrev = pTimerEntries;
-            while(pTimerEntryPrev->pNext != pTimerEntry)
-            {
-                pTimerEntryPrev = pTimerEntryPrev->pNext;
-            }
-            pTimerEntryPrev->pNext = pTimerEntry->pNext;
-            OsalPort_free(pTimerEntry);
+            freeHeapTimerEntry(pTimerEntry);
         }
     }
     else
@@ -216,7 +230,7 @@ uint32_t OsalPortTimers_getTimerTimeout(uint8_t taskId, uint32_t eventId)
 
     if(pTimerEntry != NULL)
     {
-        timeoutTicks = Clock_getTimeout(pTimerEntry->clockHandle);
+        timeoutTicks = Clock_getTimeout(Clock_handle(&pTimerEntry->clockStruct));
         timeout = timeoutTicks / (1000 / Clock_tickPeriod);
     }
 
@@ -226,30 +240,55 @@ uint32_t OsalPortTimers_getTimerTimeout(uint8_t taskId, uint32_t eventId)
     return timeout;
 }
 
+/*********************************************************************
+ * @fn      OsalPortTimers_getStats
+ *
+ * @brief   Get the timer pool usage counters
+ *
+ * @param   pStats - where to copy the counters
+ *
+ * @return  void
+ */
+void OsalPortTimers_getStats(OsalPortTimers_Stats_t *pStats)
+{
+    uintptr_t key;
+
+    if(pStats != NULL)
+    {
+        key = OsalPort_enterCS();
+        *pStats = timerStats;
+        OsalPort_leaveCS(key);
+    }
+}
+
 /*********************************************************************
  * @fn      OsalPortTimers_cleanUpTimers
  *
  * @brief Clean up inactive Osal Port Timers outside of SWI context
  *
+ *        Expired pool timers return to the pool directly from the timer
+ *        callback, only expired heap timers are left to free here.
  *
  * @return  Timer entry
  */
 void OsalPortTimers_cleanUpTimers(void)
 {
-  if (pDeleteTimerEntries != NULL) {
-    TimerEntry_t *current = pDeleteTimerEntries;
-    TimerEntry_t *next;
+    TimerHeapEntry_t* current;
+    TimerHeapEntry_t* next;
+    uintptr_t key;
+
+    key = OsalPort_enterCS();
+    current = pDeleteTimerEntries;
+    pDeleteTimerEntries = NULL;
+    OsalPort_leaveCS(key);
 
     // free the entire pDeleteTimerEntries list
-    while (current != NULL)
+    while(current != NULL)
     {
         next = current->pNext;
-        Clock_delete(&(current->clockHandle));
-        OsalPort_free(current);
+        freeHeapTimerEntry(&current->entry);
         current = next;
     }
-    pDeleteTimerEntries = NULL;
-  }
 }
 
 /*********************************************************************
@@ -285,49 +324,34 @@ void OsalPortTimers_registerCleanupEvent(uint8_t taskID, uint32_t eventID)
 static void timerCb(xdc_UArg arg)
 {
     TimerEntry_t* pTimerEntry = (TimerEntry_t*) arg;
+    uintptr_t key;
 
     /* Set event */
     OsalPort_setEvent( pTimerEntry->taskId, pTimerEntry->eventId );
 
-    /* if it is not a reload timer then free the entry */
+    /* if it is not a reload timer then return the entry to the pool,
+     * the Clock object is kept constructed for the next user */
     if(!pTimerEntry->reload)
     {
-        Clock_stop(pTimerEntry->clockHandle);
+        key = OsalPort_enterCS();
 
-        // find the element in the timer list and
-        // extract it by updating prev and next ptrs
-        if(pTimerEntry == pTimerEntries)
-        {
-            pTimerEntries = pTimerEntry->pNext;
-        }
-        else
+        Clock_stop(Clock_handle(&pTimerEntry->clockStruct));
+        if(pTimerEntry->active)
         {
-            TimerEntry_t* pPrevTimerEntry = pTimerEntries;
-            while(pPrevTimerEntry->pNext != pTimerEntry)
-            {
-                pPrevTimerEntry = pPrevTimerEntry->pNext;
-            }
-            pPrevTimerEntry->pNext = pTimerEntry->pNext;
-        }
+            releaseTimerEntry(pTimerEntry);
 
-        // add the element in the removal list, to be freed
-        // outside of SWI context
-        TimerEntry_t *pDeleteTimerEntry = pDeleteTimerEntries;
-        pTimerEntry->pNext = NULL; // remove node from linked list above
-        if(pDeleteTimerEntry == NULL)
-        {
-            pDeleteTimerEntries = pTimerEntry;
-        }
-        else
-        {
-            while(pDeleteTimerEntry->pNext != NULL)
+            /* a heap entry cannot be freed from its own Clock callback,
+             * hand it to the cleanup event outside of SWI context */
+            if(pTimerEntry->fromHeap)
             {
-                pDeleteTimerEntry = pDeleteTimerEntry->pNext;
+                ((TimerHeapEntry_t*) pTimerEntry)->pNext = pDeleteTimerEntries;
+                pDeleteTimerEntries = (TimerHeapEntry_t*) pTimerEntry;
+
+                OsalPort_setEvent( stackTaskID, stackEventID );
             }
-            pDeleteTimerEntry->pNext = pTimerEntry;
         }
-        
-        OsalPort_setEvent( stackTaskID, stackEventID );
+
+        OsalPort_leaveCS(key);
     }
 }
 
@@ -348,6 +372,7 @@ static void timerCb(xdc_UArg arg)
 static uint8_t createTimerEntry(uint8_t taskId, uint32_t eventId, uint32_t timeout, bool reload)
 {
     Clock_Params clkParams;
+    Clock_Handle clockHandle;
     TimerEntry_t* pNewTimerEntry;
     uint8_t status = OsalPort_NO_TIMER_AVAIL;
     uint32_t timeoutTicks = (timeout * (1000 / Clock_tickPeriod));
@@ -356,68 +381,60 @@ static uint8_t createTimerEntry(uint8_t taskId, uint32_t eventId, uint32_t timeo
     //Enter Critial Section
     key = OsalPort_enterCS();
 
+    if(!timerPoolInitialized)
+    {
+        initTimerPool();
+    }
+
     //check for existing timer
     pNewTimerEntry = getTimerEntry(taskId, eventId);
     
     if(pNewTimerEntry)
     {
         //reset the time out
-        Clock_stop(pNewTimerEntry->clockHandle);
-        Clock_setTimeout(pNewTimerEntry->clockHandle, timeoutTicks);
-        Clock_start(pNewTimerEntry->clockHandle);
+        clockHandle = Clock_handle(&pNewTimerEntry->clockStruct);
+        Clock_stop(clockHandle);
+        Clock_setTimeout(clockHandle, timeoutTicks);
+        Clock_start(clockHandle);
+
+        status = OsalPort_SUCCESS;
     }
-    else
+    else if((pNewTimerEntry = allocTimerEntry(taskId, eventId)) != NULL)
     {
-        pNewTimerEntry = OsalPort_malloc(sizeof(TimerEntry_t));
-
-        if(pNewTimerEntry != NULL)
+        //construct the Clock object the first time the slot is used,
+        //afterwards it is only reconfigured
+        if(!pNewTimerEntry->constructed)
         {
             Clock_Params_init(&clkParams);
-            if(reload)
-            {
-                clkParams.period = timeoutTicks;
-            }
-            else
-            {
-                clkParams.period = 0;
-            }
-
-            clkParams.startFlag = true;
+            clkParams.period = 0;
+            clkParams.startFlag = false;
             clkParams.arg = (UArg) pNewTimerEntry;
 
-            pNewTimerEntry->clockHandle = Clock_create(timerCb, timeoutTicks, &clkParams, NULL);
+            Clock_construct(&pNewTimerEntry->clockStruct, timerCb, timeoutTicks, &clkParams);
+            pNewTimerEntry->constructed = true;
+        }
 
-            if(pNewTimerEntry->clockHandle != NULL)
-            {
-            	pNewTimerEntry->taskId = taskId;
-	            pNewTimerEntry->eventId = eventId;
-	            pNewTimerEntry->reload = reload;
-	            pNewTimerEntry->pNext = NULL;
-
-	            if(pTimerEntries == NULL)
-	            {
-	                pTimerEntries = pNewTimerEntry;
-	            }
-	            else
-	            {
-	                TimerEntry_t* pLastTimerEntry = pTimerEntries;
-	                while(pLastTimerEntry->pNext != NULL)
-	                {
-	                    pLastTimerEntry = pLastTimerEntry->pNext;
-	                }
-	                pLastTimerEntry->pNext = pNewTimerEntry;
-	            }
-
-	            Clock_setTimeout(pNewTimerEntry->clockHandle, timeoutTicks);
-	            Clock_start(pNewTimerEntry->clockHandle);
-
-	            status = OsalPort_SUCCESS;
-            }
-            else
-            {
-            	OsalPort_free(pNewTimerEntry);				
-            }       		            
+        pNewTimerEntry->taskId = taskId;
+        pNewTimerEntry->eventId = eventId;
+        pNewTimerEntry->reload = reload;
+        pNewTimerEntry->active = true;
+
+        clockHandle = Clock_handle(&pNewTimerEntry->clockStruct);
+        Clock_setPeriod(clockHandle, reload ? timeoutTicks : 0);
+        Clock_setTimeout(clockHandle, timeoutTicks);
+        Clock_start(clockHandle);
+
+        timerStats.activeTimers++;
+        if(timerStats.activeTimers > timerStats.peakActiveTimers)
+        {
+            timerStats.peakActiveTimers = timerStats.activeTimers;
         }
+
+        status = OsalPort_SUCCESS;
+    }
+    else
+    {
+        timerStats.allocFailures++;
     }
 
     //Leave Critical Section
@@ -432,26 +449,238 @@ static uint8_t createTimerEntry(uint8_t taskId, uint32_t eventId, uint32_t timeo
  *
  * @brief
  *
- *    This function is used to create a TIRTOS timer an timer entry.
+ *    This function is used to find the active timer entry of a
+ *    (taskId, eventId) pair. Must be called in a critical section.
  *
  * @param   uint8_t    taskId - task ID to post event to when timer expires
  * @param   uint32_t   eventId - event to post
  *
- * @return  Timer entry
+ * @return  Timer entry, NULL if not found
  */
 static TimerEntry_t* getTimerEntry(uint8_t taskId, uint32_t eventId)
+{
+    uint8_t slot;
+    TimerHeapEntry_t* pHeapEntry;
+
+    if(!timerPoolInitialized)
+    {
+        return NULL;
+    }
+
+    slot = timerHash[timerHashIdx(taskId, eventId)];
+
+    /* iterate through the bucket and find one that matches taskId and eventId */
+    while( (slot != TIMER_INVALID_IDX) &&
+           !((timerPool[slot].taskId == taskId) &&
+             (timerPool[slot].eventId == eventId)) )
+    {
+        slot = timerPool[slot].next;
+    }
+
+    if(slot != TIMER_INVALID_IDX)
+    {
+        return &timerPool[slot];
+    }
+
+    /* then the timers that did not fit in the pool */
+    for(pHeapEntry = pHeapTimerEntries; pHeapEntry != NULL; pHeapEntry = pHeapEntry->pNext)
+    {
+        if((pHeapEntry->entry.taskId == taskId) &&
+           (pHeapEntry->entry.eventId == eventId))
+        {
+            return &pHeapEntry->entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn      allocTimerEntry
+ *
+ * @brief
+ *
+ *    This function takes a free pool slot for a (taskId, eventId) pair
+ *    and links it into the index. When the pool is exhausted the entry
+ *    is allocated from the heap instead. Must be called in a critical
+ *    section.
+ *
+ * @param   uint8_t    taskId - task ID to post event to when timer expires
+ * @param   uint32_t   eventId - event to post
+ *
+ * @return  Timer entry, NULL if the heap is exhausted as well
+ */
+static TimerEntry_t* allocTimerEntry(uint8_t taskId, uint32_t eventId)
 {
     TimerEntry_t* pTimerEntry;
+    TimerHeapEntry_t* pHeapEntry;
+    uint8_t slot;
+    uint8_t bucket;
+
+    if(timerFreeHead != TIMER_INVALID_IDX)
+    {
+        slot = timerFreeHead;
+        pTimerEntry = &timerPool[slot];
+        timerFreeHead = pTimerEntry->next;
+
+        //link into the (taskId, eventId) index
+        bucket = timerHashIdx(taskId, eventId);
+        pTimerEntry->next = timerHash[bucket];
+        timerHash[bucket] = slot;
 
-    pTimerEntry = pTimerEntries;
+        return pTimerEntry;
+    }
+
+    pHeapEntry = OsalPort_malloc(sizeof(TimerHeapEntry_t));
 
-    /* iterate through entries and find one that matches taskId and eventId */
-    while( (pTimerEntry != NULL) &&
-           !((pTimerEntry->taskId == taskId) &&
-             (pTimerEntry->eventId == eventId)) )
+    if(pHeapEntry == NULL)
     {
-        pTimerEntry = pTimerEntry->pNext;
+        return NULL;
     }
 
+    pTimerEntry = &pHeapEntry->entry;
+    pTimerEntry->constructed = false;
+    pTimerEntry->fromHeap = true;
+    pTimerEntry->next = TIMER_INVALID_IDX;
+
+    pHeapEntry->pNext = pHeapTimerEntries;
+    pHeapTimerEntries = pHeapEntry;
+
+    timerStats.heapTimers++;
+
     return pTimerEntry;
 }
+
+/*********************************************************************
+ * @fn      freeHeapTimerEntry
+ *
+ * @brief
+ *
+ *    This function destructs the Clock of a released heap timer entry
+ *    and frees it. Must not be called from the entry's own Clock
+ *    callback.
+ *
+ * @param   TimerEntry_t* pTimerEntry - entry to free
+ *
+ * @return  none
+ */
+static void freeHeapTimerEntry(TimerEntry_t* pTimerEntry)
+{
+    if(pTimerEntry->constructed)
+    {
+        Clock_destruct(&pTimerEntry->clockStruct);
+    }
+
+    OsalPort_free(pTimerEntry);
+}
+
+/*********************************************************************
+ * @fn      initTimerPool
+ *
+ * @brief
+ *
+ *    This function links all pool slots into the free list and empties
+ *    the index. Must be called in a critical section.
+ *
+ * @return  none
+ */
+static void initTimerPool(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < TIMER_HASH_SIZE; i++)
+    {
+        timerHash[i] = TIMER_INVALID_IDX;
+    }
+
+    for(i = 0; i < OsalPortTimers_POOL_SIZE; i++)
+    {
+        timerPool[i].active = false;
+        timerPool[i].constructed = false;
+        timerPool[i].fromHeap = false;
+        timerPool[i].next = (i + 1 < OsalPortTimers_POOL_SIZE) ? (i + 1) : TIMER_INVALID_IDX;
+    }
+
+    timerFreeHead = 0;
+    timerPoolInitialized = true;
+}
+
+/*********************************************************************
+ * @fn      timerHashIdx
+ *
+ * @brief
+ *
+ *    This function maps a (taskId, eventId) pair to an index bucket.
+ *    Event IDs are mostly single bits, so they are mixed with a
+ *    multiplicative hash before being combined with the task ID.
+ *
+ * @param   uint8_t    taskId - task ID
+ * @param   uint32_t   eventId - event ID
+ *
+ * @return  bucket index
+ */
+static uint8_t timerHashIdx(uint8_t taskId, uint32_t eventId)
+{
+    uint32_t h = (eventId * 0x9E3779B1u) >> 24;
+
+    return (uint8_t)((h ^ (taskId * 5)) & TIMER_HASH_MASK);
+}
+
+/*********************************************************************
+ * @fn      releaseTimerEntry
+ *
+ * @brief
+ *
+ *    This function unlinks an active timer entry from the index and
+ *    returns it to the free list. The Clock must already be stopped.
+ *    Must be called in a critical section.
+ *
+ * @param   TimerEntry_t* pTimerEntry - entry to release
+ *
+ * @return  none
+ */
+static void releaseTimerEntry(TimerEntry_t* pTimerEntry)
+{
+    uint8_t slot;
+    uint8_t *pLink;
+    TimerHeapEntry_t** ppHeapLink;
+
+    if(pTimerEntry->fromHeap)
+    {
+        ppHeapLink = &pHeapTimerEntries;
+        while((*ppHeapLink != NULL) && (&(*ppHeapLink)->entry != pTimerEntry))
+        {
+            ppHeapLink = &(*ppHeapLink)->pNext;
+        }
+
+        if(*ppHeapLink != NULL)
+        {
+            *ppHeapLink = (*ppHeapLink)->pNext;
+        }
+
+        pTimerEntry->active = false;
+
+        timerStats.heapTimers--;
+        timerStats.activeTimers--;
+        return;
+    }
+
+    slot = (uint8_t)(pTimerEntry - timerPool);
+    pLink = &timerHash[timerHashIdx(pTimerEntry->taskId, pTimerEntry->eventId)];
+
+    while((*pLink != TIMER_INVALID_IDX) && (*pLink != slot))
+    {
+        pLink = &timerPool[*pLink].next;
+    }
+
+    if(*pLink == slot)
+    {
+        *pLink = pTimerEntry->next;
+    }
+
+    pTimerEntry->active = false;
+    pTimerEntry->next = timerFreeHead;
+    timerFreeHead = slot;
+
+    timerStats.activeTimers--;
+}
@@ -241,7 +241,6 @@ static void setKeyRefreshTimeoutClock(uint32_t timeout);
 
 static void keyRecoverProcess (void);
 static void allDevice_keyRefresh (void);
-static Cllc_associated_devices_t *findDevice(uint16_t shortAddr);
 #endif
 static bool isSupportedAuthType(uint8_t authmethods);
 static bool sendSMMsg(uint8_t *pData, uint16_t len, uint8_t msduHandle);
@@ -1097,7 +1096,7 @@ static void processState(SM_states_t state)
              pSeedKeyEnty = getEntryFromSeedKeyTable(commissionDevInfo.extAddress, commissionDevInfo.shortAddress);
 
              /* Update the info for key refreshment */
-             pExistingDevice = findDevice(commissionDevInfo.shortAddress);
+             pExistingDevice = Cllc_findDevice(commissionDevInfo.shortAddress);
              /* Pass the device key to MAC */
              if(IsKeyNew == SM_Key_New)
              {
@@ -1188,7 +1187,7 @@ static void processState(SM_states_t state)
 #ifdef FEATURE_FULL_FUNCTION_DEVICE
             Cllc_associated_devices_t *pExistingDevice;
             /* Update the info for key refreshment */
-            pExistingDevice = findDevice(commissionDevInfo.shortAddress);
+            pExistingDevice = Cllc_findDevice(commissionDevInfo.shortAddress);
             pExistingDevice->keyRef_statue = SM_KEYRF_FAIL;
 
 #endif
@@ -2650,29 +2649,6 @@ static void allDevice_keyRefresh (void)
     }
 }
 
-/*!
- * @brief      Find the associated device table entry matching an
- *             extended address.
- *
- * @param      shortAddr - device's short address
- *
- * @return     pointer to the associated device table entry,
- *             NULL if not found.
- */
-static Cllc_associated_devices_t *findDevice(uint16_t shortAddr)
-{
-    int x;
-
-    for(x = 0; (x < CONFIG_MAX_DEVICES); x++)
-    {
-        /* Make sure the entry is valid. */
-        if(shortAddr == Cllc_associatedDevList[x].shortAddr)
-        {
-            return (&Cllc_associatedDevList[x]);
-        }
-    }
-    return (NULL);
-}
 #else
 /* Add SeedKey Entry to the SeedKeyTable */
 /* input param:     device ext. Address, localSecDevice
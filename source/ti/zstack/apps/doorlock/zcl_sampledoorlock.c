@@ -90,6 +90,7 @@
 #include "zcl_closures.h"
 
 #include "zcl_sampledoorlock.h"
+#include "zcl_sampledoorlock_cred.h"
 #include "ti_drivers_config.h"
 
 #ifdef USE_ZCL_SAMPLEAPP_UI
@@ -221,6 +222,18 @@ static void zclSampleDoorLock_ProcessCommissioningStatus(bdbCommissioningModeMsg
 // Functions to process ZCL Foundation incoming Command/Response messages
 static ZStatus_t zclSampleDoorLock_DoorLockCB ( zclIncoming_t *pInMsg, zclDoorLock_t *pInCmd );
 static ZStatus_t zclSampleDoorLock_DoorLockActuator ( uint8_t newDoorLockState );
+static ZStatus_t zclSampleDoorLock_SetPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockSetPINCode_t *pCmd );
+static ZStatus_t zclSampleDoorLock_GetPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_ClearPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_ClearAllPINCodesCB( zclIncoming_t *pInMsg );
+static ZStatus_t zclSampleDoorLock_SetUserStatusCB( zclIncoming_t *pInMsg, zclDoorLockSetUserStatus_t *pCmd );
+static ZStatus_t zclSampleDoorLock_GetUserStatusCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_SetUserTypeCB( zclIncoming_t *pInMsg, zclDoorLockSetUserType_t *pCmd );
+static ZStatus_t zclSampleDoorLock_GetUserTypeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_SetRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockSetRFIDCode_t *pCmd );
+static ZStatus_t zclSampleDoorLock_GetRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_ClearRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd );
+static ZStatus_t zclSampleDoorLock_ClearAllRFIDCodesCB( zclIncoming_t *pInMsg );
 
 
 static void zclSampleDoorLock_UpdateLedState(void);
@@ -280,6 +293,12 @@ static zclClosures_DoorLockAppCallbacks_t zclSampleDoorLock_DoorLockCmdCallbacks
   NULL,
   NULL,
   NULL,
+  zclSampleDoorLock_SetPINCodeCB,                         // Set PIN Code command
+  zclSampleDoorLock_GetPINCodeCB,                         // Get PIN Code command
+  zclSampleDoorLock_ClearPINCodeCB,                       // Clear PIN Code command
+  zclSampleDoorLock_ClearAllPINCodesCB,                   // Clear All PIN Codes command
+  zclSampleDoorLock_SetUserStatusCB,                      // Set User Status command
+  zclSampleDoorLock_GetUserStatusCB,                      // Get User Status command
   NULL,
   NULL,
   NULL,
@@ -289,19 +308,12 @@ static zclClosures_DoorLockAppCallbacks_t zclSampleDoorLock_DoorLockCmdCallbacks
   NULL,
   NULL,
   NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
-  NULL,
+  zclSampleDoorLock_SetUserTypeCB,                        // Set User Type command
+  zclSampleDoorLock_GetUserTypeCB,                        // Get User Type command
+  zclSampleDoorLock_SetRFIDCodeCB,                        // Set RFID Code command
+  zclSampleDoorLock_GetRFIDCodeCB,                        // Get RFID Code command
+  zclSampleDoorLock_ClearRFIDCodeCB,                      // Clear RFID Code command
+  zclSampleDoorLock_ClearAllRFIDCodesCB,                  // Clear All RFID Codes command
   NULL,
   NULL,
   NULL,
@@ -483,6 +495,9 @@ static void zclSampleDoorLock_Init( void )
       }
   }
 
+  // Load the user PIN/RFID codes
+  zclSampleDoorLockCred_Init(pfnZdlNV);
+
 
 #ifdef BDB_REPORTING
   //Adds the default configuration values for the doorlock attribute of the ZCL_CLUSTER_ID_CLOSURES_DOOR_LOCK cluster, for endpoint SAMPLEDOORLOCK_ENDPOINT
@@ -601,6 +616,7 @@ static void zclSampleDoorLock_RemoveAppNvmData(void)
           pfnZdlNV->deleteItem(nvId);
       }
 
+      zclSampleDoorLockCred_RemoveNvmData();
 }
 #endif
 
@@ -1282,7 +1298,10 @@ static ZStatus_t zclSampleDoorLock_DoorLockCB ( zclIncoming_t *pInMsg, zclDoorLo
   ZStatus_t rc = ZInvalidParameter;
   uint8_t newDoorLockState;
 
-  if ( memcmp( aiDoorLockMasterPINCode, pInCmd->pPinRfidCode, 5 ) == SUCCESS )
+  // The code may be the master PIN or the PIN or RFID code of an enabled user
+  if ( zclSampleDoorLockCred_CodeMatch( (uint8_t *)aiDoorLockMasterPINCode, pInCmd->pPinRfidCode, DLSAPP_MAX_PIN_SIZE ) ||
+       ( zclSampleDoorLockCred_Verify( DLSAPP_CRED_PIN, pInCmd->pPinRfidCode ) != DLSAPP_CRED_INVALID_USER ) ||
+       ( zclSampleDoorLockCred_Verify( DLSAPP_CRED_RFID, pInCmd->pPinRfidCode ) != DLSAPP_CRED_INVALID_USER ) )
   {
     // Lock the door
     if ( pInMsg->hdr.commandID == COMMAND_CLOSURES_LOCK_DOOR )
@@ -1336,6 +1355,320 @@ static ZStatus_t zclSampleDoorLock_DoorLockCB ( zclIncoming_t *pInMsg, zclDoorLo
 }
 
 
+/*********************************************************************
+ * @fn      zclSampleDoorLock_SetPINCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Set PIN Code command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID, status, type and PIN
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_SetPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockSetPINCode_t *pCmd )
+{
+  uint8_t status;
+
+  status = zclSampleDoorLockCred_SetCode( DLSAPP_CRED_PIN, pCmd->userID, pCmd->userStatus,
+                                          pCmd->userType, pCmd->pPIN );
+
+  zclClosures_SendDoorLockSetPINCodeRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                         status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_GetPINCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Get PIN Code command for this application.
+ *          The code is only sent when SendPINOverTheAir is TRUE.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_GetPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  const zclSampleDoorLockCred_User_t *pUser = zclSampleDoorLockCred_GetUser( pCmd->userID );
+  zclDoorLockGetPINCodeRsp_t rsp;
+  uint8_t noCode = 0;
+
+  if ( pUser == NULL )
+  {
+    return ( ZCL_STATUS_INVALID_FIELD );
+  }
+
+  rsp.userID = pCmd->userID;
+  rsp.userStatus = pUser->userStatus;
+  rsp.userType = pUser->userType;
+  rsp.pCode = zclSampleDoorLock_SendPINOverTheAir ? (uint8_t *)pUser->pin : &noCode;
+
+  zclClosures_SendDoorLockGetPINCodeResponse( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                              &rsp, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_ClearPINCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Clear PIN Code command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_ClearPINCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  uint8_t status = ZCL_STATUS_SUCCESS;
+
+  if ( zclSampleDoorLockCred_ClearCode( DLSAPP_CRED_PIN, pCmd->userID ) != ZSuccess )
+  {
+    status = ZCL_STATUS_FAILURE;
+  }
+
+  zclClosures_SendDoorLockClearPINCodeRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                           status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_ClearAllPINCodesCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Clear All PIN Codes command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_ClearAllPINCodesCB( zclIncoming_t *pInMsg )
+{
+  zclSampleDoorLockCred_ClearAllCodes( DLSAPP_CRED_PIN );
+
+  zclClosures_SendDoorLockClearAllPINCodesRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                               ZCL_STATUS_SUCCESS, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_SetUserStatusCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Set User Status command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID and status
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_SetUserStatusCB( zclIncoming_t *pInMsg, zclDoorLockSetUserStatus_t *pCmd )
+{
+  uint8_t status = ZCL_STATUS_SUCCESS;
+
+  if ( zclSampleDoorLockCred_SetUserStatus( pCmd->userID, pCmd->userStatus ) != ZSuccess )
+  {
+    status = ZCL_STATUS_FAILURE;
+  }
+
+  zclClosures_SendDoorLockSetUserStatusRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                            status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_GetUserStatusCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Get User Status command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_GetUserStatusCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  const zclSampleDoorLockCred_User_t *pUser = zclSampleDoorLockCred_GetUser( pCmd->userID );
+
+  if ( pUser == NULL )
+  {
+    return ( ZCL_STATUS_INVALID_FIELD );
+  }
+
+  zclClosures_SendDoorLockGetUserStatusResponse( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                                 pCmd->userID, pUser->userStatus,
+                                                 TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_SetUserTypeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Set User Type command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID and type
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_SetUserTypeCB( zclIncoming_t *pInMsg, zclDoorLockSetUserType_t *pCmd )
+{
+  uint8_t status = ZCL_STATUS_SUCCESS;
+
+  if ( zclSampleDoorLockCred_SetUserType( pCmd->userID, pCmd->userType ) != ZSuccess )
+  {
+    status = ZCL_STATUS_FAILURE;
+  }
+
+  zclClosures_SendDoorLockSetUserTypeRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                          status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_GetUserTypeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Get User Type command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_GetUserTypeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  const zclSampleDoorLockCred_User_t *pUser = zclSampleDoorLockCred_GetUser( pCmd->userID );
+
+  if ( pUser == NULL )
+  {
+    return ( ZCL_STATUS_INVALID_FIELD );
+  }
+
+  zclClosures_SendDoorLockGetUserTypeResponse( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                               pCmd->userID, pUser->userType,
+                                               TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_SetRFIDCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Set RFID Code command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID, status, type and RFID code
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_SetRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockSetRFIDCode_t *pCmd )
+{
+  uint8_t status;
+
+  status = zclSampleDoorLockCred_SetCode( DLSAPP_CRED_RFID, pCmd->userID, pCmd->userStatus,
+                                          pCmd->userType, pCmd->pRfidCode );
+
+  zclClosures_SendDoorLockSetRFIDCodeRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                          status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_GetRFIDCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Get RFID Code command for this application.
+ *          The code is only sent when SendPINOverTheAir is TRUE.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_GetRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  const zclSampleDoorLockCred_User_t *pUser = zclSampleDoorLockCred_GetUser( pCmd->userID );
+  zclDoorLockGetRFIDCodeRsp_t rsp;
+  uint8_t noCode = 0;
+
+  if ( pUser == NULL )
+  {
+    return ( ZCL_STATUS_INVALID_FIELD );
+  }
+
+  rsp.userID = pCmd->userID;
+  rsp.userStatus = pUser->userStatus;
+  rsp.userType = pUser->userType;
+  rsp.pRfidCode = zclSampleDoorLock_SendPINOverTheAir ? (uint8_t *)pUser->rfid : &noCode;
+
+  zclClosures_SendDoorLockGetRFIDCodeResponse( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                               &rsp, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_ClearRFIDCodeCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Clear RFID Code command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ * @param   pCmd - user ID
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_ClearRFIDCodeCB( zclIncoming_t *pInMsg, zclDoorLockUserID_t *pCmd )
+{
+  uint8_t status = ZCL_STATUS_SUCCESS;
+
+  if ( zclSampleDoorLockCred_ClearCode( DLSAPP_CRED_RFID, pCmd->userID ) != ZSuccess )
+  {
+    status = ZCL_STATUS_FAILURE;
+  }
+
+  zclClosures_SendDoorLockClearRFIDCodeRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                            status, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLock_ClearAllRFIDCodesCB
+ *
+ * @brief   Callback from the ZCL Closures Cluster Library when it
+ *          received a Clear All RFID Codes command for this application.
+ *
+ * @param   pInMsg - process incoming message
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclSampleDoorLock_ClearAllRFIDCodesCB( zclIncoming_t *pInMsg )
+{
+  zclSampleDoorLockCred_ClearAllCodes( DLSAPP_CRED_RFID );
+
+  zclClosures_SendDoorLockClearAllRFIDCodesRsp( pInMsg->msg->endPoint, &pInMsg->msg->srcAddr,
+                                                ZCL_STATUS_SUCCESS, TRUE, pInMsg->hdr.transSeqNum );
+
+  return ( ZCL_STATUS_CMD_HAS_RSP );
+}
+
 static ZStatus_t zclSampleDoorLock_DoorLockActuator ( uint8_t newDoorLockState )
 {
   if ( newDoorLockState == zclSampleDoorLock_getLockStateAttribute() )
@@ -104,6 +104,7 @@ extern uint16_t zclSampleDoorLock_IdentifyTime;
 //Door Lock Cluster Attributes
 extern uint8_t zclSampleDoorLock_LockType;
 extern bool zclSampleDoorLock_ActuatorEnabled;
+extern bool zclSampleDoorLock_SendPINOverTheAir;
 
 // Scenes attributes
 extern uint8_t zclSampleDoorLock_ScenesCurrentScene;
@@ -0,0 +1,632 @@
+/**************************************************************************************************
+  Filename:       zcl_sampledoorlock_cred.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    PIN/RFID credential store of the Door Lock sample application.
+
+
+  Copyright 2013-2020 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+  This module keeps the PIN and RFID codes of the door lock users. Every
+  code is linked into a hash index on its value, so verifying a code only
+  compares it against the users sharing its bucket instead of against the
+  whole user table. Candidates are compared with
+  zclSampleDoorLockCred_CodeMatch(), which takes the same time whether the
+  codes differ in the first or the last digit.
+
+  Each user slot is kept in its own NV item, so a change to one user only
+  rewrites that user's slot.
+ *********************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "zcomdef.h"
+#include "zcl.h"
+#include "zcl_closures.h"
+
+#include "zcl_sampledoorlock_cred.h"
+
+/*********************************************************************
+ * MACROS
+ */
+#define credCode( pUser, credType ) \
+  ( ( (credType) == DLSAPP_CRED_PIN ) ? (pUser)->pin : (pUser)->rfid )
+
+#define credMaxLen( credType ) \
+  ( ( (credType) == DLSAPP_CRED_PIN ) ? DLSAPP_CRED_MAX_PIN_LEN : DLSAPP_CRED_MAX_RFID_LEN )
+
+/*********************************************************************
+ * CONSTANTS
+ */
+#if ( DLSAPP_CRED_MAX_USERS >= DLSAPP_CRED_INVALID_USER )
+#error "DLSAPP_CRED_MAX_USERS is too large"
+#endif
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+// Passed in function pointers to the NV driver
+static NVINTF_nvFuncts_t *pfnCredNV = NULL;
+
+// User slots, indexed by user ID
+static zclSampleDoorLockCred_User_t credUsers[DLSAPP_CRED_MAX_USERS];
+
+// Code index: first user in each bucket, and the next user in the same bucket
+static uint16_t credBucket[DLSAPP_CRED_NUM_TYPES][DLSAPP_CRED_HASH_SIZE];
+static uint16_t credNext[DLSAPP_CRED_NUM_TYPES][DLSAPP_CRED_MAX_USERS];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint8_t credHash( uint8_t *pCode, uint8_t maxLen );
+static void credIndexAdd( uint8_t credType, uint16_t userID );
+static void credIndexRemove( uint8_t credType, uint16_t userID );
+static uint16_t credFind( uint8_t credType, uint8_t *pCode );
+static void credResetUser( uint16_t userID );
+static void credSaveUser( uint16_t userID );
+
+/*********************************************************************
+ * @fn      credHash
+ *
+ * @brief   Hash bucket of a code (FNV-1a over the length and digits)
+ *
+ * @param   pCode - ZCL octet string
+ * @param   maxLen - longest code of this credential type
+ *
+ * @return  bucket index
+ */
+static uint8_t credHash( uint8_t *pCode, uint8_t maxLen )
+{
+  uint32_t hash = 2166136261UL;
+  uint8_t len = pCode[0];
+  uint8_t i;
+
+  if ( len > maxLen )
+  {
+    len = maxLen;
+  }
+
+  for ( i = 0; i <= len; i++ )
+  {
+    hash = ( hash ^ pCode[i] ) * 16777619UL;
+  }
+
+  return ( (uint8_t)( hash ^ ( hash >> 16 ) ) & ( DLSAPP_CRED_HASH_SIZE - 1 ) );
+}
+
+/*********************************************************************
+ * @fn      credIndexAdd
+ *
+ * @brief   Link the code of a user into the index
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   userID -
+ *
+ * @return  none
+ */
+static void credIndexAdd( uint8_t credType, uint16_t userID )
+{
+  uint8_t bucket = credHash( credCode( &credUsers[userID], credType ), credMaxLen( credType ) );
+
+  credNext[credType][userID] = credBucket[credType][bucket];
+  credBucket[credType][bucket] = userID;
+}
+
+/*********************************************************************
+ * @fn      credIndexRemove
+ *
+ * @brief   Unlink the code of a user from the index
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   userID -
+ *
+ * @return  none
+ */
+static void credIndexRemove( uint8_t credType, uint16_t userID )
+{
+  uint8_t bucket = credHash( credCode( &credUsers[userID], credType ), credMaxLen( credType ) );
+  uint16_t *pLink = &credBucket[credType][bucket];
+
+  while ( *pLink != DLSAPP_CRED_INVALID_USER )
+  {
+    if ( *pLink == userID )
+    {
+      *pLink = credNext[credType][userID];
+      break;
+    }
+    pLink = &credNext[credType][*pLink];
+  }
+
+  credNext[credType][userID] = DLSAPP_CRED_INVALID_USER;
+}
+
+/*********************************************************************
+ * @fn      credFind
+ *
+ * @brief   Find the user owning a code. Every user in the bucket is
+ *          compared so the time taken does not depend on which one
+ *          matched.
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   pCode - ZCL octet string
+ *
+ * @return  user ID, DLSAPP_CRED_INVALID_USER if not found
+ */
+static uint16_t credFind( uint8_t credType, uint8_t *pCode )
+{
+  uint8_t maxLen = credMaxLen( credType );
+  uint16_t found = DLSAPP_CRED_INVALID_USER;
+  uint16_t userID;
+
+  if ( pCode[0] == 0 || pCode[0] > maxLen )
+  {
+    return ( DLSAPP_CRED_INVALID_USER );
+  }
+
+  userID = credBucket[credType][credHash( pCode, maxLen )];
+  while ( userID != DLSAPP_CRED_INVALID_USER )
+  {
+    if ( zclSampleDoorLockCred_CodeMatch( credCode( &credUsers[userID], credType ), pCode, maxLen ) )
+    {
+      found = userID;
+    }
+    userID = credNext[credType][userID];
+  }
+
+  return ( found );
+}
+
+/*********************************************************************
+ * @fn      credResetUser
+ *
+ * @brief   Return a user slot to the available state
+ *
+ * @param   userID -
+ *
+ * @return  none
+ */
+static void credResetUser( uint16_t userID )
+{
+  zcl_memset( &credUsers[userID], 0, sizeof( zclSampleDoorLockCred_User_t ) );
+  credUsers[userID].userStatus = USER_STATUS_AVAILABLE;
+  credUsers[userID].userType = USER_TYPE_UNRESTRICTED_USER;
+}
+
+/*********************************************************************
+ * @fn      credSaveUser
+ *
+ * @brief   Write one user slot to NV. The NV item of a user left without
+ *          codes is deleted.
+ *
+ * @param   userID -
+ *
+ * @return  none
+ */
+static void credSaveUser( uint16_t userID )
+{
+  zclSampleDoorLockCred_User_t *pUser = &credUsers[userID];
+  NVINTF_itemID_t nvId;
+  uint32_t nvLen = 0;
+
+  if ( pfnCredNV == NULL )
+  {
+    return;
+  }
+
+  nvId.systemID = NVINTF_SYSID_APP;
+  nvId.itemID = (uint16_t)DLSAPP_NV_DOORLOCK_USER;
+  nvId.subID = userID;
+
+  if ( pfnCredNV->getItemLen )
+  {
+    nvLen = pfnCredNV->getItemLen( nvId );
+  }
+
+  if ( pUser->pin[0] == 0 && pUser->rfid[0] == 0 &&
+       pUser->userStatus == USER_STATUS_AVAILABLE )
+  {
+    if ( nvLen && pfnCredNV->deleteItem )
+    {
+      pfnCredNV->deleteItem( nvId );
+    }
+  }
+  else if ( nvLen )
+  {
+    if ( pfnCredNV->writeItem )
+    {
+      pfnCredNV->writeItem( nvId, sizeof( zclSampleDoorLockCred_User_t ), pUser );
+    }
+  }
+  else if ( pfnCredNV->createItem )
+  {
+    pfnCredNV->createItem( nvId, sizeof( zclSampleDoorLockCred_User_t ), pUser );
+  }
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_Init
+ *
+ * @brief   Load the user slots from NV and build the code index
+ *
+ * @param   pfnNV - pointer to the NV functions
+ *
+ * @return  none
+ */
+void zclSampleDoorLockCred_Init( NVINTF_nvFuncts_t *pfnNV )
+{
+  NVINTF_itemID_t nvId;
+  uint16_t userID;
+  uint8_t credType;
+
+  pfnCredNV = pfnNV;
+
+  zcl_memset( credBucket, 0xFF, sizeof( credBucket ) );
+  zcl_memset( credNext, 0xFF, sizeof( credNext ) );
+
+  nvId.systemID = NVINTF_SYSID_APP;
+  nvId.itemID = (uint16_t)DLSAPP_NV_DOORLOCK_USER;
+
+  for ( userID = 0; userID < DLSAPP_CRED_MAX_USERS; userID++ )
+  {
+    credResetUser( userID );
+
+    if ( pfnCredNV && pfnCredNV->readItem )
+    {
+      nvId.subID = userID;
+      if ( pfnCredNV->readItem( nvId, 0, sizeof( zclSampleDoorLockCred_User_t ),
+                                &credUsers[userID] ) != NVINTF_SUCCESS )
+      {
+        credResetUser( userID );
+      }
+    }
+
+    for ( credType = 0; credType < DLSAPP_CRED_NUM_TYPES; credType++ )
+    {
+      uint8_t *pCode = credCode( &credUsers[userID], credType );
+
+      if ( pCode[0] > credMaxLen( credType ) )
+      {
+        // Not a slot this build can hold, drop the code
+        zcl_memset( pCode, 0, 1 + credMaxLen( credType ) );
+      }
+      else if ( pCode[0] )
+      {
+        credIndexAdd( credType, userID );
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_SetCode
+ *
+ * @brief   Set the PIN or RFID code of a user and save the user slot
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   userID -
+ * @param   userStatus - USER_STATUS_OCCUPIED_ENABLED or USER_STATUS_OCCUPIED_DISABLED
+ * @param   userType - e.g. USER_TYPE_UNRESTRICTED_USER
+ * @param   pCode - ZCL octet string
+ *
+ * @return  DLSAPP_CRED_STATUS_SUCCESS, DLSAPP_CRED_STATUS_FAILURE,
+ *          DLSAPP_CRED_STATUS_MEMORY_FULL or DLSAPP_CRED_STATUS_DUPLICATE
+ */
+uint8_t zclSampleDoorLockCred_SetCode( uint8_t credType, uint16_t userID, uint8_t userStatus,
+                                       uint8_t userType, uint8_t *pCode )
+{
+  zclSampleDoorLockCred_User_t *pUser;
+  uint8_t *pStored;
+  uint16_t owner;
+
+  if ( userID >= DLSAPP_CRED_MAX_USERS )
+  {
+    return ( DLSAPP_CRED_STATUS_MEMORY_FULL );
+  }
+
+  if ( credType >= DLSAPP_CRED_NUM_TYPES ||
+       pCode[0] == 0 || pCode[0] > credMaxLen( credType ) ||
+       ( userStatus != USER_STATUS_OCCUPIED_ENABLED &&
+         userStatus != USER_STATUS_OCCUPIED_DISABLED ) )
+  {
+    return ( DLSAPP_CRED_STATUS_FAILURE );
+  }
+
+  owner = credFind( credType, pCode );
+  if ( owner != DLSAPP_CRED_INVALID_USER && owner != userID )
+  {
+    return ( DLSAPP_CRED_STATUS_DUPLICATE );
+  }
+
+  pUser = &credUsers[userID];
+  pStored = credCode( pUser, credType );
+
+  if ( pStored[0] )
+  {
+    credIndexRemove( credType, userID );
+  }
+
+  zcl_memset( pStored, 0, 1 + credMaxLen( credType ) );
+  zcl_memcpy( pStored, pCode, 1 + pCode[0] );
+  pUser->userStatus = userStatus;
+  pUser->userType = userType;
+
+  credIndexAdd( credType, userID );
+  credSaveUser( userID );
+
+  return ( DLSAPP_CRED_STATUS_SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_ClearCode
+ *
+ * @brief   Clear the PIN or RFID code of a user. A user left without
+ *          codes becomes available.
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   userID -
+ *
+ * @return  ZSuccess, ZInvalidParameter if the user ID is out of range
+ */
+ZStatus_t zclSampleDoorLockCred_ClearCode( uint8_t credType, uint16_t userID )
+{
+  zclSampleDoorLockCred_User_t *pUser;
+  uint8_t *pStored;
+
+  if ( userID >= DLSAPP_CRED_MAX_USERS || credType >= DLSAPP_CRED_NUM_TYPES )
+  {
+    return ( ZInvalidParameter );
+  }
+
+  pUser = &credUsers[userID];
+  pStored = credCode( pUser, credType );
+
+  if ( pStored[0] )
+  {
+    credIndexRemove( credType, userID );
+    zcl_memset( pStored, 0, 1 + credMaxLen( credType ) );
+
+    if ( pUser->pin[0] == 0 && pUser->rfid[0] == 0 )
+    {
+      credResetUser( userID );
+    }
+
+    credSaveUser( userID );
+  }
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_ClearAllCodes
+ *
+ * @brief   Clear the PIN or RFID codes of all users
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ *
+ * @return  none
+ */
+void zclSampleDoorLockCred_ClearAllCodes( uint8_t credType )
+{
+  uint16_t userID;
+
+  for ( userID = 0; userID < DLSAPP_CRED_MAX_USERS; userID++ )
+  {
+    zclSampleDoorLockCred_ClearCode( credType, userID );
+  }
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_SetUserStatus
+ *
+ * @brief   Set the user status of a user. Making a user available clears
+ *          the user's codes.
+ *
+ * @param   userID -
+ * @param   userStatus - e.g. USER_STATUS_OCCUPIED_DISABLED
+ *
+ * @return  ZSuccess, ZInvalidParameter if the user ID or status is invalid
+ */
+ZStatus_t zclSampleDoorLockCred_SetUserStatus( uint16_t userID, uint8_t userStatus )
+{
+  uint8_t credType;
+
+  if ( userID >= DLSAPP_CRED_MAX_USERS ||
+       ( userStatus != USER_STATUS_AVAILABLE &&
+         userStatus != USER_STATUS_OCCUPIED_ENABLED &&
+         userStatus != USER_STATUS_OCCUPIED_DISABLED ) )
+  {
+    return ( ZInvalidParameter );
+  }
+
+  if ( userStatus == USER_STATUS_AVAILABLE )
+  {
+    for ( credType = 0; credType < DLSAPP_CRED_NUM_TYPES; credType++ )
+    {
+      if ( credCode( &credUsers[userID], credType )[0] )
+      {
+        credIndexRemove( credType, userID );
+      }
+    }
+    credResetUser( userID );
+  }
+  else
+  {
+    credUsers[userID].userStatus = userStatus;
+  }
+
+  credSaveUser( userID );
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_SetUserType
+ *
+ * @brief   Set the user type of a user. An available user has nothing
+ *          stored to hold the type, so it must be occupied first.
+ *
+ * @param   userID -
+ * @param   userType - e.g. USER_TYPE_UNRESTRICTED_USER
+ *
+ * @return  ZSuccess, ZInvalidParameter if the user ID is out of range,
+ *          ZFailure if the user is available
+ */
+ZStatus_t zclSampleDoorLockCred_SetUserType( uint16_t userID, uint8_t userType )
+{
+  if ( userID >= DLSAPP_CRED_MAX_USERS )
+  {
+    return ( ZInvalidParameter );
+  }
+
+  if ( credUsers[userID].userStatus == USER_STATUS_AVAILABLE )
+  {
+    return ( ZFailure );
+  }
+
+  credUsers[userID].userType = userType;
+  credSaveUser( userID );
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_GetUser
+ *
+ * @brief   Get a user slot
+ *
+ * @param   userID -
+ *
+ * @return  pointer to the user slot, NULL if the user ID is out of range
+ */
+const zclSampleDoorLockCred_User_t *zclSampleDoorLockCred_GetUser( uint16_t userID )
+{
+  if ( userID >= DLSAPP_CRED_MAX_USERS )
+  {
+    return ( NULL );
+  }
+
+  return ( &credUsers[userID] );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_Verify
+ *
+ * @brief   Find the enabled user owning a PIN or RFID code
+ *
+ * @param   credType - DLSAPP_CRED_PIN or DLSAPP_CRED_RFID
+ * @param   pCode - ZCL octet string received in a lock command
+ *
+ * @return  user ID, DLSAPP_CRED_INVALID_USER if no enabled user owns the code
+ */
+uint16_t zclSampleDoorLockCred_Verify( uint8_t credType, uint8_t *pCode )
+{
+  uint16_t userID;
+
+  if ( credType >= DLSAPP_CRED_NUM_TYPES )
+  {
+    return ( DLSAPP_CRED_INVALID_USER );
+  }
+
+  userID = credFind( credType, pCode );
+  if ( userID != DLSAPP_CRED_INVALID_USER &&
+       credUsers[userID].userStatus != USER_STATUS_OCCUPIED_ENABLED )
+  {
+    userID = DLSAPP_CRED_INVALID_USER;
+  }
+
+  return ( userID );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_CodeMatch
+ *
+ * @brief   Compare two codes. All maxLen digits are always compared so
+ *          the time taken does not tell how many leading digits matched.
+ *
+ * @param   pStored - stored ZCL octet string
+ * @param   pCode - received ZCL octet string
+ * @param   maxLen - longest code of this credential type
+ *
+ * @return  TRUE if the codes are equal
+ */
+uint8_t zclSampleDoorLockCred_CodeMatch( const uint8_t *pStored, const uint8_t *pCode, uint8_t maxLen )
+{
+  uint8_t diff;
+  uint8_t a;
+  uint8_t b;
+  uint8_t i;
+
+  if ( pStored[0] > maxLen || pCode[0] > maxLen )
+  {
+    return ( FALSE );
+  }
+
+  diff = pStored[0] ^ pCode[0];
+
+  for ( i = 1; i <= maxLen; i++ )
+  {
+    a = ( i <= pStored[0] ) ? pStored[i] : 0;
+    b = ( i <= pCode[0] ) ? pCode[i] : 0;
+    diff |= a ^ b;
+  }
+
+  return ( diff == 0 );
+}
+
+/*********************************************************************
+ * @fn      zclSampleDoorLockCred_RemoveNvmData
+ *
+ * @brief   Clear all users and delete their NV items
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void zclSampleDoorLockCred_RemoveNvmData( void )
+{
+  uint16_t userID;
+
+  for ( userID = 0; userID < DLSAPP_CRED_MAX_USERS; userID++ )
+  {
+    credResetUser( userID );
+    credSaveUser( userID );
+  }
+
+  zcl_memset( credBucket, 0xFF, sizeof( credBucket ) );
+  zcl_memset( credNext, 0xFF, sizeof( credNext ) );
+}
+
+/*********************************************************************
+*********************************************************************/
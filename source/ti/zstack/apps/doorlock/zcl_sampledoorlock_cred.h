@@ -0,0 +1,163 @@
+/**************************************************************************************************
+  Filename:       zcl_sampledoorlock_cred.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    PIN/RFID credential store of the Door Lock sample application.
+
+
+  Copyright 2013-2020 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef ZCL_SAMPLEDOORLOCK_CRED_H
+#define ZCL_SAMPLEDOORLOCK_CRED_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "zcl.h"
+#include "zcl_closures.h"
+#include "nvintf.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+// Number of user slots (user IDs 0 .. DLSAPP_CRED_MAX_USERS-1)
+#if !defined ( DLSAPP_CRED_MAX_USERS )
+#define DLSAPP_CRED_MAX_USERS             30
+#endif
+
+// Number of hash buckets per credential type, must be a power of 2
+#if !defined ( DLSAPP_CRED_HASH_SIZE )
+#define DLSAPP_CRED_HASH_SIZE             32
+#endif
+
+// Longest PIN and RFID codes stored, not including the length octet
+#define DLSAPP_CRED_MAX_PIN_LEN           ATTR_DEFAULT_DOORLOCK_MAX_PIN_LENGTH
+#define DLSAPP_CRED_MAX_RFID_LEN          ATTR_DEFAULT_DOORLOCK_MAX_RFID_LENGTH
+
+// Credential types
+#define DLSAPP_CRED_PIN                   0
+#define DLSAPP_CRED_RFID                  1
+#define DLSAPP_CRED_NUM_TYPES             2
+
+// Returned when no user matches
+#define DLSAPP_CRED_INVALID_USER          0xFFFF
+
+// Status values of the Set PIN Code and Set RFID Code responses
+#define DLSAPP_CRED_STATUS_SUCCESS        0x00
+#define DLSAPP_CRED_STATUS_FAILURE        0x01
+#define DLSAPP_CRED_STATUS_MEMORY_FULL    0x02
+#define DLSAPP_CRED_STATUS_DUPLICATE      0x03
+
+// NV item of a user slot, the user ID is used as the sub ID
+#define DLSAPP_NV_DOORLOCK_USER           0x0011
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+// A user slot, as stored in NV. Codes are ZCL octet strings padded with zeros.
+typedef struct
+{
+  uint8_t userStatus;                               // e.g. USER_STATUS_OCCUPIED_ENABLED
+  uint8_t userType;                                 // e.g. USER_TYPE_UNRESTRICTED_USER
+  uint8_t pin[1 + DLSAPP_CRED_MAX_PIN_LEN];
+  uint8_t rfid[1 + DLSAPP_CRED_MAX_RFID_LEN];
+} zclSampleDoorLockCred_User_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ *  Load the user slots from NV and build the code index.
+ */
+extern void zclSampleDoorLockCred_Init( NVINTF_nvFuncts_t *pfnNV );
+
+/*
+ *  Set the PIN or RFID code of a user and save the user slot to NV.
+ */
+extern uint8_t zclSampleDoorLockCred_SetCode( uint8_t credType, uint16_t userID, uint8_t userStatus,
+                                              uint8_t userType, uint8_t *pCode );
+
+/*
+ *  Clear the PIN or RFID code of a user.
+ */
+extern ZStatus_t zclSampleDoorLockCred_ClearCode( uint8_t credType, uint16_t userID );
+
+/*
+ *  Clear the PIN or RFID codes of all users.
+ */
+extern void zclSampleDoorLockCred_ClearAllCodes( uint8_t credType );
+
+/*
+ *  Set the user status of a user.
+ */
+extern ZStatus_t zclSampleDoorLockCred_SetUserStatus( uint16_t userID, uint8_t userStatus );
+
+/*
+ *  Set the user type of a user.
+ */
+extern ZStatus_t zclSampleDoorLockCred_SetUserType( uint16_t userID, uint8_t userType );
+
+/*
+ *  Get a user slot, NULL if the user ID is out of range.
+ */
+extern const zclSampleDoorLockCred_User_t *zclSampleDoorLockCred_GetUser( uint16_t userID );
+
+/*
+ *  Find the enabled user owning a PIN or RFID code.
+ */
+extern uint16_t zclSampleDoorLockCred_Verify( uint8_t credType, uint8_t *pCode );
+
+/*
+ *  Compare two codes in a time that does not depend on their contents.
+ */
+extern uint8_t zclSampleDoorLockCred_CodeMatch( const uint8_t *pStored, const uint8_t *pCode, uint8_t maxLen );
+
+/*
+ *  Clear all users and delete their NV items.
+ */
+extern void zclSampleDoorLockCred_RemoveNvmData( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZCL_SAMPLEDOORLOCK_CRED_H */
@@ -96,6 +96,7 @@ uint16_t zclSampleDoorLock_IdentifyTime;
 static uint8_t zclSampleDoorLock_LockState = CLOSURES_LOCK_STATE_LOCKED;
 uint8_t zclSampleDoorLock_LockType = CLOSURES_LOCK_TYPE_DEADBOLT;
 bool zclSampleDoorLock_ActuatorEnabled = TRUE;
+bool zclSampleDoorLock_SendPINOverTheAir = ATTR_DEFAULT_DOORLOCK_SEND_PIN_OTA;
 uint8_t zclSampleDoorLock_GroupsNameSupport = 0;
 
 // Scenes attributes
@@ -273,6 +274,15 @@ CONST zclAttrRec_t zclSampleDoorLock_Attrs[] =
       (void *)&zclSampleDoorLock_ActuatorEnabled
     }
   },
+  {
+    ZCL_CLUSTER_ID_CLOSURES_DOOR_LOCK,
+    { // Attribute record
+      ATTRID_DOORLOCK_SEND_PIN_OTA,
+      ZCL_DATATYPE_BOOLEAN,
+      (ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE),
+      (void *)&zclSampleDoorLock_SendPINOverTheAir
+    }
+  },
   {
     ZCL_CLUSTER_ID_CLOSURES_DOOR_LOCK,
     {  // Attribute record
@@ -365,6 +375,8 @@ void zclSampleDoorLock_ResetAttributesToDefaultValues(void)
   zclSampleDoorLock_IdentifyTime = 0;
 #endif
 
+  zclSampleDoorLock_SendPINOverTheAir = ATTR_DEFAULT_DOORLOCK_SEND_PIN_OTA;
+
   zclSampleDoorLock_updateLockStateAttribute(CLOSURES_LOCK_STATE_LOCKED);
 }
 
@@ -102,6 +102,18 @@ extern "C"
 #define NPI_TL_BUF_SIZE         270
 #endif
 
+// Default ASYNC TX batching: at most NPI_TX_BATCH_MAX_FRAMES frames (1 turns
+// batching off) are packed into one transport write, and a partial batch is
+// held for up to NPI_TX_BATCH_DELAY ms waiting for more frames. Both can be
+// changed at runtime with NPITask_setTxBatchParams().
+#ifndef NPI_TX_BATCH_MAX_FRAMES
+#define NPI_TX_BATCH_MAX_FRAMES 1
+#endif
+
+#ifndef NPI_TX_BATCH_DELAY
+#define NPI_TX_BATCH_DELAY      2
+#endif
+
 #define NPI_SPI_PAYLOAD_SIZE    255
 #define NPI_SPI_HDR_LEN         4
 
@@ -61,11 +61,8 @@
 //! \name State values for MT protocol
 //@{
 #define NPIFRAMEMT_SOP_STATE 0x00
-#define NPIFRAMEMT_CMD_STATE1 0x01
-#define NPIFRAMEMT_CMD_STATE2 0x02
 #define NPIFRAMEMT_LEN_STATE 0x03
 #define NPIFRAMEMT_DATA_STATE 0x04
-#define NPIFRAMEMT_FCS_STATE 0x05
 //@}
 
 //! \brief Start-of-frame delimiter for UART transport
@@ -85,8 +82,7 @@ static npiIncomingFrameCBack_t incomingFrameCBFunc = NULL;
 static uint8_t state = 0;
 static uint8_t LEN_Token = 0;
 static uint8_t FSC_Token = 0;
-static uint8_t *pMsg = NULL;
-static uint8_t tempDataLen;
+static uint16_t frameScanned = 0;
 //@}
 
 /******************************************************************************
@@ -197,103 +193,95 @@ NPIMSG_msg_t *NPIFrame_frameMsg(uint8_t *pIncomingMsg)
 //!             | SOP | Data Length  |   CMD   |   Data   |  FCS  |
 //!             |  1  |     1        |    2    |  0-Len   |   1   |
 //!
+//!             The frame is left in RxBuf while it arrives, the SOF search
+//!             and the FCS are run over contiguous spans of RxBuf as bytes
+//!             come in, and a message buffer is only allocated once the whole
+//!             frame has passed the FCS check.
+//!
 //! \return     void
 // ----------------------------------------------------------------------------
 void NPIFrame_collectFrameData(void)
 {
-    uint8_t ch;
-    uint8_t uint8_tsInRxBuffer;
+    uint8_t *pSpan;
+    uint8_t *pMsg;
+    uint16_t spanLen;
+    uint16_t frameLen;
+    uint16_t idx;
 
-    while (NPIRxBuf_GetRxBufCount())
+    while ((spanLen = NPIRxBuf_PeekRxBuf(&pSpan)) != 0)
     {
-        NPIRxBuf_ReadFromRxBuf(&ch, 1);
-
         switch (state)
         {
             case NPIFRAMEMT_SOP_STATE:
-                if (ch == MT_SOF)
                 {
-                    state = NPIFRAMEMT_LEN_STATE;
+                    uint8_t *pSof = memchr(pSpan, MT_SOF, spanLen);
+
+                    if (pSof == NULL)
+                    {
+                        /* No SOF in this span, drop it */
+                        NPIRxBuf_FreeRxBuf(spanLen);
+                    }
+                    else
+                    {
+                        /* Drop everything up to and including the SOF */
+                        NPIRxBuf_FreeRxBuf((pSof - pSpan) + 1);
+                        state = NPIFRAMEMT_LEN_STATE;
+                    }
                 }
                 break;
 
             case NPIFRAMEMT_LEN_STATE:
-                LEN_Token = ch;
-
-                tempDataLen = 0;
+                LEN_Token = pSpan[0];
+                FSC_Token = 0;
+                frameScanned = 0;
+                state = NPIFRAMEMT_DATA_STATE;
+                break;
 
-                /* Allocate memory for the data */
-                pMsg = (uint8_t *) OsalPort_msgAllocate(MTRPC_FRAME_HDR_SZ + LEN_Token);
+            case NPIFRAMEMT_DATA_STATE:
+                /* Length, CMD0, CMD1, data and FCS */
+                frameLen = MTRPC_FRAME_HDR_SZ + LEN_Token + 1;
 
-                if (pMsg)
+                /* Fold the newly received bytes into the FCS */
+                if (spanLen > frameLen - frameScanned)
                 {
-                    pMsg[MTRPC_POS_LEN] = LEN_Token;
-                    state = NPIFRAMEMT_CMD_STATE1;
+                    spanLen = frameLen - frameScanned;
                 }
-                else
+                for (idx = 0; idx < spanLen; idx++)
                 {
-                    state = NPIFRAMEMT_SOP_STATE;
-                    return;
+                    FSC_Token ^= pSpan[idx];
                 }
-                break;
+                NPIRxBuf_SkipRxBuf(spanLen);
+                frameScanned += spanLen;
 
-            case NPIFRAMEMT_CMD_STATE1:
-                pMsg[MTRPC_POS_CMD0] = ch;
-                state = NPIFRAMEMT_CMD_STATE2;
-                break;
-
-            case NPIFRAMEMT_CMD_STATE2:
-                pMsg[MTRPC_POS_CMD1] = ch;
-                /* If there is no data, skip to FCS state */
-                if (LEN_Token)
-                {
-                    state = NPIFRAMEMT_DATA_STATE;
-                }
-                else
+                if (frameScanned < frameLen)
                 {
-                    state = NPIFRAMEMT_FCS_STATE;
+                    /* Wait for the rest of the frame */
+                    break;
                 }
-                break;
-
-            case NPIFRAMEMT_DATA_STATE:
-
-                /* Fill in the buffer the first uint8_t of the data */
-                pMsg[MTRPC_FRAME_HDR_SZ + tempDataLen++] = ch;
 
-                /* Check number of uint8_ts left in the Rx buffer */
-                uint8_tsInRxBuffer = NPIRxBuf_GetRxBufCount();
+                state = NPIFRAMEMT_SOP_STATE;
 
-                /* If the remain of the data is there, read them all, otherwise, just read enough */
-                if (uint8_tsInRxBuffer <= LEN_Token - tempDataLen)
-                {
-                    NPIRxBuf_ReadFromRxBuf(&pMsg[MTRPC_FRAME_HDR_SZ + tempDataLen], uint8_tsInRxBuffer);
-                    tempDataLen += uint8_tsInRxBuffer;
-                }
-                else
+                /* The FCS byte cancels the XOR of the other bytes */
+                pMsg = NULL;
+                if (FSC_Token == 0)
                 {
-                    NPIRxBuf_ReadFromRxBuf(&pMsg[MTRPC_FRAME_HDR_SZ + tempDataLen], LEN_Token - tempDataLen);
-                    tempDataLen += (LEN_Token - tempDataLen);
+                    pMsg = (uint8_t *) OsalPort_msgAllocate(MTRPC_FRAME_HDR_SZ + LEN_Token);
                 }
 
-                /* If number of uint8_ts read is equal to data length, time to move on to FCS */
-                if (tempDataLen == LEN_Token)
+                if (pMsg == NULL)
                 {
-                    state = NPIFRAMEMT_FCS_STATE;
+                    /* Bad FCS or out of memory, discard the frame */
+                    NPIRxBuf_FreeRxBuf(frameLen);
+                    break;
                 }
 
-                break;
-
-            case NPIFRAMEMT_FCS_STATE:
+                NPIRxBuf_ReadFromRxBuf(pMsg, MTRPC_FRAME_HDR_SZ + LEN_Token);
+                NPIRxBuf_FreeRxBuf(1);
 
-                FSC_Token = ch;
-
-                /* Make sure it's correct */
-                if ((npiframe_calcMTFCS((uint8_t *)&pMsg[0], MTRPC_FRAME_HDR_SZ + LEN_Token) == FSC_Token))
                 {
-
                     /* Determine if it's a SYNC or ASYNC message */
                     NPIMSG_Type msgType;
-                    
+
 #if defined(NPI_SREQRSP)
                     if ((pMsg[1] & MTRPC_CMD_TYPE_MASK) == MTRPC_CMD_SREQ)
                     {
@@ -306,25 +294,20 @@ void NPIFrame_collectFrameData(void)
 #else
                     msgType = NPIMSG_Type_ASYNC;
 #endif // NPI_SREQRSP
-                    
+
                     if ( incomingFrameCBFunc )
                     {
                         incomingFrameCBFunc(MTRPC_FRAME_HDR_SZ + LEN_Token, pMsg, msgType);
                     }
-
-                }
-                else
-                {
-                    /* deallocate the msg */
-                    OsalPort_msgDeallocate(pMsg);
+                    else
+                    {
+                        OsalPort_msgDeallocate(pMsg);
+                    }
                 }
-
-                /* Reset the state, send or discard the buffers at this point */
-                state = NPIFRAMEMT_SOP_STATE;
-
                 break;
 
             default:
+                state = NPIFRAMEMT_SOP_STATE;
                 break;
         }
     }
@@ -54,15 +54,27 @@
 #include "hal_types.h"
 #include "npi_config.h"
 #include "npi_tl.h"
+#include "npi_rxbuf.h"
 
 // ****************************************************************************
 // defines
 // ****************************************************************************
+
+// Largest MT frame: SOF, LEN, CMD0, CMD1, 255 data bytes and FCS
+#define NPIRXBUF_MAX_FRAME_SIZE  260
+
+// The frame parser keeps a frame in RxBuf until all of it has arrived, so
+// on top of a whole frame RxBuf keeps the NPI_TL_BUF_SIZE of headroom it
+// had when bytes were drained as they arrived
+#ifndef NPI_RXBUF_SIZE
+#define NPI_RXBUF_SIZE           (NPIRXBUF_MAX_FRAME_SIZE + NPI_TL_BUF_SIZE)
+#endif
+
 #define NPIRXBUF_RXHEAD_INC(x)   RxBufHead += x;               \
-    RxBufHead %= NPI_TL_BUF_SIZE;
+    RxBufHead %= NPI_RXBUF_SIZE;
 
 #define NPIRXBUF_RXTAIL_INC(x)   RxBufTail += x;               \
-    RxBufTail %= NPI_TL_BUF_SIZE;
+    RxBufTail %= NPI_RXBUF_SIZE;
 
 // ****************************************************************************
 // typedefs
@@ -73,10 +85,14 @@
 //*****************************************************************************
 
 //Receive Buffer for all NPI messages
-static uint8 RxBuf[NPI_TL_BUF_SIZE];
+static uint8 RxBuf[NPI_RXBUF_SIZE];
 static uint16 RxBufHead = 0;
 static uint16 RxBufTail = 0;
 
+//Bytes between RxBufHead and RxBufPeek have been looked at by the frame
+//parser but are still held in RxBuf
+static uint16 RxBufPeek = 0;
+
 //*****************************************************************************
 // function prototypes
 //*****************************************************************************
@@ -93,9 +109,9 @@ uint16 NPIRxBuf_Read(uint16 len)
     uint16 partialLen = 0;
 
     // Need to make two reads due to wrap around of circular buffer
-    if ((len + RxBufTail) > NPI_TL_BUF_SIZE)
+    if ((len + RxBufTail) > NPI_RXBUF_SIZE)
     {
-        partialLen = NPI_TL_BUF_SIZE - RxBufTail;
+        partialLen = NPI_RXBUF_SIZE - RxBufTail;
         NPITL_readTL(&RxBuf[RxBufTail],partialLen);
         len -= partialLen;
         RxBufTail = 0;
@@ -118,7 +134,7 @@ uint16 NPIRxBuf_Read(uint16 len)
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_GetRxBufCount(void)
 {
-    return ((RxBufTail - RxBufHead) + NPI_TL_BUF_SIZE) % NPI_TL_BUF_SIZE;
+    return ((RxBufTail - RxBufPeek) + NPI_RXBUF_SIZE) % NPI_RXBUF_SIZE;
 }
 
 // -----------------------------------------------------------------------------
@@ -128,7 +144,8 @@ uint16 NPIRxBuf_GetRxBufCount(void)
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_GetRxBufAvail(void)
 {
-    return (NPI_TL_BUF_SIZE - NPIRxBuf_GetRxBufCount());
+    return (NPI_RXBUF_SIZE -
+            (((RxBufTail - RxBufHead) + NPI_RXBUF_SIZE) % NPI_RXBUF_SIZE));
 }
 
 // -----------------------------------------------------------------------------
@@ -138,12 +155,68 @@ uint16 NPIRxBuf_GetRxBufAvail(void)
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_ReadFromRxBuf(uint8_t *buf, uint16 len)
 {
-	uint16_t idx;
-    for (idx = 0; idx < len; idx++)
+    uint16 partialLen = 0;
+
+    // Need to make two copies due to wrap around of circular buffer
+    if ((len + RxBufHead) > NPI_RXBUF_SIZE)
     {
-        *buf++ = RxBuf[RxBufHead];
-        NPIRXBUF_RXHEAD_INC(1)
+        partialLen = NPI_RXBUF_SIZE - RxBufHead;
+        memcpy(buf, &RxBuf[RxBufHead], partialLen);
+        buf += partialLen;
     }
+    memcpy(buf, &RxBuf[(RxBufHead + partialLen) % NPI_RXBUF_SIZE],
+           len - partialLen);
+
+    NPIRxBuf_FreeRxBuf(len);
 
     return len;
 }
+
+// -----------------------------------------------------------------------------
+//! \brief      Returns the longest contiguous run of unparsed bytes in RxBuf
+//!
+//! \param[out] ppBuf - set to the first unparsed byte
+//!
+//! \return     uint16 - number of bytes at *ppBuf, 0 if none
+// -----------------------------------------------------------------------------
+uint16 NPIRxBuf_PeekRxBuf(uint8_t **ppBuf)
+{
+    uint16 count = NPIRxBuf_GetRxBufCount();
+    uint16 span = NPI_RXBUF_SIZE - RxBufPeek;
+
+    *ppBuf = &RxBuf[RxBufPeek];
+
+    return (count < span) ? count : span;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      Marks unparsed bytes as parsed without removing them from RxBuf
+//!
+//! \param[in]  len - number of bytes, at most NPIRxBuf_GetRxBufCount()
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPIRxBuf_SkipRxBuf(uint16 len)
+{
+    RxBufPeek = (RxBufPeek + len) % NPI_RXBUF_SIZE;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      Removes bytes from RxBuf without copying them
+//!
+//! \param[in]  len - number of bytes, parsed or not
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPIRxBuf_FreeRxBuf(uint16 len)
+{
+    uint16 held = ((RxBufPeek - RxBufHead) + NPI_RXBUF_SIZE) % NPI_RXBUF_SIZE;
+
+    NPIRXBUF_RXHEAD_INC(len)
+
+    // Removed bytes that the parser had not reached yet count as parsed
+    if (len >= held)
+    {
+        RxBufPeek = RxBufHead;
+    }
+}
@@ -104,6 +104,33 @@ uint16 NPIRxBuf_GetRxBufAvail();
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_ReadFromRxBuf(uint8_t *buf, uint16 len);
 
+// -----------------------------------------------------------------------------
+//! \brief      Returns the longest contiguous run of unparsed bytes in RxBuf
+//!
+//! \param[out] ppBuf - set to the first unparsed byte
+//!
+//! \return     uint16 - number of bytes at *ppBuf, 0 if none
+// -----------------------------------------------------------------------------
+uint16 NPIRxBuf_PeekRxBuf(uint8_t **ppBuf);
+
+// -----------------------------------------------------------------------------
+//! \brief      Marks unparsed bytes as parsed without removing them from RxBuf
+//!
+//! \param[in]  len - number of bytes, at most NPIRxBuf_GetRxBufCount()
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPIRxBuf_SkipRxBuf(uint16 len);
+
+// -----------------------------------------------------------------------------
+//! \brief      Removes bytes from RxBuf without copying them
+//!
+//! \param[in]  len - number of bytes, parsed or not
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPIRxBuf_FreeRxBuf(uint16 len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -114,6 +114,7 @@ typedef struct NPI_QueueRec_t
 {
     Queue_Elem _elem;
     NPIMSG_msg_t *npiMsg;
+    uint32_t enqueueTick;
 } NPI_QueueRec;
 
 
@@ -160,6 +161,21 @@ static Clock_Struct syncReqRspWatchDogClkStruct;
 static Clock_Handle syncReqRspWatchDogClkHandle;
 #endif // NPI_SREQRSP
 
+//! \name ASYNC TX batching
+//@{
+//! \brief Most frames packed into one transport write
+static uint8_t txBatchMaxFrames = NPI_TX_BATCH_MAX_FRAMES;
+//! \brief Longest time a partial batch is held, in clock ticks
+static uint32_t txBatchDelayTicks = 0;
+//! \brief Batching statistics
+static NPI_TxBatchStats_t txBatchStats;
+//! \brief Buffer the frames of a batch are packed into
+static uint8_t txBatchBuf[NPI_TL_BUF_SIZE];
+//! \brief Clock that releases a held partial batch
+static Clock_Struct txBatchClkStruct;
+static Clock_Handle txBatchClkHandle;
+//@}
+
 //! \brief NPI thread Semaphore.
 //!
 Semaphore_Struct structSem;
@@ -171,6 +187,7 @@ uint32_t npiServiceTaskEvents;
 static uint16_t TX_DONE_ISR_EVENT_FLAG = 0;
 static uint16_t MRDY_ISR_EVENT_FLAG = 0;
 static uint16_t TRANSPORT_RX_ISR_EVENT_FLAG = 0;
+static uint16_t TX_BATCH_ISR_EVENT_FLAG = 0;
 
 //! \brief Pointer to Application RX event callback function for optional
 //!        rerouting of messages to application.
@@ -215,7 +232,11 @@ static void NPITask_MRDYEventCB(int size);
 
 //! \brief ASYNC TX Q Processing function.
 //!
-static void NPITask_ProcessTXQ(void);
+static bool NPITask_ProcessTXQ(void);
+
+//! \brief ASYNC TX batch deadline CB
+//!
+static void txBatchTimeoutCB( UArg a0 );
 
 #if defined(NPI_SREQRSP)
 //! \brief SYNC TX Q Processing function.
@@ -294,11 +315,26 @@ void NPITask_inititializeTask(void)
     syncReqRspWatchDogClkHandle = Clock_handle(&syncReqRspWatchDogClkStruct);
 #endif // NPI_SREQRSP
 
+    // Create the one-shot clock that releases held ASYNC TX batches, its
+    // timeout is set each time it is started
+    {
+        Clock_Params batchClockParams;
+
+        Clock_Params_init(&batchClockParams);
+        batchClockParams.period = 0;
+        batchClockParams.startFlag = 0;
+        Clock_construct(&txBatchClkStruct, txBatchTimeoutCB, 1,
+                        &batchClockParams);
+        txBatchClkHandle = Clock_handle(&txBatchClkStruct);
+    }
+
     Semaphore_Params semParams;
     Semaphore_Params_init(&semParams);
     Semaphore_construct(&structSem, 1, &semParams);
     npiSemHandle = Semaphore_handle(&structSem);
 
+    NPITask_setTxBatchParams(NPI_TX_BATCH_MAX_FRAMES, NPI_TX_BATCH_DELAY);
+
     npiServiceTaskId = OsalPort_registerTask(Task_self(), npiSemHandle, &npiServiceTaskEvents);
     // Pass NPI Task ID to NPI Client (MT) for communication
     NPIClient_saveNPITaskInfo(npiServiceTaskId);
@@ -338,11 +374,13 @@ static void NPITask_process(void)
             key = OsalPort_enterCS();
 
             npiServiceTaskEvents = npiServiceTaskEvents | TX_DONE_ISR_EVENT_FLAG |
-                             MRDY_ISR_EVENT_FLAG | TRANSPORT_RX_ISR_EVENT_FLAG;
+                             MRDY_ISR_EVENT_FLAG | TRANSPORT_RX_ISR_EVENT_FLAG |
+                             TX_BATCH_ISR_EVENT_FLAG;
 
             TX_DONE_ISR_EVENT_FLAG = 0;
             MRDY_ISR_EVENT_FLAG = 0;
             TRANSPORT_RX_ISR_EVENT_FLAG = 0;
+            TX_BATCH_ISR_EVENT_FLAG = 0;
 
             OsalPort_leaveCS(key);
 
@@ -421,6 +459,8 @@ static void NPITask_process(void)
             // An ASYNC message is ready to send to the Host
             if(npiServiceTaskEvents & NPITASK_TX_READY_EVENT)
             {
+                bool txHeld = false;
+
 #if defined(NPI_SREQRSP)
                 // Check for outstanding SYNC REQ/RSP transactions.  If so,
                 // this ASYNC message must remain Q'd while we wait for the
@@ -433,15 +473,17 @@ static void NPITask_process(void)
                     if ((!Queue_empty(npiTxQueue)) && !NPITL_checkNpiBusy())
                     {
                         // Push the pending Async Msg to the host.
-                        NPITask_ProcessTXQ();
+                        txHeld = NPITask_ProcessTXQ();
                     }
 #if defined(NPI_SREQRSP)
                 }
 #endif // NPI_SREQRSP
 
-                if (Queue_empty(npiTxQueue))
+                if (Queue_empty(npiTxQueue) || txHeld)
                 {
-                    // Q is empty, it's safe to clear the event flag.
+                    // Q is empty, or a partial batch is held until the batch
+                    // clock or the next enqueue sets the flag again, so it's
+                    // safe to clear the event flag.
                     npiServiceTaskEvents &= ~NPITASK_TX_READY_EVENT;
                 }
                 else
@@ -612,6 +654,58 @@ uint8_t NPITask_getServiceTaskId(void)
     return npiServiceTaskId;
 }
 
+// -----------------------------------------------------------------------------
+//! \brief      Configure ASYNC TX batching.
+//!
+//! \param[in]  maxFrames  Frames per transport write, 1 disables batching
+//! \param[in]  maxDelay   Longest time (ms) to hold a partial batch
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITask_setTxBatchParams(uint8_t maxFrames, uint16_t maxDelay)
+{
+    uint32_t key;
+
+#if defined(NPI_USE_SPI)
+    // The host expects one MT frame per SPI transaction
+    maxFrames = 1;
+#endif
+
+    key = OsalPort_enterCS();
+
+    txBatchMaxFrames = (maxFrames != 0) ? maxFrames : 1;
+    txBatchDelayTicks = ((uint32_t)maxDelay * 1000) / Clock_tickPeriod;
+
+    OsalPort_leaveCS(key);
+
+    // Release anything held under the old settings
+    TX_BATCH_ISR_EVENT_FLAG = NPITASK_TX_READY_EVENT;
+    Semaphore_post(npiSemHandle);
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      Read the ASYNC TX batching statistics.
+//!
+//! \param[out] pStats     Filled in with the statistics
+//! \param[in]  reset      Non-zero to clear the statistics after reading
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITask_getTxBatchStats(NPI_TxBatchStats_t *pStats, uint8_t reset)
+{
+    uint32_t key;
+
+    key = OsalPort_enterCS();
+
+    *pStats = txBatchStats;
+    if (reset)
+    {
+        memset(&txBatchStats, 0, sizeof(txBatchStats));
+    }
+
+    OsalPort_leaveCS(key);
+}
+
 // -----------------------------------------------------------------------------
 //! \brief      Register callback function to reroute incoming (from host)
 //!             NPI messages.
@@ -684,6 +778,7 @@ void NPITask_sendToHost(uint8_t *pMsg)
 #endif // NPI_SREQRSP
             case NPIMSG_Type_ASYNC:
             {
+                recPtr->enqueueTick = Clock_getTicks();
                 Queue_enqueue(npiTxQueue, &recPtr->_elem);
                 npiServiceTaskEvents |= NPITASK_TX_READY_EVENT;
                 Semaphore_post(npiSemHandle);
@@ -810,6 +905,7 @@ static void NPITask_processStackMsg(uint8_t *pMsg)
 #endif // NPI_SREQRSP
                 case NPIMSG_Type_ASYNC:
                 {
+                    recPtr->enqueueTick = Clock_getTicks();
                     Queue_enqueue(npiTxQueue, &recPtr->_elem);
                     npiServiceTaskEvents |= NPITASK_TX_READY_EVENT;
                     Semaphore_post(npiSemHandle);
@@ -837,34 +933,159 @@ static void NPITask_processStackMsg(uint8_t *pMsg)
 }
 
 // -----------------------------------------------------------------------------
-//! \brief      Dequeue next message in the ASYNC TX Queue and send to serial
-//!             interface.
+//! \brief      Dequeue the next messages in the ASYNC TX Queue and send them
+//!             to serial interface.  With batching enabled, as many queued
+//!             frames as fit in one transport write are sent together, and a
+//!             partial batch is held until its oldest frame reaches the
+//!             batching deadline.
 //!
-//! \return     void
+//! \return     bool - true if a partial batch is being held
 // -----------------------------------------------------------------------------
-static void NPITask_ProcessTXQ(void)
+static bool NPITask_ProcessTXQ(void)
 {
     uint32_t key;
+    uint32_t now;
+    uint32_t waited;
+    uint16_t len;
+    uint16_t size;
+    uint8_t numFrames;
+    uint8_t *pBuf;
+    bool deadline = false;
     NPI_QueueRec *recPtr = NULL;
+    NPI_QueueRec *sendPtr = NULL;
 
     // Processing of any TX Queue should only be done
     // in a critical section since any application
     // task can enqueue items freely
     key = OsalPort_enterCS();
 
-    recPtr = Queue_dequeue(npiTxQueue);
+    if (Queue_empty(npiTxQueue))
+    {
+        OsalPort_leaveCS(key);
+        return (false);
+    }
+
+    now = Clock_getTicks();
 
-    if (recPtr != NULL)
+    if ((txBatchMaxFrames > 1) && (txBatchDelayTicks != 0))
     {
-        NPITL_writeTL(recPtr->npiMsg->pBuf, recPtr->npiMsg->pBufSize);
+        Queue_Elem *elem;
+
+        // Count the frames that would go out in this batch
+        len = 0;
+        numFrames = 0;
+        for (elem = Queue_head(npiTxQueue);
+             (elem != (Queue_Elem *)npiTxQueue) && (numFrames < txBatchMaxFrames);
+             elem = Queue_next(elem))
+        {
+            size = ((NPI_QueueRec *)elem)->npiMsg->pBufSize;
+            if ((numFrames != 0) && ((len + size) > NPI_TL_BUF_SIZE))
+            {
+                break;
+            }
+            len += size;
+            numFrames++;
+        }
+
+        recPtr = (NPI_QueueRec *)Queue_head(npiTxQueue);
+        waited = now - recPtr->enqueueTick;
+
+        if ((numFrames < txBatchMaxFrames) && (elem == (Queue_Elem *)npiTxQueue))
+        {
+            // Everything queued fits with room to spare
+            if (waited < txBatchDelayTicks)
+            {
+                // Hold the batch until the oldest frame's deadline
+                if (!Clock_isActive(txBatchClkHandle))
+                {
+                    Clock_setTimeout(txBatchClkHandle, txBatchDelayTicks - waited);
+                    Clock_start(txBatchClkHandle);
+                }
+                OsalPort_leaveCS(key);
+                return (true);
+            }
+            deadline = true;
+        }
+
+        Clock_stop(txBatchClkHandle);
+    }
+
+    // Take the first frame, then pack in as many more as fit
+    sendPtr = Queue_dequeue(npiTxQueue);
+    pBuf = sendPtr->npiMsg->pBuf;
+    len = sendPtr->npiMsg->pBufSize;
+    numFrames = 1;
+    waited = now - sendPtr->enqueueTick;
+
+    for (;;)
+    {
+        uint16_t delay = (uint16_t)((waited * Clock_tickPeriod) / 1000);
+
+        txBatchStats.totalQueueDelay += delay;
+        if (delay > txBatchStats.maxQueueDelay)
+        {
+            txBatchStats.maxQueueDelay = delay;
+        }
+
+        if ((numFrames >= txBatchMaxFrames) || Queue_empty(npiTxQueue))
+        {
+            break;
+        }
+
+        recPtr = (NPI_QueueRec *)Queue_head(npiTxQueue);
+        size = recPtr->npiMsg->pBufSize;
+        if ((len + size) > NPI_TL_BUF_SIZE)
+        {
+            break;
+        }
+
+        if (sendPtr != NULL)
+        {
+            // Second frame: move the first one into the batch buffer
+            memcpy(txBatchBuf, pBuf, len);
+            pBuf = txBatchBuf;
+            OsalPort_msgDeallocate(sendPtr->npiMsg->pBuf);
+            OsalPort_free(sendPtr->npiMsg);
+            OsalPort_free(sendPtr);
+            sendPtr = NULL;
+        }
+
+        recPtr = Queue_dequeue(npiTxQueue);
+        memcpy(&txBatchBuf[len], recPtr->npiMsg->pBuf, size);
+        len += size;
+        numFrames++;
+        waited = now - recPtr->enqueueTick;
 
-        //free the Queue record
         OsalPort_msgDeallocate(recPtr->npiMsg->pBuf);
         OsalPort_free(recPtr->npiMsg);
         OsalPort_free(recPtr);
     }
 
+    NPITL_writeTL(pBuf, len);
+
+    txBatchStats.transfers++;
+    txBatchStats.frames += numFrames;
+    txBatchStats.bytes += len;
+    if (deadline)
+    {
+        txBatchStats.deadlineFlushes++;
+    }
+    if (numFrames > txBatchStats.maxBatchFrames)
+    {
+        txBatchStats.maxBatchFrames = numFrames;
+    }
+
+    if (sendPtr != NULL)
+    {
+        //free the Queue record
+        OsalPort_msgDeallocate(sendPtr->npiMsg->pBuf);
+        OsalPort_free(sendPtr->npiMsg);
+        OsalPort_free(sendPtr);
+    }
+
     OsalPort_leaveCS(key);
+
+    return (false);
 }
 
 #if defined(NPI_SREQRSP)
@@ -1036,6 +1257,20 @@ static void NPITask_processSyncRXQ(void)
 // -----------------------------------------------------------------------------
 // Call Back Functions
 
+// -----------------------------------------------------------------------------
+//! \brief      Call back function for the ASYNC TX batch deadline.
+//!
+//! \param[in]  a0      Unused
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+static void txBatchTimeoutCB( UArg a0 )
+{
+    // Post the event to the NPI task thread.
+    TX_BATCH_ISR_EVENT_FLAG = NPITASK_TX_READY_EVENT;
+    Semaphore_post(npiSemHandle);
+}
+
 // -----------------------------------------------------------------------------
 //! \brief      Call back function for TX Done event from transport layer.
 //!
@@ -1131,8 +1366,8 @@ static void NPITask_transportRXCallBack(int size)
     // If NPI_FLOW_CTRL is not enabled then there is no way to for slave to
     // control the master transfer rate. With NPI_FLOW_CTRL the slave has SRDY
     // to use as a software flow control mechanism.
-    // When using NPI_FLOW_CTRL make sure to increase NPI_TL_BUF_SIZE
-    // to suit the NPI frame length that is expected to be received.
+    // RxBuf is sized by NPI_RXBUF_SIZE to hold the largest MT frame plus
+    // NPI_TL_BUF_SIZE of headroom for the data received behind it.
     if ( size < NPIRxBuf_GetRxBufAvail() )
     {
         NPIRxBuf_Read(size);
@@ -1142,7 +1377,7 @@ static void NPITask_transportRXCallBack(int size)
     else
     {
         // Trap here for pending buffer overflow. If NPI_FLOW_CTRL is
-        // enabled, increase size of RxBuf to handle larger frames from host.
+        // enabled, increase NPI_RXBUF_SIZE to handle the host's bursts.
         for(;;);
     }
 }
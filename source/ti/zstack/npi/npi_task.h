@@ -93,6 +93,19 @@ typedef enum NPIEventRerouteType { NONE,
                                    ECHO,
                                    INTERCEPT } NPI_IncomingNPIEventRerouteType;
 
+//! \brief      ASYNC TX batching statistics, see NPITask_getTxBatchStats().
+//!
+typedef struct
+{
+    uint32_t transfers;         //!< Transport writes of ASYNC frames
+    uint32_t frames;            //!< ASYNC frames sent
+    uint32_t bytes;             //!< ASYNC bytes sent
+    uint32_t deadlineFlushes;   //!< Partial batches sent on the deadline
+    uint32_t totalQueueDelay;   //!< Sum of frame queueing delays, in ms
+    uint16_t maxQueueDelay;     //!< Longest frame queueing delay, in ms
+    uint8_t  maxBatchFrames;    //!< Most frames sent in one transport write
+} NPI_TxBatchStats_t;
+
 
 
 //*****************************************************************************
@@ -154,6 +167,30 @@ extern void NPITask_registerIncomingTXEventAppCB(npiIncomingEventCBack_t appTxCB
 // -----------------------------------------------------------------------------
 extern void NPITask_sendToHost(uint8_t *pMsg);
 
+// -----------------------------------------------------------------------------
+//! \brief      Configure ASYNC TX batching.  Up to maxFrames queued frames
+//!             that fit in NPI_TL_BUF_SIZE are sent in one transport write.
+//!             A partial batch is held until its oldest frame has been queued
+//!             for maxDelay ms.  Batching is only available on UART; SPI
+//!             always sends one frame per transaction.
+//!
+//! \param[in]  maxFrames  Frames per transport write, 1 disables batching
+//! \param[in]  maxDelay   Longest time (ms) to hold a partial batch
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+extern void NPITask_setTxBatchParams(uint8_t maxFrames, uint16_t maxDelay);
+
+// -----------------------------------------------------------------------------
+//! \brief      Read the ASYNC TX batching statistics.
+//!
+//! \param[out] pStats     Filled in with the statistics
+//! \param[in]  reset      Non-zero to clear the statistics after reading
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+extern void NPITask_getTxBatchStats(NPI_TxBatchStats_t *pStats, uint8_t reset);
+
 
 #ifdef __cplusplus
 {
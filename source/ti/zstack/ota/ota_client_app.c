@@ -98,6 +98,13 @@
 
 #define MINIMUM_IMAGE_BLOCK_REQUEST_TIMEOUT  300   //This is to avoid the device storming the network with many request, consider increasing this if the device is several hops away
 
+// Number of Image Block Requests kept outstanding during a download.  A value
+// of 1 gives the classic stop-and-wait download; larger values pipeline the
+// requests and reassemble out of order responses before they are written.
+#if !defined OTA_BLOCK_WINDOW_SIZE
+#define OTA_BLOCK_WINDOW_SIZE                1
+#endif
+
 /*********************************************************************
  * CONSTANTS
  */
@@ -106,6 +113,22 @@
  * TYPEDEFS
  */
 
+// Image block window slot states
+#define ZCL_OTA_BLOCK_SLOT_FREE       0  // Slot not in use
+#define ZCL_OTA_BLOCK_SLOT_QUEUED     1  // Request needs to be (re)sent
+#define ZCL_OTA_BLOCK_SLOT_PENDING    2  // Request sent, waiting for the response
+#define ZCL_OTA_BLOCK_SLOT_RECEIVED   3  // Response held until its offset is reached
+
+typedef struct
+{
+  uint32_t offset;      // File offset requested by this slot
+  uint8_t len;          // Number of bytes requested
+  uint8_t rcvLen;       // Number of bytes received
+  uint8_t state;        // ZCL_OTA_BLOCK_SLOT_*
+  uint8_t retries;      // Response timeouts seen for this block
+  uint8_t *pData;       // Out of order data, allocated on reception
+} zclOTA_BlockSlot_t;
+
 /******************************************************************************
  * GLOBAL VARIABLES
  */
@@ -162,9 +185,12 @@ uint8_t zclOTA_AppTask = 0xFF;                            // Callback Task ID
 //static uint8_t zclOTA_TaskID;
 
 // Retry counters
-static uint8_t zclOTA_BlockRetry;
 static uint8_t zclOTA_UpgradeEndRetry;
 
+// Outstanding image block requests
+static zclOTA_BlockSlot_t zclOTA_BlockWindow[OTA_BLOCK_WINDOW_SIZE];
+static uint32_t zclOTA_NextReqOffset;    // File offset of the next new request
+
 static zclOTA_FileID_t zclOTA_CurrentDlFileId;
 static cId_t otaClusters = ZCL_CLUSTER_ID_OTA;
 static uint16_t zclOTA_UpdateDelay;
@@ -205,6 +231,11 @@ static void zclOTA_UpgradeComplete ( uint8_t status );
 static uint8_t zclOTA_CmpFileId ( zclOTA_FileID_t *f1, zclOTA_FileID_t *f2 );
 static void zclOTA_ImageBlockWaitExpired ( void );
 static ZStatus_t sendImageBlockReq ( afAddrType_t *dstAddr );
+static ZStatus_t zclOTA_SendBlockSlot ( afAddrType_t *dstAddr, zclOTA_BlockSlot_t *pSlot );
+static void zclOTA_BlockWindowReset ( void );
+static zclOTA_BlockSlot_t *zclOTA_BlockWindowFind ( uint32_t offset );
+static uint8_t zclOTA_BlockWindowRetry ( void );
+static uint8_t zclOTA_BlockWindowDrain ( void );
 static void zclOTA_StartTimer ( Clock_Handle cHandle, Clock_Struct *cStruct,  uint32_t seconds);
 
 
@@ -629,7 +660,8 @@ uint16_t zclOTA_event_loop ( void )
   if ( events & ZCL_OTA_BLOCK_RSP_TO_EVT )
   {
     // We timed out waiting for a Block Response
-    if ( ++zclOTA_BlockRetry > OTA_MAX_BLOCK_RETRIES )
+    if ( ( zclOTA_ImageUpgradeStatus == OTA_STATUS_IN_PROGRESS ) &&
+         ( zclOTA_BlockWindowRetry() == FALSE ) )
     {
       // Send a failed update end request
       zclOTA_UpgradeEndReqParams_t  req;
@@ -640,13 +672,9 @@ uint16_t zclOTA_event_loop ( void )
 
       zclOTA_SendUpgradeEndReq (currentOtaEndpoint, &zclOTA_serverAddr, &req );
 
+      zclOTA_BlockWindowReset();
       zclOTA_UpgradeComplete ( ZOtaAbort );
     }
-    else
-    {
-      // Send another block request
-      sendImageBlockReq(&zclOTA_serverAddr);
-    }
 
     events &= ( ~ZCL_OTA_BLOCK_RSP_TO_EVT );
   }
@@ -845,6 +873,7 @@ static ZStatus_t zclOTA_ProcessQueryNextImageRsp ( zclIncoming_t *pInMsg )
       // initialize other variables
       zclOTA_FileOffset = 0;
       zclOTA_ClientPdState = ZCL_OTA_PD_MAGIC_0_STATE;
+      zclOTA_BlockWindowReset();
 
       // set state to 'in progress'
       zclOTA_ImageUpgradeStatus = OTA_STATUS_IN_PROGRESS;
@@ -960,24 +989,62 @@ static ZStatus_t zclOTA_ProcessImageBlockRsp ( zclIncoming_t *pInMsg )
     }
     else
     {
-      // Drop duplicate packets (retries)
+      zclOTA_BlockSlot_t *pSlot = zclOTA_BlockWindowFind ( param.rsp.success.fileOffset );
+
+      if ( ( pSlot != NULL ) && ( param.rsp.success.dataSize > pSlot->len ) )
+      {
+        param.rsp.success.dataSize = pSlot->len;
+      }
+
       if ( param.rsp.success.fileOffset != zclOTA_FileOffset )
       {
+        // Drop duplicate packets (retries) and blocks no longer outstanding
+        if ( ( pSlot == NULL ) || ( pSlot->state != ZCL_OTA_BLOCK_SLOT_PENDING ) )
+        {
+          return ZSuccess;
+        }
+
+        // Hold the block until the data in front of it has arrived; if there
+        // is no memory it is simply requested again on the response timeout
+        pSlot->pData = OsalPort_malloc ( param.rsp.success.dataSize );
+        if ( pSlot->pData != NULL )
+        {
+          OsalPort_memcpy ( pSlot->pData, param.rsp.success.pData, param.rsp.success.dataSize );
+          pSlot->rcvLen = param.rsp.success.dataSize;
+          pSlot->state = ZCL_OTA_BLOCK_SLOT_RECEIVED;
+        }
+
         return ZSuccess;
       }
 
       Timer_stop(&blockRspToClkStruct);
       events &= (~ZCL_OTA_BLOCK_RSP_TO_EVT);
-      // Stop the timer and clear the retry count
-      zclOTA_BlockRetry = 0;
 
       status = zclOTA_ProcessImageData ( param.rsp.success.pData, param.rsp.success.dataSize );
 
+      if ( pSlot != NULL )
+      {
+        if ( pSlot->pData != NULL )
+        {
+          OsalPort_free ( pSlot->pData );
+          pSlot->pData = NULL;
+        }
+        pSlot->rcvLen = param.rsp.success.dataSize;
+        pSlot->state = ZCL_OTA_BLOCK_SLOT_RECEIVED;
+      }
+
+      // Write out any blocks that were waiting behind this one
+      if ( status == ZSuccess )
+      {
+        status = zclOTA_BlockWindowDrain();
+      }
 
       if ( status == ZSuccess )
       {
         if ( zclOTA_ImageUpgradeStatus == OTA_STATUS_COMPLETE )
         {
+          zclOTA_BlockWindowReset();
+
           // send upgrade end req with success status
           //OsalPort_memcpy ( &req.fileId, &param.rsp.success.fileId, sizeof ( zclOTA_FileID_t ) );
           OsalPort_memcpy ( &req.fileId, &param.rsp.success.fileId, sizeof ( zclOTA_FileID_t ) );
@@ -1014,10 +1081,13 @@ static ZStatus_t zclOTA_ProcessImageBlockRsp ( zclIncoming_t *pInMsg )
     // check to see if device supports blockReqDelay rate limiting
     if ( ( zclOTA_ImageBlockFC & OTA_BLOCK_FC_REQ_DELAY_PRESENT ) != 0 )
     {
+      // The server answered instead of sending data; request the whole
+      // window again once the wait is over
+      zclOTA_BlockWindowReset();
+
       if ( ( param.rsp.wait.requestTime - param.rsp.wait.currentTime ) > 0 )
       {
-        // Stop the timer and clear the retry count
-        zclOTA_BlockRetry = 0;
+        // Stop the timer
         //OsalPortTimers_stopTimer ( zclOTA_TaskID, ZCL_OTA_BLOCK_RSP_TO_EVT );
         if(Timer_isActive(&blockRspToClkStruct) == true)
         {
@@ -1039,8 +1109,8 @@ static ZStatus_t zclOTA_ProcessImageBlockRsp ( zclIncoming_t *pInMsg )
     }
     else
     {
-      // Stop the timer and clear the retry count
-      zclOTA_BlockRetry = 0;
+      // Stop the timer and drop the outstanding requests
+      zclOTA_BlockWindowReset();
       //OsalPortTimers_stopTimer ( zclOTA_TaskID, ZCL_OTA_BLOCK_RSP_TO_EVT );
       if(Timer_isActive(&blockRspToClkStruct) == true)
       {
@@ -1059,8 +1129,8 @@ static ZStatus_t zclOTA_ProcessImageBlockRsp ( zclIncoming_t *pInMsg )
     zclOTA_ImageUpgradeStatus = OTA_STATUS_NORMAL;
     //reset endpoint
     OTAClient_SetEndpoint(0);
-    // Stop the timer and clear the retry count
-    zclOTA_BlockRetry = 0;
+    // Stop the timer and drop the outstanding requests
+    zclOTA_BlockWindowReset();
     //OsalPortTimers_stopTimer ( zclOTA_TaskID, ZCL_OTA_BLOCK_RSP_TO_EVT );
     if(Timer_isActive(&blockRspToClkStruct) == true)
     {
@@ -1080,6 +1150,7 @@ static ZStatus_t zclOTA_ProcessImageBlockRsp ( zclIncoming_t *pInMsg )
   {
     // download failed; set state to 'normal'
     zclOTA_ImageUpgradeStatus = OTA_STATUS_NORMAL;
+    zclOTA_BlockWindowReset();
 
     OTAClient_SetEndpoint(0);
 
@@ -1262,6 +1333,7 @@ static ZStatus_t zclOTA_ProcessQuerySpecificFileRsp ( zclIncoming_t *pInMsg )
 
       // initialize other variables
       zclOTA_FileOffset = 0;
+      zclOTA_BlockWindowReset();
 
       // set state to 'in progress'
       zclOTA_ImageUpgradeStatus = OTA_STATUS_IN_PROGRESS;
@@ -1382,13 +1454,84 @@ static void zclOTA_ImageBlockWaitExpired ( void )
 /******************************************************************************
  * @fn      sendImageBlockReq
  *
- * @brief   Send an Image Block Request.
+ * @brief   Fill the image block window: re-send blocks that came back short,
+ *          then send requests for new blocks until the window is full.
  *
  * @param   dstAddr - where you want the message to go
  *
  * @return  ZStatus_t
  */
 static ZStatus_t sendImageBlockReq ( afAddrType_t *dstAddr )
+{
+  ZStatus_t status = ZSuccess;
+  uint8_t waiting = FALSE;
+  uint8_t i;
+
+  // Offsets below the write position have already been written
+  if ( zclOTA_NextReqOffset < zclOTA_FileOffset )
+  {
+    zclOTA_NextReqOffset = zclOTA_FileOffset;
+  }
+
+  for ( i = 0; i < OTA_BLOCK_WINDOW_SIZE; i++ )
+  {
+    zclOTA_BlockSlot_t *pSlot = &zclOTA_BlockWindow[i];
+
+    if ( pSlot->state == ZCL_OTA_BLOCK_SLOT_FREE )
+    {
+      if ( zclOTA_NextReqOffset >= zclOTA_DownloadedImageSize )
+      {
+        continue;
+      }
+
+      pSlot->offset = zclOTA_NextReqOffset;
+      pSlot->retries = 0;
+
+      if ( zclOTA_DownloadedImageSize - zclOTA_NextReqOffset < OTA_MAX_MTU )
+      {
+        pSlot->len = zclOTA_DownloadedImageSize - zclOTA_NextReqOffset;
+      }
+      else
+      {
+        pSlot->len = OTA_MAX_MTU;
+      }
+
+      zclOTA_NextReqOffset += pSlot->len;
+    }
+    else if ( pSlot->state != ZCL_OTA_BLOCK_SLOT_QUEUED )
+    {
+      if ( pSlot->state == ZCL_OTA_BLOCK_SLOT_PENDING )
+      {
+        waiting = TRUE;
+      }
+      continue;
+    }
+
+    status = zclOTA_SendBlockSlot ( dstAddr, pSlot );
+    waiting = TRUE;
+  }
+
+  if ( waiting )
+  {
+    // Start a timer waiting for a response, also when nothing new was sent
+    // since the timer was stopped for the block that just arrived in order
+    OTA_StartTimeoutEvent( blockRspToClkHandle, &blockRspToClkStruct,  OTA_MAX_BLOCK_RSP_WAIT_TIME);
+  }
+
+  return status;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_SendBlockSlot
+ *
+ * @brief   Send the Image Block Request for one window slot.
+ *
+ * @param   dstAddr - where you want the message to go
+ * @param   pSlot - window slot holding the block offset and length
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclOTA_SendBlockSlot ( afAddrType_t *dstAddr, zclOTA_BlockSlot_t *pSlot )
 {
   zclOTA_ImageBlockReqParams_t req;
 
@@ -1396,26 +1539,169 @@ static ZStatus_t sendImageBlockReq ( afAddrType_t *dstAddr )
   req.fileId.manufacturer = zclOTA_ManufacturerID;
   req.fileId.type = zclOTA_ImageType;
   req.fileId.version = zclOTA_DownloadedFileVersion;
-  req.fileOffset = zclOTA_FileOffset;
+  req.fileOffset = pSlot->offset;
+  req.maxDataSize = pSlot->len;
+  req.blockReqDelay = zclOTA_MinBlockReqDelay;
 
-  if ( zclOTA_DownloadedImageSize - zclOTA_FileOffset < OTA_MAX_MTU )
+  pSlot->state = ZCL_OTA_BLOCK_SLOT_PENDING;
+
+  return zclOTA_SendImageBlockReq (currentOtaEndpoint, dstAddr, &req );
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockWindowReset
+ *
+ * @brief   Drop all outstanding image block requests and any out of order
+ *          data, restarting the window at the current file offset.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void zclOTA_BlockWindowReset ( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < OTA_BLOCK_WINDOW_SIZE; i++ )
   {
-    req.maxDataSize = zclOTA_DownloadedImageSize - zclOTA_FileOffset;
+    if ( zclOTA_BlockWindow[i].pData != NULL )
+    {
+      OsalPort_free ( zclOTA_BlockWindow[i].pData );
+      zclOTA_BlockWindow[i].pData = NULL;
+    }
+
+    zclOTA_BlockWindow[i].state = ZCL_OTA_BLOCK_SLOT_FREE;
   }
-  else
+
+  zclOTA_NextReqOffset = zclOTA_FileOffset;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockWindowFind
+ *
+ * @brief   Find the window slot in use for a file offset.
+ *
+ * @param   offset - file offset of the block
+ *
+ * @return  pointer to the slot, NULL if the offset is not outstanding
+ */
+static zclOTA_BlockSlot_t *zclOTA_BlockWindowFind ( uint32_t offset )
+{
+  uint8_t i;
+
+  for ( i = 0; i < OTA_BLOCK_WINDOW_SIZE; i++ )
   {
-    req.maxDataSize = OTA_MAX_MTU;
+    if ( ( zclOTA_BlockWindow[i].state != ZCL_OTA_BLOCK_SLOT_FREE ) &&
+         ( zclOTA_BlockWindow[i].offset == offset ) )
+    {
+      return &zclOTA_BlockWindow[i];
+    }
   }
 
-  req.blockReqDelay = zclOTA_MinBlockReqDelay;
+  return NULL;
+}
 
-  // Start a timer waiting for a response
-  //OsalPortTimers_startTimer ( zclOTA_TaskID, ZCL_OTA_BLOCK_RSP_TO_EVT, OTA_MAX_BLOCK_RSP_WAIT_TIME );
-  OTA_StartTimeoutEvent( blockRspToClkHandle, &blockRspToClkStruct,  OTA_MAX_BLOCK_RSP_WAIT_TIME);
+/******************************************************************************
+ * @fn      zclOTA_BlockWindowRetry
+ *
+ * @brief   Re-send every block still waiting for its response.
+ *
+ * @param   none
+ *
+ * @return  FALSE if a block has used up its retries, else TRUE
+ */
+static uint8_t zclOTA_BlockWindowRetry ( void )
+{
+  uint8_t sent = FALSE;
+  uint8_t i;
 
+  for ( i = 0; i < OTA_BLOCK_WINDOW_SIZE; i++ )
+  {
+    zclOTA_BlockSlot_t *pSlot = &zclOTA_BlockWindow[i];
 
-  return zclOTA_SendImageBlockReq (currentOtaEndpoint, dstAddr, &req );
+    if ( pSlot->state == ZCL_OTA_BLOCK_SLOT_PENDING )
+    {
+      if ( ++pSlot->retries > OTA_MAX_BLOCK_RETRIES )
+      {
+        return FALSE;
+      }
+
+      zclOTA_SendBlockSlot ( &zclOTA_serverAddr, pSlot );
+      sent = TRUE;
+    }
+  }
+
+  if ( sent )
+  {
+    OTA_StartTimeoutEvent( blockRspToClkHandle, &blockRspToClkStruct,  OTA_MAX_BLOCK_RSP_WAIT_TIME);
+  }
+
+  return TRUE;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockWindowDrain
+ *
+ * @brief   Release the block just written at the old file offset and write
+ *          any received blocks that now follow on in order.  A block that
+ *          came back shorter than requested is queued again for the rest.
+ *
+ * @param   none
+ *
+ * @return  status of the image data processing
+ */
+static uint8_t zclOTA_BlockWindowDrain ( void )
+{
+  uint8_t status = ZSuccess;
+  uint8_t i;
+
+  for ( i = 0; i < OTA_BLOCK_WINDOW_SIZE; i++ )
+  {
+    zclOTA_BlockSlot_t *pSlot = &zclOTA_BlockWindow[i];
+
+    if ( pSlot->state != ZCL_OTA_BLOCK_SLOT_RECEIVED )
+    {
+      continue;
+    }
+
+    if ( pSlot->pData != NULL )
+    {
+      // Out of order data, only usable once the write position reaches it
+      if ( pSlot->offset != zclOTA_FileOffset )
+      {
+        continue;
+      }
+
+      status = zclOTA_ProcessImageData ( pSlot->pData, pSlot->rcvLen );
+
+      OsalPort_free ( pSlot->pData );
+      pSlot->pData = NULL;
+    }
+
+    if ( pSlot->rcvLen < pSlot->len )
+    {
+      pSlot->offset += pSlot->rcvLen;
+      pSlot->len -= pSlot->rcvLen;
+      pSlot->retries = 0;
+      pSlot->state = ZCL_OTA_BLOCK_SLOT_QUEUED;
+    }
+    else
+    {
+      pSlot->state = ZCL_OTA_BLOCK_SLOT_FREE;
+    }
+
+    if ( ( status != ZSuccess ) || ( zclOTA_ImageUpgradeStatus == OTA_STATUS_COMPLETE ) )
+    {
+      break;
+    }
+
+    // The write position moved; rescan for the block that follows it
+    i = (uint8_t)-1;
+  }
+
+  return status;
 }
+
 /******************************************************************************
  * @fn      zclOTA_RequestNextUpdate
  *
@@ -73,6 +73,21 @@
 
 #define ZCL_OTA_MAX_CLIENT           4
 
+// Number of image blocks kept in RAM and shared by all the clients
+#ifndef ZCL_OTA_BLOCK_CACHE_SIZE
+#define ZCL_OTA_BLOCK_CACHE_SIZE     8
+#endif
+
+// Number of blocks read from the host ahead of the one requested
+#ifndef ZCL_OTA_BLOCK_READ_AHEAD
+#define ZCL_OTA_BLOCK_READ_AHEAD     2
+#endif
+
+// Block cache entry states
+#define ZCL_OTA_BLOCK_FREE           0
+#define ZCL_OTA_BLOCK_PENDING        1   // Read ahead from the host
+#define ZCL_OTA_BLOCK_VALID          2
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -83,6 +98,16 @@ typedef struct
   uint8_t  seqNo;
 }zclOTA_ClientSeqNo_t;
 
+typedef struct
+{
+  zclOTA_FileID_t fileId;
+  uint32_t fileOffset;
+  uint16_t lastUse;
+  uint8_t  state;
+  uint8_t  dataSize;
+  uint8_t  data[OTA_MAX_MTU];
+}zclOTA_BlockCacheEntry_t;
+
 /******************************************************************************
  * GLOBAL VARIABLES
  */
@@ -94,6 +119,14 @@ static uint8_t stAppID = 0xFF;
 static endPointDesc_t  zclOTA_Ep = {0};
 static zclOTA_ClientSeqNo_t zclOTA_ClientSeqNoTable[ZCL_OTA_MAX_CLIENT];
 
+// Image blocks read from the host, by file ID and offset
+static zclOTA_BlockCacheEntry_t zclOTA_BlockCache[ZCL_OTA_BLOCK_CACHE_SIZE];
+static uint16_t zclOTA_BlockCacheClock = 0;
+
+// Destination of the file reads issued to fill the cache; the responses
+// to those are not forwarded to any client
+static afAddrType_t zclOTA_ReadAheadAddr = { {0}, afAddrNotPresent, 0, 0 };
+
 #define ZCL_OTA_MAX_ATTRIBUTES          11
 
 CONST zclAttrRec_t zclOTA_Attrs[ZCL_OTA_MAX_ATTRIBUTES] =
@@ -228,6 +261,11 @@ static ZStatus_t zclOTA_ProcessUpgradeEndReq ( zclIncoming_t *pInMsg );
 static uint8_t zclOTA_GetClientSeqNumber( afAddrType_t addr );
 static bool zclOTA_UpdateClientSeqNumber( afAddrType_t addr, uint8_t seqNo );
 
+static zclOTA_BlockCacheEntry_t *zclOTA_BlockCacheFind( zclOTA_FileID_t *pFileId, uint32_t fileOffset );
+static zclOTA_BlockCacheEntry_t *zclOTA_BlockCacheAlloc( void );
+static void zclOTA_BlockCacheStore( zclOTA_FileID_t *pFileId, uint32_t fileOffset, uint8_t *pData, uint8_t dataSize );
+static void zclOTA_BlockCacheReadAhead( zclOTA_FileID_t *pFileId, uint32_t fileOffset, uint8_t len );
+
   /******************************************************************************
  * @fn      OTA_Server_Init
  *
@@ -272,6 +310,8 @@ void OTA_Server_Init( uint8_t stEnt )
     zclOTA_ClientSeqNoTable[n].srcEp = 0xFF;
     zclOTA_ClientSeqNoTable[n].srcAddr = 0xFFFE;
   }
+
+  memset ( zclOTA_BlockCache, 0, sizeof ( zclOTA_BlockCache ) );
 }
 
 /******************************************************************************
@@ -402,12 +442,39 @@ ZStatus_t zclOTA_Srv_ImageBlockReq ( afAddrType_t *pSrcAddr, uint8_t seqNo, zclO
       }
       else
       {
+        zclOTA_BlockCacheEntry_t *pBlock;
+
+        pBlock = zclOTA_BlockCacheFind ( &pParam->fileId, pParam->fileOffset );
+
+        if ( ( pBlock != NULL ) && ( pBlock->state == ZCL_OTA_BLOCK_VALID ) )
+        {
+          zclOTA_ImageBlockRspParams_t blockRsp;
+          uint8_t skip = (uint8_t)( pParam->fileOffset - pBlock->fileOffset );
+
+          // Answer from the cache, without a round trip to the OTA Console
+          blockRsp.status = ZSuccess;
+          OsalPort_memcpy ( &blockRsp.rsp.success.fileId, &pParam->fileId, sizeof ( zclOTA_FileID_t ) );
+          blockRsp.rsp.success.fileOffset = pParam->fileOffset;
+          blockRsp.rsp.success.dataSize = pBlock->dataSize - skip;
+          if ( blockRsp.rsp.success.dataSize > len )
+          {
+            blockRsp.rsp.success.dataSize = len;
+          }
+          blockRsp.rsp.success.pData = &pBlock->data[skip];
+
+          zclOTA_SendImageBlockRsp ( ZCL_OTA_ENDPOINT, pSrcAddr, seqNo, &blockRsp );
+
+          status = ZSuccess;
+        }
         // Read the data from the OTA Console
-        if( zclOTA_UpdateClientSeqNumber( *pSrcAddr, seqNo ) )
+        else if( zclOTA_UpdateClientSeqNumber( *pSrcAddr, seqNo ) )
         {
           status = MT_OtaFileReadReq ( pSrcAddr, seqNo, &pParam->fileId, len, pParam->fileOffset );
         }
 
+        // Clients download sequentially, have the next blocks ready
+        zclOTA_BlockCacheReadAhead ( &pParam->fileId, pParam->fileOffset, len );
+
         // Send a wait response to the client
         if ( status != ZSuccess )
         {
@@ -433,6 +500,183 @@ ZStatus_t zclOTA_Srv_ImageBlockReq ( afAddrType_t *pSrcAddr, uint8_t seqNo, zclO
   return status;
 }
 
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheFind
+ *
+ * @brief   Find the cached block holding a file offset, or the block being
+ *          read ahead from that offset.
+ *
+ * @param   pFileId - The ID of the OTA File
+ *          fileOffset - Offset in the file
+ *
+ * @return  Cache entry, NULL if none
+ */
+static zclOTA_BlockCacheEntry_t *zclOTA_BlockCacheFind( zclOTA_FileID_t *pFileId, uint32_t fileOffset )
+{
+  zclOTA_BlockCacheEntry_t *pBlock;
+  uint8_t n;
+
+  for ( n = 0; n < ZCL_OTA_BLOCK_CACHE_SIZE; n++ )
+  {
+    pBlock = &zclOTA_BlockCache[n];
+
+    if ( ( pBlock->state != ZCL_OTA_BLOCK_FREE ) &&
+         ( pBlock->fileId.version == pFileId->version ) &&
+         ( pBlock->fileId.type == pFileId->type ) &&
+         ( pBlock->fileId.manufacturer == pFileId->manufacturer ) &&
+         ( fileOffset >= pBlock->fileOffset ) &&
+         // a pending block only matches its start offset
+         ( ( fileOffset == pBlock->fileOffset ) ||
+           ( fileOffset - pBlock->fileOffset < pBlock->dataSize ) ) )
+    {
+      pBlock->lastUse = ++zclOTA_BlockCacheClock;
+      return pBlock;
+    }
+  }
+
+  return NULL;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheAlloc
+ *
+ * @brief   Get a cache entry, reusing the least recently used one if all
+ *          are taken.
+ *
+ * @param   none
+ *
+ * @return  Cache entry
+ */
+static zclOTA_BlockCacheEntry_t *zclOTA_BlockCacheAlloc( void )
+{
+  zclOTA_BlockCacheEntry_t *pOldest = &zclOTA_BlockCache[0];
+  uint8_t n;
+
+  for ( n = 0; n < ZCL_OTA_BLOCK_CACHE_SIZE; n++ )
+  {
+    if ( zclOTA_BlockCache[n].state == ZCL_OTA_BLOCK_FREE )
+    {
+      pOldest = &zclOTA_BlockCache[n];
+      break;
+    }
+
+    // Wrap-safe comparison of the use stamps
+    if ( (int16_t)( zclOTA_BlockCache[n].lastUse - pOldest->lastUse ) < 0 )
+    {
+      pOldest = &zclOTA_BlockCache[n];
+    }
+  }
+
+  pOldest->state = ZCL_OTA_BLOCK_FREE;
+  pOldest->dataSize = 0;
+  pOldest->lastUse = ++zclOTA_BlockCacheClock;
+
+  return pOldest;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheStore
+ *
+ * @brief   Keep a block read from the host for the other clients.
+ *
+ * @param   pFileId - The ID of the OTA File
+ *          fileOffset - Offset of the block in the file
+ *          pData - Block data
+ *          dataSize - Block length
+ *
+ * @return  none
+ */
+static void zclOTA_BlockCacheStore( zclOTA_FileID_t *pFileId, uint32_t fileOffset, uint8_t *pData, uint8_t dataSize )
+{
+  zclOTA_BlockCacheEntry_t *pBlock;
+  uint8_t n;
+
+  if ( ( dataSize == 0 ) || ( dataSize > OTA_MAX_MTU ) )
+  {
+    return;
+  }
+
+  pBlock = NULL;
+  for ( n = 0; n < ZCL_OTA_BLOCK_CACHE_SIZE; n++ )
+  {
+    if ( ( zclOTA_BlockCache[n].state != ZCL_OTA_BLOCK_FREE ) &&
+         ( zclOTA_BlockCache[n].fileOffset == fileOffset ) &&
+         ( OsalPort_memcmp( &zclOTA_BlockCache[n].fileId, pFileId, sizeof ( zclOTA_FileID_t ) ) ) )
+    {
+      pBlock = &zclOTA_BlockCache[n];
+      break;
+    }
+  }
+
+  if ( pBlock == NULL )
+  {
+    pBlock = zclOTA_BlockCacheAlloc();
+  }
+  else if ( ( pBlock->state == ZCL_OTA_BLOCK_VALID ) && ( pBlock->dataSize >= dataSize ) )
+  {
+    // Already have at least as much
+    return;
+  }
+
+  OsalPort_memcpy ( &pBlock->fileId, pFileId, sizeof ( zclOTA_FileID_t ) );
+  pBlock->fileOffset = fileOffset;
+  pBlock->dataSize = dataSize;
+  OsalPort_memcpy ( pBlock->data, pData, dataSize );
+  pBlock->state = ZCL_OTA_BLOCK_VALID;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheReadAhead
+ *
+ * @brief   Request from the host the blocks following a requested one that
+ *          are not cached yet.
+ *
+ * @param   pFileId - The ID of the OTA File
+ *          fileOffset - Offset of the requested block
+ *          len - Length of the requested block
+ *
+ * @return  none
+ */
+static void zclOTA_BlockCacheReadAhead( zclOTA_FileID_t *pFileId, uint32_t fileOffset, uint8_t len )
+{
+  zclOTA_BlockCacheEntry_t *pBlock;
+  uint8_t n;
+
+  if ( len == 0 )
+  {
+    return;
+  }
+
+  for ( n = 0; n < ZCL_OTA_BLOCK_READ_AHEAD; n++ )
+  {
+    fileOffset += len;
+
+    // Don't read past the end of the image, when its size is known
+    if ( ( queryResponse.status == ZSuccess ) &&
+         ( OsalPort_memcmp( &queryResponse.fileId, pFileId, sizeof ( zclOTA_FileID_t ) ) ) &&
+         ( fileOffset >= queryResponse.imageSize ) )
+    {
+      break;
+    }
+
+    if ( zclOTA_BlockCacheFind ( pFileId, fileOffset ) != NULL )
+    {
+      continue;
+    }
+
+    pBlock = zclOTA_BlockCacheAlloc();
+    OsalPort_memcpy ( &pBlock->fileId, pFileId, sizeof ( zclOTA_FileID_t ) );
+    pBlock->fileOffset = fileOffset;
+    pBlock->state = ZCL_OTA_BLOCK_PENDING;
+
+    if ( MT_OtaFileReadReq ( &zclOTA_ReadAheadAddr, 0, pFileId, len, fileOffset ) != ZSuccess )
+    {
+      pBlock->state = ZCL_OTA_BLOCK_FREE;
+      break;
+    }
+  }
+}
+
 /******************************************************************************
  * @fn      zclOTA_ProcessQueryNextImageReq
  *
@@ -885,6 +1129,7 @@ void zclOTA_ProcessFileReadRsp ( uint8_t* pMsg, zclOTA_FileID_t *pFileId,
                                  afAddrType_t *pAddr, uint8_t seqNo )
 {
   zclOTA_ImageBlockRspParams_t blockRsp;
+  uint8_t n;
 
   // Set the status
   blockRsp.status = *pMsg++;
@@ -898,10 +1143,31 @@ void zclOTA_ProcessFileReadRsp ( uint8_t* pMsg, zclOTA_FileID_t *pFileId,
     pMsg += 4;
     blockRsp.rsp.success.dataSize = *pMsg++;
     blockRsp.rsp.success.pData = pMsg;
+
+    zclOTA_BlockCacheStore ( pFileId, blockRsp.rsp.success.fileOffset,
+                             blockRsp.rsp.success.pData, blockRsp.rsp.success.dataSize );
   }
   else
   {
     blockRsp.status = ZOtaAbort;
+
+    if ( pAddr->addrMode == afAddrNotPresent )
+    {
+      // The offset isn't returned on failure, drop all the reads ahead
+      for ( n = 0; n < ZCL_OTA_BLOCK_CACHE_SIZE; n++ )
+      {
+        if ( zclOTA_BlockCache[n].state == ZCL_OTA_BLOCK_PENDING )
+        {
+          zclOTA_BlockCache[n].state = ZCL_OTA_BLOCK_FREE;
+        }
+      }
+    }
+  }
+
+  // Reads ahead only fill the cache
+  if ( pAddr->addrMode == afAddrNotPresent )
+  {
+    return;
   }
 
   // Send the block response to the peer
@@ -128,7 +128,8 @@ static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
 
 static epList_t *afFindEndPointDescList( uint8_t EndPoint );
 
-static pDescCB afGetDescCB( endPointDesc_t *epDesc );
+static epList_t *afFindEndPointDescListByDesc( endPointDesc_t *epDesc );
+static uint16_t afGetProfileID( epList_t *ep );
 
 static bool afAddCnfItem(afDataCnfList_t* cnfItem);
 
@@ -180,6 +181,7 @@ epList_t *afRegisterExtended( endPointDesc_t *epDesc, pDescCB descFn, pApplCB ap
     ep->apsfCfg.windowSize = APSF_DEFAULT_WINDOW_SIZE;
     ep->flags = eEP_AllowMatch;  // Default to allow Match Descriptor.
     ep->pfnApplCB = applFn;
+    ep->profileID = 0xFFFE;      // Invalid Profile ID, read from descFn on first use
 
   #if (BDB_FINDING_BINDING_CAPABILITY_ENABLED==1)
     //Make sure we add at least one application endpoint
@@ -482,22 +484,7 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16_t S
 
   while ( epDesc )
   {
-    uint16_t epProfileID = 0xFFFE;  // Invalid Profile ID
-
-    if ( pList->pfnDescCB )
-    {
-      uint16_t *pID = (uint16_t *)(pList->pfnDescCB(
-                                 AF_DESCRIPTOR_PROFILE_ID, epDesc->endPoint ));
-      if ( pID )
-      {
-        epProfileID = *pID;
-        OsalPort_free( pID );
-      }
-    }
-    else if ( epDesc->simpleDesc )
-    {
-      epProfileID = epDesc->simpleDesc->AppProfId;
-    }
+    uint16_t epProfileID = afGetProfileID( pList );
 
     // First part of verification is to make sure that:
     // the local Endpoint ProfileID matches the received ProfileID OR
@@ -649,7 +636,6 @@ afStatus_t AF_DataRequestExt( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
                               uint16_t cID, uint16_t len, uint8_t *buf, uint8_t *transID,
                               uint8_t options, uint8_t radius, pfnAfCnfCB afCnfCB, void* cnfParam )
 {
-  pDescCB pfnDescCB;
   ZStatus_t stat;
   APSDE_DataReq_t req;
   afDataReqMTU_t mtu;
@@ -729,14 +715,12 @@ afStatus_t AF_DataRequestExt( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
   {
     req.profileID = ZDO_PROFILE_ID;
 
-    if ( (pfnDescCB = afGetDescCB( srcEP )) )
+    if ( (pList = afFindEndPointDescListByDesc( srcEP )) && pList->pfnDescCB )
     {
-      uint16_t *pID = (uint16_t *)(pfnDescCB(
-                                   AF_DESCRIPTOR_PROFILE_ID, srcEP->endPoint ));
-      if ( pID )
+      uint16_t profileID = afGetProfileID( pList );
+      if ( profileID != 0xFFFE )
       {
-        req.profileID = *pID;
-        OsalPort_free( pID );
+        req.profileID = profileID;
       }
     }
     else if ( srcEP->simpleDesc )
@@ -1137,15 +1121,16 @@ uint8_t afFindSimpleDesc( SimpleDescriptionFormat_t **ppDesc, uint8_t EP )
 }
 
 /*********************************************************************
- * @fn      afGetDescCB
+ * @fn      afFindEndPointDescListByDesc
  *
- * @brief   Get the Descriptor callback function.
+ * @brief   Find the endpoint description entry from the endpoint
+ *          descriptor.
  *
  * @param   epDesc - pointer to the endpoint descriptor
  *
- * @return  function pointer or NULL
+ * @return  the address to the endpoint/interface description entry or NULL
  */
-static pDescCB afGetDescCB( endPointDesc_t *epDesc )
+static epList_t *afFindEndPointDescListByDesc( endPointDesc_t *epDesc )
 {
   epList_t *epSearch;
 
@@ -1158,13 +1143,83 @@ static pDescCB afGetDescCB( endPointDesc_t *epDesc )
     // Is there a match?
     if ( epSearch->epDesc == epDesc )
     {
-      return ( epSearch->pfnDescCB );
+      return ( epSearch );
     }
     else
       epSearch = epSearch->nextDesc;  // Next entry
   }
 
-  return ( (pDescCB)NULL );
+  return ( (epList_t *)NULL );
+}
+
+/*********************************************************************
+ * @fn      afGetProfileID
+ *
+ * @brief   Get the profile ID of an endpoint. The value returned by the
+ *          descriptor callback is cached in the entry so the callback (and
+ *          the memory it allocates) is only used once, until
+ *          afInvalidateDescCache() is called. A NULL descriptor is not
+ *          cached.
+ *
+ * @param   ep - endpoint/interface description entry
+ *
+ * @return  profile ID, 0xFFFE if invalid
+ */
+static uint16_t afGetProfileID( epList_t *ep )
+{
+  if ( ep->pfnDescCB )
+  {
+    if ( (ep->flags & eEP_ProfileIDCached) == 0 )
+    {
+      uint16_t *pID = (uint16_t *)(ep->pfnDescCB(
+                                   AF_DESCRIPTOR_PROFILE_ID, ep->epDesc->endPoint ));
+      if ( pID == NULL )
+      {
+        // Not cached, the callback is asked again next time
+        return ( 0xFFFE );  // Invalid Profile ID
+      }
+
+      ep->profileID = *pID;
+      OsalPort_free( pID );
+      ep->flags |= eEP_ProfileIDCached;
+    }
+    return ( ep->profileID );
+  }
+  else if ( ep->epDesc->simpleDesc )
+  {
+    return ( ep->epDesc->simpleDesc->AppProfId );
+  }
+
+  return ( 0xFFFE );
+}
+
+/*********************************************************************
+ * @fn      afInvalidateDescCache
+ *
+ * @brief   Discard the descriptor values cached from the descriptor
+ *          callback, they are read again on the next use. To be called
+ *          by the application when the descriptor returned changes.
+ *
+ * @param   endPoint - Application Endpoint, AF_BROADCAST_ENDPOINT for all
+ *
+ * @return  afStatus_SUCCESS - cache invalidated
+ *          afStatus_INVALID_PARAMETER - endpoint not found
+ */
+afStatus_t afInvalidateDescCache( uint8_t endPoint )
+{
+  epList_t *epSearch;
+  afStatus_t status = afStatus_INVALID_PARAMETER;
+
+  for ( epSearch = epList; epSearch != NULL; epSearch = epSearch->nextDesc )
+  {
+    if ( (endPoint == AF_BROADCAST_ENDPOINT) || (epSearch->epDesc->endPoint == endPoint) )
+    {
+      epSearch->flags &= (eEP_ProfileIDCached ^ 0xFFFF);
+      status = afStatus_SUCCESS;
+    }
+  }
+
+  return ( status );
 }
 
 /*********************************************************************
@@ -328,6 +328,7 @@ typedef void (*pApplCB)( APSDE_DataReq_t *req );
 typedef enum
 {
   eEP_AllowMatch = 1,
+  eEP_ProfileIDCached = 2,  // profileID holds the AF_DESCRIPTOR_PROFILE_ID from pfnDescCB
   eEP_NotUsed
 } eEP_Flags;
 
@@ -343,6 +344,7 @@ typedef struct _epList_t {
   afAPSF_Config_t apsfCfg;
   eEP_Flags flags;
   pApplCB pfnApplCB;    // Don't use it if it has not been set to a valid function pointer by the application
+  uint16_t profileID;   // Cached profile ID, only valid if eEP_ProfileIDCached is set
 } epList_t;
 
 /*********************************************************************
@@ -524,6 +526,13 @@ afStatus_t afAPSF_ConfigSet(uint8_t endPoint, afAPSF_Config_t *pCfg);
   */
 uint8_t afSetApplCB( uint8_t endPoint, pApplCB pApplFn );
 
+ /*
+  *	afInvalidateDescCache - Discards the descriptor values cached from the
+  *               descriptor callback of an EndPoint (AF_BROADCAST_ENDPOINT
+  *               for all), call it when the descriptor changes.
+  */
+afStatus_t afInvalidateDescCache( uint8_t endPoint );
+
 #ifdef __cplusplus
 }
 #endif
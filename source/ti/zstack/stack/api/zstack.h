@@ -1927,6 +1927,19 @@ typedef struct _zstack_afdataconfirmind_t
     void *cnfParam;
 } zstack_afDataConfirmInd_t;
 
+/**
+ * Reference-counted received frame shared between the ZStack thread and
+ * the application threads it delivers indications to.  The frame is
+ * released when the last reference is dropped.
+ */
+typedef struct _zstack_framebuf_t
+{
+    /** Number of outstanding references to the frame */
+    uint8_t refCount;
+    /** The OsalPort message that holds the frame */
+    void *pFrame;
+} zstack_frameBuf_t;
+
 /**
  * Structure to send an AF Incoming Message Indication.
  */
@@ -1962,8 +1975,16 @@ typedef struct _zstack_afincomingmsgind_t
     uint8_t radius;
     /** Length of the message "payload" */
     uint8_t n_payload;
-    /** Pointer to the message "payload" */
+    /**
+     * Pointer to the message "payload".  When pFrameBuf is set this points
+     * into the shared received frame and must be treated as read-only.
+     */
     uint8_t *pPayload;
+    /**
+     * Shared received frame that pPayload points into, NULL if pPayload
+     * is a private copy.  Released by Zstackapi_freeIndMsg().
+     */
+    zstack_frameBuf_t *pFrameBuf;
 } zstack_afIncomingMsgInd_t;
 
 /**
@@ -3844,6 +3865,47 @@ typedef struct _zstack_pauseResumeDeviceReq_t
     bool pause;
 } zstack_pauseResumeDeviceReq_t;
 
+//*****************************************************************************
+// Asynchronous Request Structures
+//*****************************************************************************
+
+/**
+ * One request submitted with Zstackapi_asyncReq() or Zstackapi_asyncBulkReq().
+ * The pReq and pRsp structures are used by the ZStack Thread after the call
+ * returns, so they must stay valid until the matching
+ * zstackmsg_CmdIDs_ASYNC_CNF is received.
+ */
+typedef struct _zstack_asyncreq_t
+{
+    /** Command ID, the same as the blocking API sends (@ref zstack_CmdIDs) */
+    uint8_t cmdID;
+    /** Request structure, NULL if the command has none */
+    void *pReq;
+    /** Response structure, NULL if the command only has a default response */
+    void *pRsp;
+    /** Application context returned unchanged in the confirmation */
+    void *pContext;
+} zstack_asyncReq_t;
+
+/**
+ * Structure to send an Asynchronous Request Confirmation.
+ */
+typedef struct _zstack_asynccnf_t
+{
+    /** Handle returned when the request was submitted */
+    uint16_t handle;
+    /** Command ID of the completed request */
+    uint8_t cmdID;
+    /** Default response status of the request */
+    zstack_ZStatusValues status;
+    /** Request structure passed in zstack_asyncReq_t */
+    void *pReq;
+    /** Response structure passed in zstack_asyncReq_t, now filled in */
+    void *pRsp;
+    /** Application context passed in zstack_asyncReq_t */
+    void *pContext;
+} zstack_asyncCnf_t;
+
 
 #ifdef __cplusplus
 }
@@ -39,6 +39,7 @@
 
 #include "rom_jt_154.h"
 #include "zstackapi.h"
+#include "hal_mcu.h"
 
 //*****************************************************************************
 // Structures
@@ -64,6 +65,9 @@ typedef struct _genericreqrsp_t
 
 uint8_t stackServiceTaskId;
 
+// Last handle given to an asynchronous request
+static uint16_t asyncReqHandle = 0;
+
 //*****************************************************************************
 // Local Functions
 //*****************************************************************************
@@ -224,6 +228,49 @@ static zstack_ZStatusValues sendReqRsp(uint8_t appServiceTaskId,
     return(status);
 }
 
+/**
+ * Check whether a command can be sent with Zstackapi_asyncBulkReq().  The
+ * asynchronous message only carries request and response pointers, so
+ * commands whose messages hold the request inline are excluded.
+ *
+ * @param cmdID - Command ID of the request
+ *
+ * @return true if the command can be sent asynchronously
+ */
+static bool asyncReqSupported(uint8_t cmdID)
+{
+    switch(cmdID)
+    {
+        case zstackmsg_CmdIDs_SYS_APP_MSG_REQ:
+        case zstackmsg_CmdIDs_SYS_OTA_MSG_REQ:
+        case zstackmsg_CmdIDs_GP_ALLOW_CHANNEL_CHANGE_REQ:
+        case zstackmsg_CmdIDs_ASYNC_REQ:
+        case zstackmsg_CmdIDs_ASYNC_CNF:
+            return(false);
+
+        default:
+            return(true);
+    }
+}
+
+/**
+ * Free an asynchronous request batch that was not sent to the ZStack Thread.
+ *
+ * @param pMsg - Pointer to the batch message
+ */
+static void freeAsyncReq(zstackmsg_asyncReq_t *pMsg)
+{
+    zstackmsg_asyncCnf_t *pEntry;
+
+    while(pMsg->pFirst != NULL)
+    {
+        pEntry = pMsg->pFirst;
+        pMsg->pFirst = pEntry->pNext;
+        OsalPort_msgDeallocate((uint8_t *)pEntry);
+    }
+    OsalPort_msgDeallocate((uint8_t *)pMsg);
+}
+
 //*****************************************************************************
 // Public Functions
 //*****************************************************************************
@@ -1930,6 +1977,174 @@ zstack_ZStatusValues Zstackapi_tlInitiatorNwkJoinRspInd(
  }
 
 
+/**
+ * Call to send a request to the ZStack Thread without waiting for the
+ * response.
+ *
+ * Public function defined in zstackapi.h
+ */
+zstack_ZStatusValues Zstackapi_asyncReq(uint8_t appServiceTaskId,
+                                        zstack_asyncReq_t *pReq,
+                                        uint16_t *pHandle)
+{
+    return(Zstackapi_asyncBulkReq(appServiceTaskId, pReq, 1, pHandle));
+}
+
+/**
+ * Call to send several requests to the ZStack Thread with a single message.
+ *
+ * Public function defined in zstackapi.h
+ */
+zstack_ZStatusValues Zstackapi_asyncBulkReq(uint8_t appServiceTaskId,
+                                            zstack_asyncReq_t *pReqs,
+                                            uint8_t numReqs,
+                                            uint16_t *pHandles)
+{
+    zstackmsg_asyncReq_t *pMsg;
+    zstackmsg_asyncCnf_t *pEntry;
+    zstackmsg_asyncCnf_t **ppTail;
+    halIntState_t intState;
+    uint16_t handle;
+    uint8_t i;
+
+    if((pReqs == NULL) || (numReqs == 0))
+    {
+        return(zstack_ZStatusValues_ZInvalidParameter);
+    }
+
+    for(i = 0; i < numReqs; i++)
+    {
+        if(!asyncReqSupported(pReqs[i].cmdID))
+        {
+            return(zstack_ZStatusValues_ZUnsupportedMode);
+        }
+    }
+
+    pMsg = (zstackmsg_asyncReq_t *)OsalPort_msgAllocate(
+                                            sizeof(zstackmsg_asyncReq_t));
+    if(pMsg == NULL)
+    {
+        return(zstack_ZStatusValues_ZMemError);
+    }
+
+    pMsg->hdr.event = zstackmsg_CmdIDs_ASYNC_REQ;
+    pMsg->hdr.status = 0;
+    pMsg->hdr.srcServiceTask = appServiceTaskId;
+    pMsg->numReqs = 0;
+    pMsg->pFirst = NULL;
+
+    // Build one message per request, each is sent back as its confirmation
+    ppTail = &pMsg->pFirst;
+    for(i = 0; i < numReqs; i++)
+    {
+        pEntry = (zstackmsg_asyncCnf_t *)OsalPort_msgAllocate(
+                                            sizeof(zstackmsg_asyncCnf_t));
+        if(pEntry == NULL)
+        {
+            break;
+        }
+
+        pEntry->hdr.event = pReqs[i].cmdID;
+        pEntry->hdr.status = 0;
+        pEntry->hdr.srcServiceTask = appServiceTaskId;
+
+        // Requests without a request structure carry the response first
+        if((pReqs[i].cmdID == zstackmsg_CmdIDs_SYS_VERSION_REQ) ||
+           (pReqs[i].cmdID == zstackmsg_CmdIDs_SYS_NWK_INFO_READ_REQ))
+        {
+            pEntry->pReq = pReqs[i].pRsp;
+        }
+        else
+        {
+            pEntry->pReq = pReqs[i].pReq;
+        }
+        pEntry->pRsp = pReqs[i].pRsp;
+        pEntry->pNext = NULL;
+
+        pEntry->req.cmdID = pReqs[i].cmdID;
+        pEntry->req.status = zstack_ZStatusValues_ZSuccess;
+        pEntry->req.pReq = pReqs[i].pReq;
+        pEntry->req.pRsp = pReqs[i].pRsp;
+        pEntry->req.pContext = pReqs[i].pContext;
+
+        *ppTail = pEntry;
+        ppTail = &pEntry->pNext;
+        pMsg->numReqs++;
+    }
+
+    if(pMsg->numReqs != numReqs)
+    {
+        // Out of memory, send nothing
+        freeAsyncReq(pMsg);
+
+        return(zstack_ZStatusValues_ZMemError);
+    }
+
+    // Reserve a run of handles, skipping 0 so it never names a request
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    if((uint16_t)(asyncReqHandle + numReqs) < asyncReqHandle)
+    {
+        asyncReqHandle = 0;
+    }
+    handle = asyncReqHandle + 1;
+    asyncReqHandle += numReqs;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    for(pEntry = pMsg->pFirst, i = 0; pEntry != NULL;
+        pEntry = pEntry->pNext, i++)
+    {
+        pEntry->req.handle = handle + i;
+        if(pHandles != NULL)
+        {
+            pHandles[i] = pEntry->req.handle;
+        }
+    }
+
+    if(OsalPort_msgSend(stackServiceTaskId, (uint8_t *)pMsg) != OsalPort_SUCCESS)
+    {
+        freeAsyncReq(pMsg);
+
+        return(zstack_ZStatusValues_ZFailure);
+    }
+
+    return(zstack_ZStatusValues_ZSuccess);
+}
+
+/**
+ * Take an additional reference to a shared received frame.
+ *
+ * Public function defined in zstackapi.h
+ */
+void Zstackapi_frameBufRetain(zstack_frameBuf_t *pFrameBuf)
+{
+    halIntState_t intState;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    pFrameBuf->refCount++;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+}
+
+/**
+ * Drop a reference to a shared received frame, freeing it with the last one.
+ *
+ * Public function defined in zstackapi.h
+ */
+void Zstackapi_frameBufRelease(zstack_frameBuf_t *pFrameBuf)
+{
+    halIntState_t intState;
+    uint8_t refCount;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    refCount = --pFrameBuf->refCount;
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    if(refCount == 0)
+    {
+        OsalPort_msgDeallocate((uint8_t *)pFrameBuf->pFrame);
+        OsalPort_free(pFrameBuf);
+    }
+}
+
 /**
  * Call to free the memory used by an Indication message, messages
  * sent asynchronously from the ZStack thread.
@@ -2156,14 +2371,25 @@ bool Zstackapi_freeIndMsg(void *pMsg)
             }
             break;
 
+        // Asynchronous Request Confirmation, the request and response
+        // structures belong to the application
+        case zstackmsg_CmdIDs_ASYNC_CNF:
+            OsalPort_msgDeallocate(pMsg);
+            break;
+
         // AF Incoming Message Indication
         case zstackmsg_CmdIDs_AF_INCOMING_MSG_IND:
             {
                 zstackmsg_afIncomingMsgInd_t *pInd =
                     (zstackmsg_afIncomingMsgInd_t *)pMsg;
 
-                // Free the message payload
-                if(pInd->req.pPayload)
+                // Drop the reference to the shared frame, or free the
+                // private copy of the payload
+                if(pInd->req.pFrameBuf)
+                {
+                    Zstackapi_frameBufRelease(pInd->req.pFrameBuf);
+                }
+                else if(pInd->req.pPayload)
                 {
                     OsalPort_free(pInd->req.pPayload);
                 }
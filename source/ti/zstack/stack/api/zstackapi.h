@@ -328,6 +328,14 @@
    - zstackmsg_CmdIDs_BDB_TOUCHLINK_TARGET_ENABLE_IND - [zstackmsg_bdbTouchLinkTargetEnableInd_t]
      (@ref _zstackmsg_bdbtouchlinktargetenableind_t)
 
+   The following message will be delivered to your application through an
+   OsalPort message for every request submitted with Zstackapi_asyncReq() or
+   Zstackapi_asyncBulkReq(), you must call Zstackapi_freeIndMsg() to free the
+   message when you are done processing:
+   <BR>
+   - zstackmsg_CmdIDs_ASYNC_CNF - [zstackmsg_asyncCnf_t]
+     (@ref _zstackmsg_asynccnf_t)
+
 
    The following messages will be delivered to your application through an
    OsalPort message when GP messages are process by the stack and must be process by Green Power Proxy
@@ -1980,6 +1988,52 @@ extern zstack_ZStatusValues  Zstackapi_bdbTouchlinkGetAllowStealingReq(
 extern zstack_ZStatusValues  Zstackapi_bdbZedAttemptRecoverNwkReq(
     uint8_t srcEntityID, zstack_bdbZedAttemptRecoverNwkRsp_t *pRsp );
 
+/**
+ * @brief       Call to send a request to the ZStack Thread without waiting
+ *              for the response.  Any request that has a blocking
+ *              Zstackapi_*() call can be sent this way, except
+ *              zstackmsg_CmdIDs_SYS_APP_MSG_REQ,
+ *              zstackmsg_CmdIDs_SYS_OTA_MSG_REQ and
+ *              zstackmsg_CmdIDs_GP_ALLOW_CHANNEL_CHANGE_REQ whose messages
+ *              carry the request inline; completion is reported with a
+ *              zstackmsg_CmdIDs_ASYNC_CNF message, in submission order, so
+ *              any number of requests can be in flight.
+ *
+ * @param       appServiceTaskId - Application Task ID
+ * @param       pReq - Pointer to the request; its pReq and pRsp structures
+ *                    must stay valid until the confirmation is received
+ * @param       pHandle - Handle reported in the confirmation, may be NULL
+ *
+ * @return      zstack_ZStatusValues, zstack_ZStatusValues_ZUnsupportedMode
+ *              for a command that cannot be sent asynchronously
+ */
+extern zstack_ZStatusValues Zstackapi_asyncReq(uint8_t appServiceTaskId,
+                                               zstack_asyncReq_t *pReq,
+                                               uint16_t *pHandle);
+
+/**
+ * @brief       Call to send several requests to the ZStack Thread with a
+ *              single message, without waiting for the responses.  Each
+ *              request is confirmed with its own zstackmsg_CmdIDs_ASYNC_CNF
+ *              message, in array order.  The same commands as for
+ *              Zstackapi_asyncReq() are excluded.
+ *
+ * @param       appServiceTaskId - Application Task ID
+ * @param       pReqs - Array of numReqs requests
+ * @param       numReqs - Number of requests in pReqs
+ * @param       pHandles - Array of numReqs handles, filled in with the handle
+ *                    reported in each confirmation, may be NULL
+ *
+ * @return      zstack_ZStatusValues, nothing is sent unless
+ *              zstack_ZStatusValues_ZSuccess is returned;
+ *              zstack_ZStatusValues_ZUnsupportedMode if any request is for
+ *              a command that cannot be sent asynchronously
+ */
+extern zstack_ZStatusValues Zstackapi_asyncBulkReq(uint8_t appServiceTaskId,
+                                                   zstack_asyncReq_t *pReqs,
+                                                   uint8_t numReqs,
+                                                   uint16_t *pHandles);
+
 /**
  * @brief       Call to free the memory used by an Indication message, messages
  *              sent asynchronously from the ZStack thread.
@@ -1990,6 +2044,25 @@ extern zstack_ZStatusValues  Zstackapi_bdbZedAttemptRecoverNwkReq(
  */
 extern bool Zstackapi_freeIndMsg(void *pMsg);
 
+/**
+ * @brief       Take an additional reference to a shared received frame, for
+ *              example to hand the payload of a
+ *              zstackmsg_CmdIDs_AF_INCOMING_MSG_IND to another task without
+ *              copying it.  Each call must be balanced by a call to
+ *              Zstackapi_frameBufRelease().
+ *
+ * @param       pFrameBuf - Pointer to the shared frame
+ */
+extern void Zstackapi_frameBufRetain(zstack_frameBuf_t *pFrameBuf);
+
+/**
+ * @brief       Drop a reference to a shared received frame.  The frame is
+ *              freed when the last reference is dropped.
+ *
+ * @param       pFrameBuf - Pointer to the shared frame
+ */
+extern void Zstackapi_frameBufRelease(zstack_frameBuf_t *pFrameBuf);
+
 #if !defined (DISABLE_GREENPOWER_BASIC_PROXY) && (ZG_BUILD_RTR_TYPE)
 
 /**
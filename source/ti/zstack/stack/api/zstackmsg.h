@@ -221,6 +221,8 @@ typedef enum
     zstackmsg_CmdIDs_GP_SEND_DEV_ANNOUNCE = 0xEA,
     zstackmsg_CmdIDs_SYS_NWK_FRAME_FWD_NOTIFICATION_IND = 0xCC,
     zstackmsg_CmdIDs_PAUSE_DEVICE_REQ = 0xEB,
+    zstackmsg_CmdIDs_ASYNC_REQ = 0xEC,
+    zstackmsg_CmdIDs_ASYNC_CNF = 0xED,
     zstackmsg_CmdIDs_RESERVED_1A = 0x1A,
     zstackmsg_CmdIDs_RESERVED_31 = 0x31,
     zstackmsg_CmdIDs_RESERVED_32 = 0x32,
@@ -3247,6 +3249,55 @@ typedef struct _zstackmsg_pauseResumeDeviceReq_t
 
 } zstackmsg_pauseResumeDeviceReq_t;
 
+/**
+ * One asynchronous request.  While it is queued to the ZStack Thread the
+ * event field holds the request's own command ID and the message is laid
+ * out like the blocking request message, so it is processed by the same
+ * handler.  The ZStack Thread then changes the event field to
+ * zstackmsg_CmdIDs_ASYNC_CNF and sends it back to the application, which
+ * must free it with Zstackapi_freeIndMsg().
+ */
+typedef struct _zstackmsg_asynccnf_t
+{
+    /** message header<br>
+     * event field must be set to @ref zstack_CmdIDs
+     */
+    zstackmsg_HDR_t hdr;
+
+    /** Request fields, at the same offset as in the blocking request */
+    void *pReq;
+
+    /** Response fields, at the same offset as in the blocking request */
+    void *pRsp;
+
+    /** Next request in the same zstackmsg_asyncReq_t */
+    struct _zstackmsg_asynccnf_t *pNext;
+
+    /** Confirmation fields */
+    zstack_asyncCnf_t req;
+
+} zstackmsg_asyncCnf_t;
+
+/**
+ * Send this message to the ZStack Thread to process a batch of asynchronous
+ * requests with a single message.
+ * The command ID for this message is zstackmsg_CmdIDs_ASYNC_REQ.
+ */
+typedef struct _zstackmsg_asyncreq_t
+{
+    /** message header<br>
+     * event field must be set to @ref zstack_CmdIDs
+     */
+    zstackmsg_HDR_t hdr;
+
+    /** Number of requests in the batch */
+    uint8_t numReqs;
+
+    /** First request of the batch */
+    zstackmsg_asyncCnf_t *pFirst;
+
+} zstackmsg_asyncReq_t;
+
 //*****************************************************************************
 //*****************************************************************************
 
@@ -200,6 +200,9 @@ uint8_t maxSupportedEndpoints = MAX_SUPPORTED_ENDPOINTS;
 uint8_t zspbPermitJoin = TRUE;
 uint8_t nwkUseMultiCast = FALSE;
 
+// AF incoming message delivery statistics
+zstackAfIndStats_t zstackAfIndStats;
+
 /* ------------------------------------------------------------------------------------------------
  * Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -247,7 +250,7 @@ static void sendMsgToAllCBMsgs( uint32_t cbMask, uint16_t srcAddr, void *pBuf, p
 static void zsProcessZDOMsgs( zdoIncomingMsg_t *inMsg );
 
 static void processAfDataConfirm( afDataConfirm_t *pkt );
-static void processAfIncomingMsgInd( afIncomingMSGPacket_t *pkt );
+static bool processAfIncomingMsgInd( afIncomingMSGPacket_t *pkt );
 static void processAfReflectErrorInd( afReflectError_t *pkt );
 
 static uint8_t epTableAddNewEntry( epItem_t *newEntry );
@@ -634,6 +637,7 @@ static bool processGpAllowChannelChangeReq(uint8_t srcServiceTaskId, void *pMsg)
 static bool isDevicePartOfNetwork( void );
 static bool processGetZCLFrameCounterReq( uint8_t srcServiceTaskId, void *pMsg );
 static bool processPauseResumeDeviceReq(uint8_t srcServiceTaskId, void *pMsg);
+static bool processAsyncReq( uint8_t srcServiceTaskId, void *pMsg );
 
 #endif // ZNP_NPI
 
@@ -755,6 +759,7 @@ uint32_t ZStackTaskProcessEvent( uint8_t taskId, uint32_t events )
     if ( ( pMsg = (zstackmsg_sysResetReq_t *)OsalPort_msgReceive( ZStackServiceTaskId ) ) != NULL )
     {
       bool send = FALSE;
+      bool retain = FALSE;
 
       switch ( pMsg->hdr.event )
       {
@@ -789,7 +794,7 @@ uint32_t ZStackTaskProcessEvent( uint8_t taskId, uint32_t events )
           break;
 
         case AF_INCOMING_MSG_CMD:
-          processAfIncomingMsgInd( (afIncomingMSGPacket_t *)pMsg );
+          retain = processAfIncomingMsgInd( (afIncomingMSGPacket_t *)pMsg );
           break;
 
         case ZDO_STATE_CHANGE:
@@ -842,7 +847,7 @@ uint32_t ZStackTaskProcessEvent( uint8_t taskId, uint32_t events )
            request has been processed */
         OsalPort_msgSend( pMsg->hdr.srcServiceTask, (uint8_t*) pMsg );
       }
-      else
+      else if ( !retain )
       {
         // Release the memory
         OsalPort_msgDeallocate( (uint8_t *)pMsg );
@@ -1606,6 +1611,9 @@ static bool appMsg( uint8_t* pMsg )
     case zstackmsg_CmdIDs_PAUSE_DEVICE_REQ:
       resend = processPauseResumeDeviceReq( srcServiceTaskId, pMsg );
     break;
+    case zstackmsg_CmdIDs_ASYNC_REQ:
+      resend = processAsyncReq( srcServiceTaskId, pMsg );
+    break;
     default:
       pReq->hdr.status = zstack_ZStatusValues_ZUnsupportedMode;
       break;
@@ -1730,20 +1738,34 @@ static void processAfReflectErrorInd( afReflectError_t *pkt )
  *          any incoming data - probably from other devices.  So, based
  *          on cluster ID, perform the intended action.
  *
+ *          Unless ZSTACK_AF_IND_COPY_PAYLOAD is defined, the payload is
+ *          not copied: the indication points into pkt, which is kept
+ *          alive behind a reference-counted zstack_frameBuf_t until the
+ *          application calls Zstackapi_freeIndMsg().
+ *
  * @param   pkt - pointer to incoming packet
  *
- * @return  none
+ * @return  TRUE if pkt is now owned by the indication and must not be
+ *          freed by the caller, FALSE otherwise
  */
-static void processAfIncomingMsgInd( afIncomingMSGPacket_t *pkt )
+static bool processAfIncomingMsgInd( afIncomingMSGPacket_t *pkt )
 {
   zstackmsg_afIncomingMsgInd_t *pReq;
   epItem_t *pItem;
+  bool retained = FALSE;
+
+  pItem = epTableFindEntryEP( pkt->endPoint );
+  if ( pItem == NULL )
+  {
+    // No subscriber for this endpoint
+    return ( FALSE );
+  }
 
   pReq = (zstackmsg_afIncomingMsgInd_t *)OsalPort_msgAllocate( sizeof(zstackmsg_afIncomingMsgInd_t) );
   if ( pReq == NULL )
   {
     // Ignore the message
-    return;
+    return ( FALSE );
   }
 
   memset( pReq, 0, sizeof(zstackmsg_afIncomingMsgInd_t) );
@@ -1780,28 +1802,46 @@ static void processAfIncomingMsgInd( afIncomingMSGPacket_t *pkt )
   pReq->req.macSrcAddr = pkt->macSrcAddr;
   pReq->req.radius = pkt->radius;
   pReq->req.n_payload = pkt->cmd.DataLength;
-  pReq->req.pPayload = OsalPort_malloc( pkt->cmd.DataLength );
-  if ( pReq->req.pPayload != NULL)
-  {
-    OsalPort_memcpy( pReq->req.pPayload, pkt->cmd.Data, pkt->cmd.DataLength );
 
-    pItem = epTableFindEntryEP( pkt->endPoint );
-    if ( pItem )
+  if ( pkt->cmd.DataLength )
+  {
+#if defined ( ZSTACK_AF_IND_COPY_PAYLOAD )
+    pReq->req.pPayload = OsalPort_malloc( pkt->cmd.DataLength );
+    if ( pReq->req.pPayload == NULL )
     {
-      // Send to a subscriber
-      OsalPort_msgSend( pItem->connection,
-            (uint8_t*)pReq );
+      OsalPort_msgDeallocate( (uint8_t*)pReq );
+      return ( FALSE );
     }
-    else
+    OsalPort_memcpy( pReq->req.pPayload, pkt->cmd.Data, pkt->cmd.DataLength );
+    zstackAfIndStats.bytesCopied += pkt->cmd.DataLength;
+#else
+    zstack_frameBuf_t *pFrameBuf;
+
+    pFrameBuf = (zstack_frameBuf_t *)OsalPort_malloc( sizeof(zstack_frameBuf_t) );
+    if ( pFrameBuf == NULL )
     {
-      OsalPort_free(pReq->req.pPayload);
-      OsalPort_msgDeallocate((uint8_t*)pReq);
+      OsalPort_msgDeallocate( (uint8_t*)pReq );
+      return ( FALSE );
     }
+    pFrameBuf->refCount = 1;
+    pFrameBuf->pFrame = pkt;
+
+    // Hand the received frame itself to the subscriber
+    pReq->req.pFrameBuf = pFrameBuf;
+    pReq->req.pPayload = pkt->cmd.Data;
+    retained = TRUE;
+#endif
   }
-  else
-  {
-    // TODO: handle malloc error
-  }
+
+  // afBuildMSGIncoming() has already copied the payload out of the APS frame
+  zstackAfIndStats.framesDelivered++;
+  zstackAfIndStats.payloadBytes += pkt->cmd.DataLength;
+  zstackAfIndStats.bytesCopied += pkt->cmd.DataLength;
+
+  // Send to a subscriber
+  OsalPort_msgSend( pItem->connection, (uint8_t*)pReq );
+
+  return ( retained );
 }
 
 
@@ -10398,6 +10438,57 @@ static bool processPauseResumeDeviceReq(uint8_t srcServiceTaskId, void *pMsg)
     return (TRUE);
 }
 
+/**************************************************************************************************
+ * @fn          processAsyncReq
+ *
+ * @brief       Process a batch of asynchronous requests.  Each request is
+ *              handled exactly like its blocking counterpart, then sent back
+ *              to the source task as a zstackmsg_CmdIDs_ASYNC_CNF.
+ *
+ * @param       srcServiceTaskId - Source Task ID
+ * @param       pMsg - pointer to message
+ *
+ * @return      FALSE, the batch message itself is not sent back
+ */
+static bool processAsyncReq( uint8_t srcServiceTaskId, void *pMsg )
+{
+  zstackmsg_asyncReq_t *pReq = (zstackmsg_asyncReq_t *)pMsg;
+  zstackmsg_asyncCnf_t *pEntry;
+
+  while ( pReq->pFirst != NULL )
+  {
+    pEntry = pReq->pFirst;
+    pReq->pFirst = pEntry->pNext;
+    pEntry->pNext = NULL;
+
+    // Nested batches and commands whose messages carry the request inline
+    // cannot be handled from a zstackmsg_asyncCnf_t
+    if ( (pEntry->hdr.event == zstackmsg_CmdIDs_ASYNC_REQ)
+        || (pEntry->hdr.event == zstackmsg_CmdIDs_ASYNC_CNF)
+        || (pEntry->hdr.event == zstackmsg_CmdIDs_SYS_APP_MSG_REQ)
+        || (pEntry->hdr.event == zstackmsg_CmdIDs_SYS_OTA_MSG_REQ)
+        || (pEntry->hdr.event == zstackmsg_CmdIDs_GP_ALLOW_CHANNEL_CHANGE_REQ) )
+    {
+      pEntry->hdr.status = zstack_ZStatusValues_ZUnsupportedMode;
+    }
+    else
+    {
+      pEntry->hdr.srcServiceTask = srcServiceTaskId;
+      (void)appMsg( (uint8_t *)pEntry );
+    }
+
+    pEntry->req.status = (zstack_ZStatusValues)pEntry->hdr.status;
+    pEntry->hdr.event = zstackmsg_CmdIDs_ASYNC_CNF;
+
+    if ( OsalPort_msgSend( srcServiceTaskId, (uint8_t *)pEntry ) != OsalPort_SUCCESS )
+    {
+      OsalPort_msgDeallocate( (uint8_t *)pEntry );
+    }
+  }
+
+  return ( FALSE );
+}
+
 #endif // ZNP_NPI
 
 uint8_t ZStackTask_getServiceTaskID(void)
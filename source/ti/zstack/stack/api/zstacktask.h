@@ -42,6 +42,20 @@ extern "C"
 {
 #endif
 
+/*
+ * AF incoming message delivery statistics.  bytesCopied counts every copy
+ * of the payload made between the APS frame and the application task, so
+ * bytesCopied / payloadBytes is the number of copies per delivered frame.
+ */
+typedef struct
+{
+  uint32_t framesDelivered;
+  uint32_t payloadBytes;
+  uint32_t bytesCopied;
+} zstackAfIndStats_t;
+
+extern zstackAfIndStats_t zstackAfIndStats;
+
 extern void ZStackTaskInit( uint8_t taskId );
 extern uint32_t ZStackTaskProcessEvent( uint8_t taskId, uint32_t events );
 
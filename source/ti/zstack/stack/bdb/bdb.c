@@ -235,6 +235,7 @@ static uint16_t bdb_crcReflect (uint16_t crc, uint16_t bitnum);
 static uint16_t bdb_crcBitByBitFast(uint8_t * p, uint32_t len, uint16_t crcinit_direct, uint16_t crcinit_nondirect);
 #if (ZG_BUILD_JOINING_TYPE)
 static void bdb_ProcessNodeDescRsp(zdoIncomingMsg_t *pMsg);
+static uint8_t bdb_beaconFilter(macMlmeBeaconNotifyInd_t *pBeacon);
 #endif
 
 /*********************************************************************
@@ -1297,6 +1298,8 @@ void bdb_reportCommissioningState(uint8_t bdbCommissioningState,bool didSuccess)
           //Prepare for the next state or commissioning mode to be excecuted
           OsalPortTimers_startTimer(bdb_TaskID,BDB_CHANGE_COMMISSIONING_STATE,50);
 
+          ZMacSetBeaconFilter(NULL);
+
           if(didSuccess)
           {
             //Next state is TC link key exchange
@@ -1854,6 +1857,7 @@ void bdb_nwkDiscoveryAttempt(bool didSuccess)
       vDoPrimaryScan = FALSE;
       bdb_setChannel(bdbAttributes.bdbSecondaryChannelSet);
 
+      ZMacSetBeaconFilter(bdb_beaconFilter);
       ZDApp_NetworkInit( 50 );
     }
     else
@@ -1863,6 +1867,84 @@ void bdb_nwkDiscoveryAttempt(bool didSuccess)
   }
 }
 
+ /*********************************************************************
+ * @fn          bdb_beaconFilter
+ *
+ * @brief       Beacon filter installed in ZMAC during network steering.
+ *              Applies the checks of bdb_filterNwkDisc to the beacon in
+ *              place, so beacons of networks that would be removed from
+ *              the discovery list are never queued to NWK.
+ *
+ * @param       pBeacon - MAC beacon notify indication
+ *
+ * @return      TRUE to keep the beacon, FALSE to drop it
+ */
+static uint8_t bdb_beaconFilter(macMlmeBeaconNotifyInd_t *pBeacon)
+{
+  macBeaconData_t *pBeaconData = &pBeacon->info.beaconData;
+  macPanDesc_t *pPanDesc = pBeaconData->pPanDesc;
+  beaconPayload_t beacon;
+
+  // Not a Zigbee beacon
+  if ( ( pPanDesc == NULL ) || ( pBeaconData->pSdu == NULL ) ||
+       ( pBeaconData->sduLength < ( 3 + Z_EXTADDR_LEN ) ) || ( pBeaconData->pSdu[0] != 0 ) )
+  {
+    return FALSE;
+  }
+
+  nwk_BeaconFromNative( pBeaconData->pSdu, pBeaconData->sduLength, &beacon );
+
+  if ( nwk_ExtPANIDValid( ZDO_UseExtendedPANID ) == true )
+  {
+    if ( osal_ExtAddrEqual( ZDO_UseExtendedPANID, beacon.extendedPANID ) == false )
+    {
+      return FALSE;
+    }
+  }
+  else if ( zgConfigPANID != 0xFFFF )
+  {
+    if ( pPanDesc->coordPanId != zgConfigPANID )
+    {
+      return FALSE;
+    }
+  }
+
+  if ( ( pPanDesc->coordAddress.addrMode != SADDR_MODE_SHORT ) ||
+       ( pPanDesc->coordAddress.addr.shortAddr != _NIB.nwkCoordAddress ) ||
+       ( _NIB.nwkCoordAddress == INVALID_NODE_ADDR ) )
+  {
+    // check that network is allowing joining
+    if ( ZSTACK_ROUTER_BUILD )
+    {
+      if ( !beacon.routerCapacity )
+      {
+        return FALSE;
+      }
+    }
+    else if ( ZSTACK_END_DEVICE_BUILD )
+    {
+      if ( !beacon.deviceCapacity )
+      {
+        return FALSE;
+      }
+    }
+  }
+
+  // check version of zigbee protocol
+  if ( beacon.protocolVersion != _NIB.nwkProtocolVersion )
+  {
+    return FALSE;
+  }
+
+  // check version of stack profile, only matching profiles are supported
+  if ( beacon.stackProfile != zgStackProfile )
+  {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
  /*********************************************************************
  * @fn          bdb_filterNwkDisc
  *
@@ -2198,6 +2280,13 @@ void bdb_nwkJoiningFormation(bool isJoining)
 
   if(vScanChannels)
   {
+#if (ZG_BUILD_JOINING_TYPE)
+    if(isJoining && ZG_DEVICE_JOINING_TYPE)
+    {
+      //Drop beacons from networks we cannot join before they reach NWK
+      ZMacSetBeaconFilter(bdb_beaconFilter);
+    }
+#endif
     if(ZG_DEVICE_RTRONLY_TYPE)
     {
       if(isJoining)
@@ -2741,6 +2830,14 @@ uint32_t bdb_event_loop(byte task_id, uint32_t events)
     return (events ^ BDB_REPORT_TIMEOUT);
   }
 
+  if(events &  BDB_REPORT_COALESCE_TIMEOUT){
+#ifdef BDB_REPORTING
+    bdb_RepProcessCoalesceEvent();
+#endif
+    // Return unprocessed events
+    return (events ^ BDB_REPORT_COALESCE_TIMEOUT);
+  }
+
 #if (ZG_BUILD_JOINING_TYPE)
   if(events & BDB_TC_LINK_KEY_EXCHANGE_FAIL)
   {
@@ -3177,6 +3274,9 @@ void bdb_ProcessOSALMsg( bdbInMsg_t *msgPtr )
         switch(msgPtr->buf[0])
         {
           case BDB_JOIN_EVENT_NWK_DISCOVERY:
+            //Discovery is over, later scans (rejoin) see every beacon
+            ZMacSetBeaconFilter(NULL);
+
             if(msgPtr->hdr.status == BDB_MSG_EVENT_SUCCESS)
             {
               bdb_filterNwkDisc();
@@ -372,6 +372,7 @@ struct bdb_joiningDeviceList_node*  nextDev;
 #define BDB_TC_LINK_KEY_EXCHANGE_FAIL             0x0002
 #define BDB_CHANGE_COMMISSIONING_STATE            0x0004
 #define BDB_REPORT_TIMEOUT                        0x0080
+#define BDB_REPORT_COALESCE_TIMEOUT               0x0100
 #define BDB_FINDING_AND_BINDING_PERIOD_TIMEOUT    0x0040
 #define BDB_TC_JOIN_TIMEOUT                       0x0800
 #define BDB_PROCESS_TIMEOUT                       0x1000
@@ -225,6 +225,14 @@ extern "C"
 
 //Define the DISABLE_DEFAULT_RSP flag for reporting attributes
 #define BDB_REPORTING_DISABLE_DEFAULT_RSP  FALSE
+
+//Your JOB: Set this value according to your application
+//Time in milliseconds during which the reportable change triggers of the
+//same cluster-endpoint are merged into a single Report Attributes command
+//(50-500 ms recommended), 0 sends the report as soon as the change is detected
+#ifndef BDBREPORTING_COALESCE_WINDOW
+#define BDBREPORTING_COALESCE_WINDOW       100
+#endif
 #endif
 
 /*********************************************************************
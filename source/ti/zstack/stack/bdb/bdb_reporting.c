@@ -68,7 +68,28 @@
  * CONSTANTS
  */
 #define BDBREPORTING_HASBINDING_FLAG_MASK      0x01
-#define BDBREPORTING_NONEXTINCREMENT_FLAG_MASK 0x02
+#define BDBREPORTING_PENDING_FLAG_MASK         0x02
+
+//ZCL header length of a Report Attributes command, without and with manufacturer code
+#define BDBREPORTING_ZCL_HDR_LEN               3
+#define BDBREPORTING_ZCL_MANU_HDR_LEN          5
+
+//Hierarchical timing wheel used to schedule the max interval reports. Level n
+//has BDBREPORTING_WHEEL_SLOTS slots of BDBREPORTING_WHEEL_SLOTS^n seconds each,
+//enough levels are kept to cover the whole 32 bits reporting clock
+#define BDBREPORTING_WHEEL_SLOT_BITS           4
+#define BDBREPORTING_WHEEL_SLOTS               ( 1 << BDBREPORTING_WHEEL_SLOT_BITS )
+#define BDBREPORTING_WHEEL_SLOT_MASK           ( BDBREPORTING_WHEEL_SLOTS - 1 )
+#define BDBREPORTING_WHEEL_LEVELS              ( 32 / BDBREPORTING_WHEEL_SLOT_BITS )
+//Slot holding the entries whose max interval has already expired
+#define BDBREPORTING_WHEEL_EXPIRED             ( BDBREPORTING_WHEEL_LEVELS * BDBREPORTING_WHEEL_SLOTS )
+//Entry is not in the wheel (no binding or no periodic reporting)
+#define BDBREPORTING_WHEEL_NOSLOT              0xFF
+
+//Number of hash buckets of the cluster-endpoint table and the attr cfg records table,
+//must be powers of 2
+#define BDBREPORTING_CLUSTERENDPOINT_HASH_SIZE 8
+#define BDBREPORTING_ATTRCFG_HASH_SIZE         16
 
 
 #if BDBREPORTING_MAX_ANALOG_ATTR_SIZE == 8
@@ -145,7 +166,12 @@ typedef struct
   uint16_t  manuCode;         //add by luoyiming, 2019-10-21
   uint16_t  consolidatedMinReportInt;             // attribute ID
   uint16_t  consolidatedMaxReportInt;           // attribute data type
-  uint16_t  timeSinceLastReport;
+  uint32_t  lastReportTime;   // reporting clock value of the last report
+  uint32_t  nextReportTime;   // reporting clock value when the max interval expires
+  uint8_t   wheelSlot;        // timing wheel slot holding this entry
+  uint8_t   wheelNext;        // next entry in the same timing wheel slot
+  uint8_t   wheelPrev;        // previous entry in the same timing wheel slot
+  uint8_t   hashNext;         // next entry in the same cluster-endpoint hash bucket
   bdbAttrLinkedListAttr_t attrLinkedList;
 } bdbReportAttrClusterEndpoint_t;
 
@@ -200,6 +226,7 @@ uint8_t gAttrDataValue[BDBREPORTING_MAX_ANALOG_ATTR_SIZE];
 bool (*pBdb_SendReportCmdCallback)( uint8_t srcEP, afAddrType_t *dstAddr, uint16_t clusterID,
                                     zclReportCmd_t *reportCmd, uint8_t direction, uint8_t disableDefaultRsp,
                                     uint16_t manuCode, uint8_t seqNum ) = NULL;
+bdbRepCoalesceCounters_t bdb_reportingCoalesceCounters = { 0, 0 };
 
 /*********************************************************************
  * EXTERNAL VARIABLES
@@ -217,6 +244,19 @@ bool (*pBdb_SendReportCmdCallback)( uint8_t srcEP, afAddrType_t *dstAddr, uint16
 bdbReportAttrClusterEndpoint_t bdb_reportingClusterEndpointArray[BDB_MAX_CLUSTERENDPOINTS_REPORTING];
 //Current size of the cluster-endpoint table
 uint8_t bdb_reportingClusterEndpointArrayCount;
+//Hash buckets of the cluster-endpoint table, keyed by (endpoint,cluster,manuCode,direction)
+uint8_t bdb_reportingClusterEndpointHashHead[BDBREPORTING_CLUSTERENDPOINT_HASH_SIZE];
+//Cluster-endpoint entries with a reportable change waiting for the coalescing window to expire
+uint8_t bdb_reportingPendingList[BDB_MAX_CLUSTERENDPOINTS_REPORTING];
+uint8_t bdb_reportingPendingCount;
+//Reporting clock in seconds, it holds the value at which the current timer was started
+uint32_t bdb_reportingClock;
+//Timing wheel slots with the cluster-endpoint entries waiting for their max interval
+uint8_t bdb_reportingWheelHead[BDBREPORTING_WHEEL_EXPIRED + 1];
+//One bit per non empty slot for each level of the timing wheel
+uint16_t bdb_reportingWheelBitmap[BDBREPORTING_WHEEL_LEVELS];
+//Reporting clock value the timing wheel was last advanced to
+uint32_t bdb_reportingWheelTime;
 //This variable has the timeout value of the currrent timer use to report peridically
 uint16_t bdb_reportingNextEventTimeout;
 //This variable hasthe index of the cluster-endpoint entry that trigger the current
@@ -228,6 +268,10 @@ bdbReportAttrCfgData_t* bdb_reportingAttrCfgRecordsArray;
 uint8_t bdb_reportingAttrCfgRecordsArrayCount;
 //Max size of the attribute reporting configurations table
 uint8_t bdb_reportingAttrCfgRecordsArrayMaxSize;
+//Hash buckets of the attribute reporting configurations table
+uint8_t bdb_reportingAttrCfgRecordsHashHead[BDBREPORTING_ATTRCFG_HASH_SIZE];
+//Next record in the same hash bucket, one per attribute reporting configuration (dynamic table)
+uint8_t* bdb_reportingAttrCfgRecordsHashNext;
 //Linked list for holding the default attribute reporting configurations
 //enteres by the application
 bdbRepAttrDefaultCfgRecordLinkedList_t attrDefaultCfgRecordLinkedList;
@@ -255,16 +299,23 @@ static bdbLinkedListAttrItem_t* bdb_linkedListAttrGetAtIndex( bdbAttrLinkedListA
 
 //Begin: Cluster-endpoint array live methods
 static void bdb_clusterEndpointArrayInit( void );
-static uint8_t bdb_clusterEndpointArrayAdd( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t consolidatedMinReportInt, uint16_t consolidatedMaxReportInt, uint16_t timeSinceLastReport );
-static uint8_t bdb_clusterEndpointArrayGetMin( void );
-static void bdb_clusterEndpointArrayMoveTo( uint8_t indexSrc, uint8_t indexDest );
-static uint8_t bdb_clusterEndpointArrayUpdateAt( uint8_t index, uint16_t newTimeSinceLastReport, uint8_t markHasBinding, uint8_t noNextIncrement );
+static uint8_t bdb_clusterEndpointArrayAdd( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t consolidatedMinReportInt, uint16_t consolidatedMaxReportInt );
+static uint8_t bdb_clusterEndpointArrayUpdateAt( uint8_t index, uint8_t markHasBinding );
 static void bdb_clusterEndpointArrayFreeAll( void );
 static uint8_t bdb_clusterEndpointArraySearch( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction );
-static uint8_t bdb_clusterEndpointArrayRemoveAt( uint8_t index );
-static void bdb_clusterEndpointArrayIncrementAll( uint16_t timeSinceLastReportIncrement, uint8_t CheckNoIncrementFlag );
+static uint8_t bdb_clusterEndpointArrayHash( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction );
 //End: Cluster-endpoint array live methods
 
+//Begin: Reporting timing wheel methods
+static void bdb_repWheelInit( void );
+static void bdb_repWheelInsert( uint8_t index );
+static void bdb_repWheelRemove( uint8_t index );
+static void bdb_repWheelSchedule( uint8_t index );
+static void bdb_repWheelCascade( uint8_t slot );
+static void bdb_repWheelAdvance( uint32_t now );
+static uint8_t bdb_repWheelGetNext( uint32_t* nextReportTime );
+//End: Reporting timing wheel methods
+
 //Begin: Single linked list default attr cfg records methods
 static void bdb_repAttrDefaultCfgRecordInitValues( bdbReportAttrDefaultCfgData_t* item );
 static void bdb_repAttrDefaultCfgRecordsLinkedListInit( bdbRepAttrDefaultCfgRecordLinkedList_t *list );
@@ -283,6 +334,8 @@ static uint8_t bdb_repAttrCfgRecordsArrayAdd( uint8_t endpoint, uint16_t cluster
 static void bdb_repAttrCfgRecordsArrayFreeAll( void );
 static uint8_t bdb_repAttrCfgRecordsArraySearch( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t attrID ); //add manuCode, fixed by luoyiming 2019-10-20
 static uint8_t bdb_repAttrCfgRecordsArrayConsolidateValues( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t* consolidatedMinReportInt, uint16_t* consolidatedMaxReportInt );
+static uint8_t bdb_repAttrCfgRecordsArrayHash( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t attrID );
+static void bdb_repAttrCfgRecordsArrayIndex( void );
 //End: Reporting attr configuration array methods
 
 
@@ -295,12 +348,16 @@ static uint8_t bdb_RepFindAttrEntry( uint8_t endpoint, uint16_t cluster, uint16_
 static uint8_t bdb_RepLoadCfgRecords( void );
 static uint8_t bdb_isAttrValueChangedSurpassDelta( uint8_t datatype, uint8_t* delta, uint8_t* curValue, uint8_t* lastValue );
 static uint16_t bdb_RepCalculateEventElapsedTime( uint32_t remainingTimeoutTimer, uint16_t nextEventTimeout );
+static uint32_t bdb_RepGetClock( void );
 static void bdb_RepRestartNextEventTimer( void );
 
 static void bdb_RepStartReporting( void );
 static void bdb_RepStopEventTimer( void );
 static void bdb_RepSetupReporting( void );
 static void bdb_RepReport( uint8_t indexClusterEndpoint );
+static void bdb_RepSendReportFrames( bdbReportAttrClusterEndpoint_t* clusterEndpointItem, afAddrType_t* dstAddr, zclReportCmd_t* pReportCmd );
+static void bdb_RepQueueCoalescedReport( uint8_t index );
+static void bdb_RepCancelCoalescedReport( uint8_t index );
 
 extern zclAttrRecsList *zclFindAttrRecsList( uint8_t endpoint ); //Definition is located in zcl.h
 
@@ -320,6 +377,7 @@ extern zclAttrRecsList *zclFindAttrRecsList( uint8_t endpoint ); //Definition is
 void bdb_RepInit( void )
 {
   bdb_reportingNextEventTimeout = 0;
+  bdb_reportingClock = 0;
   bdb_reportingAcceptDefaultConfs = BDBREPORTING_TRUE;
   bdb_repAttrCfgRecordsArrayInit( );
   bdb_repAttrDefaultCfgRecordsLinkedListInit( &attrDefaultCfgRecordLinkedList );
@@ -359,6 +417,9 @@ void bdb_RepConstructReportingData( void )
  * @param       cluster - cluster id of the entry to locate
  * @param       manuCode - manuCode of the entry to locate, add by luoyiming 2020-01-07
  * @param       direction - direction of the entry to locate, add by luoyiming 2020-01-07
+ * @param       unMark - BDBREPORTING_TRUE to clear the binding flag
+ * @param       setNoNextIncrementFlag - not used, the time since the last
+ *              report is taken from the reporting clock at the time of the call
  *
  * @return      none
  */
@@ -373,11 +434,11 @@ void bdb_RepMarkHasBindingInEndpointClusterArray( uint8_t endpoint, uint16_t clu
     {
       if( unMark == BDBREPORTING_TRUE )
       {
-        bdb_clusterEndpointArrayUpdateAt( foundIndex, 0, BDBREPORTING_FALSE, setNoNextIncrementFlag );
+        bdb_clusterEndpointArrayUpdateAt( foundIndex, BDBREPORTING_FALSE );
       }
       else
       {
-        bdb_clusterEndpointArrayUpdateAt( foundIndex, 0, BDBREPORTING_TRUE, setNoNextIncrementFlag );
+        bdb_clusterEndpointArrayUpdateAt( foundIndex, BDBREPORTING_TRUE );
       }
     }
   }
@@ -398,8 +459,7 @@ static void bdb_RepStartReporting( void )
   if( !OsalPortTimers_getTimerTimeout( bdb_TaskID, BDB_REPORT_TIMEOUT ) )
   {
     //timerElapsedTime is zero
-    OsalPortTimers_stopTimer( bdb_TaskID, BDB_REPORT_TIMEOUT );
-    bdb_reportingNextEventTimeout = 0;
+    bdb_RepStopEventTimer( );
     bdb_reportingNextClusterEndpointIndex = BDBREPORTING_INVALIDINDEX;
     //Start Timer
     bdb_RepRestartNextEventTimer( );
@@ -410,9 +470,8 @@ static void bdb_RepStartReporting( void )
  * @fn          bdb_RepStartOrContinueReporting
  *
  * @brief       Restarts the periodic reporting timer, if the timer was already
- *              running it calculates the remaining time of timer before stopping it,
- *              then sustracts this elapsed time from the next event endpoint-cluster
- *              table.
+ *              running the time it already consumed is added to the reporting
+ *              clock before stopping it.
  *
  * @return      none
  */
@@ -427,10 +486,7 @@ void bdb_RepStartOrContinueReporting( void )
   }
   else
   {
-    uint16_t elapsedTime = bdb_RepCalculateEventElapsedTime( remainingTimeOfEvent, bdb_reportingNextEventTimeout );
     bdb_RepStopEventTimer( );
-
-    bdb_clusterEndpointArrayIncrementAll( elapsedTime, BDBREPORTING_TRUE );
     bdb_RepStartReporting( );
   }
 
@@ -461,35 +517,66 @@ static uint16_t bdb_RepCalculateEventElapsedTime( uint32_t remainingTimeoutTimer
  * @fn          bdb_RepProcessEvent
  *
  * @brief       Method that process the timer expired event in the reporting
- *              code, it calculate the next cluster-endpoint entry based
- *              on the minimum with consolidatedMaxReportInt - timeSinceLastReport,
- *              updates timeSinceLastReport of all entries. If the minimum is zero,
- *              report the cluster-endpoint attrs.
+ *              code, it advances the reporting clock and the timing wheel,
+ *              reports the cluster-endpoint entries whose max interval expired
+ *              and restarts the timer for the next entry in the wheel.
  *
  * @return      none
  */
 void bdb_RepProcessEvent( void )
 {
-  bdb_clusterEndpointArrayIncrementAll( bdb_reportingNextEventTimeout, BDBREPORTING_FALSE );
-  uint8_t minIndex =  bdb_clusterEndpointArrayGetMin( );
-  if( minIndex == BDBREPORTING_INVALIDINDEX )
+  uint32_t nextReportTime;
+  uint8_t index;
+
+  //Add the expired timeout to the reporting clock
+  bdb_RepStopEventTimer( );
+  bdb_repWheelAdvance( bdb_reportingClock );
+
+  while( bdb_reportingWheelHead[BDBREPORTING_WHEEL_EXPIRED] != BDBREPORTING_INVALIDINDEX )
+  {
+    //Something was triggered, report clusterEndpoint, this reschedules it out of the expired slot
+    index = bdb_reportingWheelHead[BDBREPORTING_WHEEL_EXPIRED];
+    bdb_reportingNextClusterEndpointIndex = index;
+    //A pending reportable change goes out with this report
+    bdb_RepCancelCoalescedReport( index );
+    bdb_RepReport( BDBREPORTING_INVALIDINDEX );
+    bdb_clusterEndpointArrayUpdateAt( index, BDBREPORTING_IGNORE );
+  }
+
+  if( bdb_repWheelGetNext( &nextReportTime ) == BDBREPORTING_FALSE )
   {
     return;
   }
-   uint16_t minVal = bdb_reportingClusterEndpointArray[minIndex].consolidatedMaxReportInt - bdb_reportingClusterEndpointArray[minIndex].timeSinceLastReport;
-   if( minVal>0 )
-   {
-     bdb_reportingNextEventTimeout = minVal;
-   }
-   else
-   {
-     //Something was triggered, report clusterEndpoint with minIndex
-     bdb_reportingNextClusterEndpointIndex = minIndex;
-     bdb_RepReport( BDBREPORTING_INVALIDINDEX );
-     bdb_clusterEndpointArrayUpdateAt( minIndex, 0, BDBREPORTING_IGNORE, BDBREPORTING_IGNORE );
-     bdb_reportingNextEventTimeout = 0;
-   }
-   bdb_RepRestartNextEventTimer( );
+  bdb_reportingNextEventTimeout = (uint16_t)( nextReportTime - bdb_reportingClock );
+  bdb_RepRestartNextEventTimer( );
+}
+
+ /*********************************************************************
+ * @fn          bdb_RepProcessCoalesceEvent
+ *
+ * @brief       Method that process the coalescing window expired event, it
+ *              sends one report for each cluster-endpoint entry with pending
+ *              reportable changes and restarts the periodic reporting.
+ *
+ * @return      none
+ */
+void bdb_RepProcessCoalesceEvent( void )
+{
+  uint8_t index;
+
+  if( bdb_reportingPendingCount == 0 )
+  {
+    return;
+  }
+  bdb_RepStopEventTimer( );
+  while( bdb_reportingPendingCount > 0 )
+  {
+    index = bdb_reportingPendingList[--bdb_reportingPendingCount];
+    FLAGS_TURNOFFFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_PENDING_FLAG_MASK );
+    bdb_RepReport( index );
+    bdb_clusterEndpointArrayUpdateAt( index, BDBREPORTING_IGNORE ); //return time since last report to zero
+  }
+  bdb_RepStartReporting( );
 }
 
 /*********************************************************************
@@ -822,7 +909,7 @@ void bdb_RepUpdateMarkBindings( void )
     if( numMarkedEntries == 0 ) //No entries
     {
       //Stop Timer
-      OsalPortTimers_stopTimer( bdb_TaskID, BDB_REPORT_TIMEOUT );
+      bdb_RepStopEventTimer( );
     }
   }
   else
@@ -1030,114 +1117,106 @@ static bdbLinkedListAttrItem_t* bdb_linkedListAttrGetAtIndex( bdbAttrLinkedListA
 /*********************************************************************
  * @fn      bdb_clusterEndpointArrayInit
  *
- * @brief   Initiates the clusterEndpoint array variables
+ * @brief   Initiates the clusterEndpoint array variables, its hash index
+ *          and the reporting timing wheel
  *
  * @return
  */
 static void bdb_clusterEndpointArrayInit( void )
 {
+  uint8_t i;
   bdb_reportingClusterEndpointArrayCount = 0;
+  bdb_reportingPendingCount = 0;
+  for( i=0; i<BDBREPORTING_CLUSTERENDPOINT_HASH_SIZE; i++ )
+  {
+    bdb_reportingClusterEndpointHashHead[i] = BDBREPORTING_INVALIDINDEX;
+  }
+  bdb_repWheelInit( );
+}
+
+/*********************************************************************
+ * @fn      bdb_clusterEndpointArrayHash
+ *
+ * @brief   Get the hash bucket of a clusterEndpoint entry
+ *
+ * @param   endpoint - Endpoint ID of the entry
+ * @param   cluster - Cluster ID of the entry
+ * @param   manuCode - manufacture Code of the entry
+ * @param   direction - direction of the entry
+ *
+ * @return  hash bucket index
+ */
+static uint8_t bdb_clusterEndpointArrayHash( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction )
+{
+  uint8_t hash = endpoint ^ (uint8_t)cluster ^ (uint8_t)( cluster >> 8 ) ^
+                 (uint8_t)manuCode ^ (uint8_t)( manuCode >> 8 ) ^ ( direction << 2 );
+  return ( hash & ( BDBREPORTING_CLUSTERENDPOINT_HASH_SIZE - 1 ) );
 }
 
 /*********************************************************************
  * @fn      bdb_clusterEndpointArrayAdd
  *
- * @brief   Adds a new entry to the clusterEndpoint array
+ * @brief   Adds a new entry to the clusterEndpoint array, the time of the
+ *          last report is the current reporting clock
  *
  * @param   endpoint - Endpoint ID of the entry
  * @param   cluster - Cluster ID of the entry
  * @param   manuCode - manufacture Code of the entry, added by luoyiming 2019-10-21
- * @param   consolidatedMinReportInterval - Cluster ID of the entry
-
+ * @param   direction - direction of the entry
+ * @param   consolidatedMinReportInt - consolidated min report interval of the entry
+ * @param   consolidatedMaxReportInt - consolidated max report interval of the entry
  *
- * @return  A pointer to the ith node element
+ * @return  BDBREPORTING_SUCCESS, BDBREPORTING_ERROR if the array is full
  */
-static uint8_t bdb_clusterEndpointArrayAdd( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t consolidatedMinReportInt, uint16_t consolidatedMaxReportInt, uint16_t timeSinceLastReport )
+static uint8_t bdb_clusterEndpointArrayAdd( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t consolidatedMinReportInt, uint16_t consolidatedMaxReportInt )
 {
+  bdbReportAttrClusterEndpoint_t* entry;
+  uint8_t hash;
+
   if( bdb_reportingClusterEndpointArrayCount>=BDB_MAX_CLUSTERENDPOINTS_REPORTING )
   {
     return BDBREPORTING_ERROR;
   }
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].endpoint = endpoint;
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].cluster = cluster;
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].manuCode = manuCode;  //fixed by luoyiming 2019-10-21
-
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].consolidatedMinReportInt = consolidatedMinReportInt;
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].consolidatedMaxReportInt = consolidatedMaxReportInt;
-  bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].timeSinceLastReport = timeSinceLastReport;
-  bdb_linkedListAttrInit( &bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].attrLinkedList );
-  FLAGS_TURNOFFALLFLAGS( bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount].flags );
+  entry = &bdb_reportingClusterEndpointArray[bdb_reportingClusterEndpointArrayCount];
+  entry->endpoint = endpoint;
+  entry->cluster = cluster;
+  entry->manuCode = manuCode;  //fixed by luoyiming 2019-10-21
+  entry->direction = direction;
 
-  bdb_reportingClusterEndpointArrayCount++;
-  return BDBREPORTING_SUCCESS;
-}
+  entry->consolidatedMinReportInt = consolidatedMinReportInt;
+  entry->consolidatedMaxReportInt = consolidatedMaxReportInt;
+  entry->lastReportTime = bdb_reportingClock;
+  entry->nextReportTime = 0;
+  entry->wheelSlot = BDBREPORTING_WHEEL_NOSLOT;
+  bdb_linkedListAttrInit( &entry->attrLinkedList );
+  FLAGS_TURNOFFALLFLAGS( entry->flags );
 
-static uint8_t bdb_clusterEndpointArrayGetMin( void )
-{
-  uint8_t indexMin = 0xFF;
-  uint16_t ValueMin = 0xFFFF;
-  uint16_t possibleMin;
-  uint8_t i;
-  for( i=0; i<bdb_reportingClusterEndpointArrayCount; i++ )
-  {
-    if( FLAGS_CHECKFLAG( bdb_reportingClusterEndpointArray[i].flags, BDBREPORTING_HASBINDING_FLAG_MASK ) == BDBREPORTING_TRUE )
-    { //Only do with valid entries (HasBinding==true)
-      if( bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt != BDBREPORTING_NOPERIODIC &&
-         bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt != BDBREPORTING_REPORTOFF )
-      {
-        //If maxInterval is BDBREPORTING_NOPERIODIC=0x0000 or BDBREPORTING_REPORTOFF=0xFFFF, ignore to calculate min
-        if( ValueMin == 0 )
-        {
-          //stop if we find a minValue of zero because there no other Min less than that
-          break;
-        }
-        possibleMin = bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt - bdb_reportingClusterEndpointArray[i].timeSinceLastReport;
-        if( possibleMin<ValueMin )
-        {
-          indexMin = i;
-          ValueMin = possibleMin;
-        }
-      }
-    }
-  }
-  return indexMin;
-
-}
+  hash = bdb_clusterEndpointArrayHash( endpoint, cluster, manuCode, direction );
+  entry->hashNext = bdb_reportingClusterEndpointHashHead[hash];
+  bdb_reportingClusterEndpointHashHead[hash] = bdb_reportingClusterEndpointArrayCount;
 
-static uint8_t bdb_clusterEndpointArrayRemoveAt( uint8_t index )
-{
-  if( index>=bdb_reportingClusterEndpointArrayCount )
-  {
-    return BDBREPORTING_ERROR;
-  }
-  //Freeing list, all the other fields are not dynamic
-  bdb_linkedListAttrFreeAll( &bdb_reportingClusterEndpointArray[index].attrLinkedList );
-  //moving last element to free slot
-  bdb_clusterEndpointArrayMoveTo( index, bdb_reportingClusterEndpointArrayCount-1 );
-  bdb_reportingClusterEndpointArrayCount--;
+  bdb_reportingClusterEndpointArrayCount++;
   return BDBREPORTING_SUCCESS;
 }
 
-static void bdb_clusterEndpointArrayMoveTo( uint8_t indexSrc, uint8_t indexDest )
-{
-  bdb_reportingClusterEndpointArray[indexSrc].cluster = bdb_reportingClusterEndpointArray[indexDest].cluster;
-  bdb_reportingClusterEndpointArray[indexSrc].manuCode = bdb_reportingClusterEndpointArray[indexDest].manuCode; //added by luoyiming, 2019-10-21
-  bdb_reportingClusterEndpointArray[indexSrc].endpoint = bdb_reportingClusterEndpointArray[indexDest].endpoint;
-  bdb_reportingClusterEndpointArray[indexSrc].consolidatedMaxReportInt = bdb_reportingClusterEndpointArray[indexDest].consolidatedMaxReportInt;
-  bdb_reportingClusterEndpointArray[indexSrc].consolidatedMinReportInt = bdb_reportingClusterEndpointArray[indexDest].consolidatedMinReportInt;
-  bdb_reportingClusterEndpointArray[indexSrc].timeSinceLastReport = bdb_reportingClusterEndpointArray[indexDest].timeSinceLastReport;
-  bdb_reportingClusterEndpointArray[indexSrc].attrLinkedList = bdb_reportingClusterEndpointArray[indexDest].attrLinkedList;
-  bdb_reportingClusterEndpointArray[indexSrc].flags = bdb_reportingClusterEndpointArray[indexDest].flags;
-  bdb_linkedListAttrClearList( &bdb_reportingClusterEndpointArray[indexDest].attrLinkedList );
-}
-
-static uint8_t bdb_clusterEndpointArrayUpdateAt( uint8_t index, uint16_t newTimeSinceLastReport, uint8_t markHasBinding, uint8_t markNoNextIncrement )
+/*********************************************************************
+ * @fn      bdb_clusterEndpointArrayUpdateAt
+ *
+ * @brief   Restarts the time since the last report of an entry, optionally
+ *          updates its binding flag, and reschedules it in the timing wheel
+ *
+ * @param   index - index of the entry
+ * @param   markHasBinding - BDBREPORTING_TRUE, BDBREPORTING_FALSE or BDBREPORTING_IGNORE
+ *
+ * @return  BDBREPORTING_SUCCESS, BDBREPORTING_ERROR if index is invalid
+ */
+static uint8_t bdb_clusterEndpointArrayUpdateAt( uint8_t index, uint8_t markHasBinding )
 {
   if( index >= bdb_reportingClusterEndpointArrayCount )
   {
     return BDBREPORTING_ERROR;
   }
-  bdb_reportingClusterEndpointArray[index].timeSinceLastReport = newTimeSinceLastReport;
+  bdb_reportingClusterEndpointArray[index].lastReportTime = bdb_RepGetClock( );
   if( markHasBinding != BDBREPORTING_IGNORE )
   {
     if( markHasBinding == BDBREPORTING_TRUE )
@@ -1149,87 +1228,306 @@ static uint8_t bdb_clusterEndpointArrayUpdateAt( uint8_t index, uint16_t newTime
       FLAGS_TURNOFFFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_HASBINDING_FLAG_MASK );
     }
   }
-  if( markNoNextIncrement != BDBREPORTING_IGNORE )
-  {
-    if( markNoNextIncrement == BDBREPORTING_TRUE )
-    {
-      FLAGS_TURNONFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_NONEXTINCREMENT_FLAG_MASK );
-    }
-    else
-    {
-      FLAGS_TURNOFFFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_NONEXTINCREMENT_FLAG_MASK );
-    }
-  }
+  bdb_repWheelSchedule( index );
   return BDBREPORTING_SUCCESS;
 }
 
 static void bdb_clusterEndpointArrayFreeAll( )
 {
   uint8_t i;
-  uint8_t numElements = bdb_reportingClusterEndpointArrayCount;
-  for( i=0; i<numElements; i++ )
+  for( i=0; i<bdb_reportingClusterEndpointArrayCount; i++ )
   {
-    bdb_clusterEndpointArrayRemoveAt( 0 );
+    //Freeing list, all the other fields are not dynamic
+    bdb_linkedListAttrFreeAll( &bdb_reportingClusterEndpointArray[i].attrLinkedList );
   }
+  bdb_clusterEndpointArrayInit( );
 }
 
 static uint8_t bdb_clusterEndpointArraySearch( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction )
 {
-  uint8_t i;
-  uint8_t foundIndex = BDBREPORTING_INVALIDINDEX;
-  for( i=0; i<bdb_reportingClusterEndpointArrayCount; i++ )
+  uint8_t i = bdb_reportingClusterEndpointHashHead[bdb_clusterEndpointArrayHash( endpoint, cluster, manuCode, direction )];
+  while( i != BDBREPORTING_INVALIDINDEX )
   {
     if( bdb_reportingClusterEndpointArray[i].endpoint == endpoint && 
         bdb_reportingClusterEndpointArray[i].cluster == cluster &&
         bdb_reportingClusterEndpointArray[i].manuCode == manuCode &&  // fixed by luoyiming, 2020-01-08.
         bdb_reportingClusterEndpointArray[i].direction == direction ) // fixed by luoyiming, 2020-01-07.
     {
-      foundIndex = i;
-      break;
+      return i;
     }
+    i = bdb_reportingClusterEndpointArray[i].hashNext;
   }
-  return foundIndex;
+  return BDBREPORTING_INVALIDINDEX;
 }
 
-static void bdb_clusterEndpointArrayIncrementAll( uint16_t timeSinceLastReportIncrement, uint8_t CheckNoIncrementFlag )
+/*
+* End: Cluster-endpoint array live data methods
+*/
+
+
+/*
+* Begin: Reporting timing wheel methods
+*/
+
+/*
+* The cluster-endpoint entries with a binding and a periodic max interval are
+* kept in a hierarchical timing wheel keyed by the reporting clock value at
+* which their max interval expires. An entry is stored at the level of the
+* most significant digit (BDBREPORTING_WHEEL_SLOT_BITS wide) where its expiry
+* time differs from the wheel time, in the slot given by that digit. Advancing
+* the wheel only touches the slots the clock went over, so scheduling and
+* expiring entries does not depend on the size of the cluster-endpoint table.
+*/
+
+/*********************************************************************
+ * @fn      bdb_repWheelInit
+ *
+ * @brief   Empties the timing wheel and aligns it with the reporting clock
+ *
+ * @return
+ */
+static void bdb_repWheelInit( void )
 {
   uint8_t i;
-  uint8_t doIncrement;
-  for( i=0; i<bdb_reportingClusterEndpointArrayCount; i++ )
+  for( i=0; i<=BDBREPORTING_WHEEL_EXPIRED; i++ )
+  {
+    bdb_reportingWheelHead[i] = BDBREPORTING_INVALIDINDEX;
+  }
+  for( i=0; i<BDBREPORTING_WHEEL_LEVELS; i++ )
   {
-    doIncrement = BDBREPORTING_FALSE;
-    if( FLAGS_CHECKFLAG( bdb_reportingClusterEndpointArray[i].flags, BDBREPORTING_HASBINDING_FLAG_MASK ) == BDBREPORTING_TRUE )
+    bdb_reportingWheelBitmap[i] = 0;
+  }
+  bdb_reportingWheelTime = bdb_reportingClock;
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelInsert
+ *
+ * @brief   Links a cluster-endpoint entry in the slot matching its
+ *          nextReportTime, or in the expired slot if already due
+ *
+ * @param   index - index of the cluster-endpoint entry
+ *
+ * @return
+ */
+static void bdb_repWheelInsert( uint8_t index )
+{
+  bdbReportAttrClusterEndpoint_t* entry = &bdb_reportingClusterEndpointArray[index];
+  uint32_t diff;
+  uint8_t level = 0;
+  uint8_t slot;
+
+  if( entry->nextReportTime <= bdb_reportingWheelTime )
+  {
+    slot = BDBREPORTING_WHEEL_EXPIRED;
+  }
+  else
+  {
+    diff = ( entry->nextReportTime ^ bdb_reportingWheelTime ) >> BDBREPORTING_WHEEL_SLOT_BITS;
+    while( diff != 0 )
     {
-      //Only do with valid entries (HasBinding==true)
-      if( CheckNoIncrementFlag == BDBREPORTING_FALSE )
-      {
-        doIncrement = BDBREPORTING_TRUE;
-      }
-      else
-      {
-        if( FLAGS_CHECKFLAG( bdb_reportingClusterEndpointArray[i].flags, BDBREPORTING_NONEXTINCREMENT_FLAG_MASK ) == BDBREPORTING_FALSE )
-        {
-          doIncrement = BDBREPORTING_TRUE;
-        }
-      }
-      if( doIncrement == BDBREPORTING_TRUE )
+      diff >>= BDBREPORTING_WHEEL_SLOT_BITS;
+      level++;
+    }
+    slot = ( entry->nextReportTime >> ( level * BDBREPORTING_WHEEL_SLOT_BITS ) ) & BDBREPORTING_WHEEL_SLOT_MASK;
+    bdb_reportingWheelBitmap[level] |= ( 1 << slot );
+    slot += level * BDBREPORTING_WHEEL_SLOTS;
+  }
+
+  entry->wheelSlot = slot;
+  entry->wheelPrev = BDBREPORTING_INVALIDINDEX;
+  entry->wheelNext = bdb_reportingWheelHead[slot];
+  if( entry->wheelNext != BDBREPORTING_INVALIDINDEX )
+  {
+    bdb_reportingClusterEndpointArray[entry->wheelNext].wheelPrev = index;
+  }
+  bdb_reportingWheelHead[slot] = index;
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelRemove
+ *
+ * @brief   Unlinks a cluster-endpoint entry from the timing wheel
+ *
+ * @param   index - index of the cluster-endpoint entry
+ *
+ * @return
+ */
+static void bdb_repWheelRemove( uint8_t index )
+{
+  bdbReportAttrClusterEndpoint_t* entry = &bdb_reportingClusterEndpointArray[index];
+  uint8_t slot = entry->wheelSlot;
+
+  if( slot == BDBREPORTING_WHEEL_NOSLOT )
+  {
+    return;
+  }
+  if( entry->wheelPrev != BDBREPORTING_INVALIDINDEX )
+  {
+    bdb_reportingClusterEndpointArray[entry->wheelPrev].wheelNext = entry->wheelNext;
+  }
+  else
+  {
+    bdb_reportingWheelHead[slot] = entry->wheelNext;
+  }
+  if( entry->wheelNext != BDBREPORTING_INVALIDINDEX )
+  {
+    bdb_reportingClusterEndpointArray[entry->wheelNext].wheelPrev = entry->wheelPrev;
+  }
+  if( ( bdb_reportingWheelHead[slot] == BDBREPORTING_INVALIDINDEX ) && ( slot != BDBREPORTING_WHEEL_EXPIRED ) )
+  {
+    bdb_reportingWheelBitmap[slot >> BDBREPORTING_WHEEL_SLOT_BITS] &= ~( 1 << ( slot & BDBREPORTING_WHEEL_SLOT_MASK ) );
+  }
+  entry->wheelSlot = BDBREPORTING_WHEEL_NOSLOT;
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelSchedule
+ *
+ * @brief   Reschedules a cluster-endpoint entry after its lastReportTime,
+ *          binding flag or max interval changed. Entries without binding
+ *          or without periodic reporting are left out of the wheel.
+ *
+ * @param   index - index of the cluster-endpoint entry
+ *
+ * @return
+ */
+static void bdb_repWheelSchedule( uint8_t index )
+{
+  bdbReportAttrClusterEndpoint_t* entry = &bdb_reportingClusterEndpointArray[index];
+
+  bdb_repWheelRemove( index );
+  if( ( FLAGS_CHECKFLAG( entry->flags, BDBREPORTING_HASBINDING_FLAG_MASK ) == BDBREPORTING_TRUE ) &&
+      ( entry->consolidatedMaxReportInt != BDBREPORTING_NOPERIODIC ) &&
+      ( entry->consolidatedMaxReportInt != BDBREPORTING_REPORTOFF ) )
+  {
+    entry->nextReportTime = entry->lastReportTime + entry->consolidatedMaxReportInt;
+    bdb_repWheelInsert( index );
+  }
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelCascade
+ *
+ * @brief   Empties a slot of the timing wheel and inserts its entries
+ *          again relative to the current wheel time
+ *
+ * @param   slot - slot of the timing wheel
+ *
+ * @return
+ */
+static void bdb_repWheelCascade( uint8_t slot )
+{
+  uint8_t index = bdb_reportingWheelHead[slot];
+  uint8_t next;
+
+  bdb_reportingWheelHead[slot] = BDBREPORTING_INVALIDINDEX;
+  bdb_reportingWheelBitmap[slot >> BDBREPORTING_WHEEL_SLOT_BITS] &= ~( 1 << ( slot & BDBREPORTING_WHEEL_SLOT_MASK ) );
+  while( index != BDBREPORTING_INVALIDINDEX )
+  {
+    next = bdb_reportingClusterEndpointArray[index].wheelNext;
+    bdb_repWheelInsert( index );
+    index = next;
+  }
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelAdvance
+ *
+ * @brief   Moves the timing wheel time forward, entries whose max interval
+ *          expired end up in the BDBREPORTING_WHEEL_EXPIRED slot
+ *
+ * @param   now - reporting clock value to advance to
+ *
+ * @return
+ */
+static void bdb_repWheelAdvance( uint32_t now )
+{
+  uint32_t diff;
+  uint8_t level = 0;
+  uint8_t slot;
+  uint8_t lastSlot;
+  uint8_t i;
+
+  if( now <= bdb_reportingWheelTime )
+  {
+    return;
+  }
+  diff = ( now ^ bdb_reportingWheelTime ) >> BDBREPORTING_WHEEL_SLOT_BITS;
+  while( diff != 0 )
+  {
+    diff >>= BDBREPORTING_WHEEL_SLOT_BITS;
+    level++;
+  }
+  slot = ( ( bdb_reportingWheelTime >> ( level * BDBREPORTING_WHEEL_SLOT_BITS ) ) & BDBREPORTING_WHEEL_SLOT_MASK ) + 1;
+  lastSlot = ( now >> ( level * BDBREPORTING_WHEEL_SLOT_BITS ) ) & BDBREPORTING_WHEEL_SLOT_MASK;
+  bdb_reportingWheelTime = now;
+
+  //The slots of the higher levels are still valid. Every slot below the level of
+  //the most significant changed digit has expired, then the slots the clock went
+  //over at that level expire or move to a lower level
+  for( i = 0; i < level * BDBREPORTING_WHEEL_SLOTS; i++ )
+  {
+    if( bdb_reportingWheelBitmap[i >> BDBREPORTING_WHEEL_SLOT_BITS] & ( 1 << ( i & BDBREPORTING_WHEEL_SLOT_MASK ) ) )
+    {
+      bdb_repWheelCascade( i );
+    }
+  }
+  for( ; slot <= lastSlot; slot++ )
+  {
+    if( bdb_reportingWheelBitmap[level] & ( 1 << slot ) )
+    {
+      bdb_repWheelCascade( level * BDBREPORTING_WHEEL_SLOTS + slot );
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      bdb_repWheelGetNext
+ *
+ * @brief   Get the earliest nextReportTime of the entries in the timing wheel
+ *
+ * @param   nextReportTime - earliest nextReportTime found
+ *
+ * @return  BDBREPORTING_TRUE if found, BDBREPORTING_FALSE if the wheel is empty
+ */
+static uint8_t bdb_repWheelGetNext( uint32_t* nextReportTime )
+{
+  uint8_t level;
+  uint8_t slot;
+  uint8_t index;
+
+  if( bdb_reportingWheelHead[BDBREPORTING_WHEEL_EXPIRED] != BDBREPORTING_INVALIDINDEX )
+  {
+    *nextReportTime = bdb_reportingWheelTime;
+    return BDBREPORTING_TRUE;
+  }
+  for( level=0; level<BDBREPORTING_WHEEL_LEVELS; level++ )
+  {
+    if( bdb_reportingWheelBitmap[level] == 0 )
+    {
+      continue;
+    }
+    //Lowest non empty slot of the lowest non empty level holds the earliest entries,
+    //at the upper levels the slot has to be walked to find the earliest one
+    for( slot=0; ( bdb_reportingWheelBitmap[level] & ( 1 << slot ) ) == 0; slot++ );
+    index = bdb_reportingWheelHead[level * BDBREPORTING_WHEEL_SLOTS + slot];
+    *nextReportTime = bdb_reportingClusterEndpointArray[index].nextReportTime;
+    for( index = bdb_reportingClusterEndpointArray[index].wheelNext; index != BDBREPORTING_INVALIDINDEX;
+         index = bdb_reportingClusterEndpointArray[index].wheelNext )
+    {
+      if( bdb_reportingClusterEndpointArray[index].nextReportTime < *nextReportTime )
       {
-        if( bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt != BDBREPORTING_NOPERIODIC &&  bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt != BDBREPORTING_REPORTOFF )
-        {
-          bdb_reportingClusterEndpointArray[i].timeSinceLastReport = (bdb_reportingClusterEndpointArray[i].timeSinceLastReport+timeSinceLastReportIncrement
-                                                                      > bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt)?
-                                                                      bdb_reportingClusterEndpointArray[i].consolidatedMaxReportInt:
-                                                                      bdb_reportingClusterEndpointArray[i].timeSinceLastReport+timeSinceLastReportIncrement;
-        }
+        *nextReportTime = bdb_reportingClusterEndpointArray[index].nextReportTime;
       }
-      FLAGS_TURNOFFFLAG( bdb_reportingClusterEndpointArray[i].flags, BDBREPORTING_NONEXTINCREMENT_FLAG_MASK ); //Always turn off, one shot functionality
-
     }
+    return BDBREPORTING_TRUE;
   }
+  return BDBREPORTING_FALSE;
 }
 
 /*
-* End: Cluster-endpoint array live data methods
+* End: Reporting timing wheel methods
 */
 
 
@@ -1324,6 +1622,7 @@ static uint8_t bdb_repAttrDefaultCfgRecordsLinkedListFreeAll( bdbRepAttrDefaultC
 static void bdb_repAttrCfgRecordsArrayInit( void )
 {
   bdb_reportingAttrCfgRecordsArray = NULL;
+  bdb_reportingAttrCfgRecordsHashNext = NULL;
   bdb_reportingAttrCfgRecordsArrayCount = 0;
 }
 
@@ -1341,9 +1640,69 @@ static uint8_t bdb_repAttrCfgRecordsArrayCreate( uint8_t maxNumRepAttrConfRecord
   {
     return BDBREPORTING_ERROR;
   }
+  bdb_reportingAttrCfgRecordsHashNext = (uint8_t *)OsalPort_malloc( bdb_reportingAttrCfgRecordsArrayMaxSize );
+  if( bdb_reportingAttrCfgRecordsHashNext==NULL )
+  {
+    OsalPort_free( bdb_reportingAttrCfgRecordsArray );
+    bdb_reportingAttrCfgRecordsArray = NULL;
+    return BDBREPORTING_ERROR;
+  }
+  //Index is empty, records are added to it as they are added to the array
+  bdb_repAttrCfgRecordsArrayIndex( );
   return BDBREPORTING_SUCCESS;
 }
 
+/*********************************************************************
+ * @fn      bdb_repAttrCfgRecordsArrayHash
+ *
+ * @brief   Get the hash bucket of an attribute reporting configuration record
+ *
+ * @param   endpoint - Endpoint ID of the record
+ * @param   cluster - Cluster ID of the record
+ * @param   manuCode - manufacture Code of the record
+ * @param   direction - direction of the record
+ * @param   attrID - attribute ID of the record
+ *
+ * @return  hash bucket index
+ */
+static uint8_t bdb_repAttrCfgRecordsArrayHash( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t attrID )
+{
+  uint8_t hash = endpoint ^ (uint8_t)cluster ^ (uint8_t)( cluster >> 8 ) ^
+                 (uint8_t)manuCode ^ (uint8_t)( manuCode >> 8 ) ^ ( direction << 2 ) ^
+                 (uint8_t)attrID ^ (uint8_t)( attrID >> 8 );
+  return ( hash & ( BDBREPORTING_ATTRCFG_HASH_SIZE - 1 ) );
+}
+
+/*********************************************************************
+ * @fn      bdb_repAttrCfgRecordsArrayIndex
+ *
+ * @brief   Rebuilds the hash index of the attribute reporting configuration
+ *          records, to be called when the array is filled from NV
+ *
+ * @return
+ */
+static void bdb_repAttrCfgRecordsArrayIndex( void )
+{
+  uint8_t i;
+  uint8_t hash;
+  for( i=0; i<BDBREPORTING_ATTRCFG_HASH_SIZE; i++ )
+  {
+    bdb_reportingAttrCfgRecordsHashHead[i] = BDBREPORTING_INVALIDINDEX;
+  }
+  if( bdb_reportingAttrCfgRecordsHashNext == NULL )
+  {
+    return;
+  }
+  for( i=0; i<bdb_reportingAttrCfgRecordsArrayCount; i++ )
+  {
+    hash = bdb_repAttrCfgRecordsArrayHash( bdb_reportingAttrCfgRecordsArray[i].endpoint, bdb_reportingAttrCfgRecordsArray[i].cluster,
+                                           bdb_reportingAttrCfgRecordsArray[i].manuCode, bdb_reportingAttrCfgRecordsArray[i].direction,
+                                           bdb_reportingAttrCfgRecordsArray[i].attrID );
+    bdb_reportingAttrCfgRecordsHashNext[i] = bdb_reportingAttrCfgRecordsHashHead[hash];
+    bdb_reportingAttrCfgRecordsHashHead[hash] = i;
+  }
+}
+
 static uint8_t bdb_repAttrCfgRecordsArrayAdd( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t attrID, uint16_t minReportInt,
                                               uint16_t maxReportInt, uint8_t  reportableChange[], uint16_t defMinReportInt, uint16_t defMaxReportInt, uint8_t defReportChange[] )
 {
@@ -1359,6 +1718,7 @@ static uint8_t bdb_repAttrCfgRecordsArrayAdd( uint8_t endpoint, uint16_t cluster
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].endpoint = endpoint;
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].cluster = cluster;
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].manuCode = manuCode; //add by luoyiming, 2019-10-21
+  bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].direction = direction;
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].attrID = attrID;
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].minReportInt = minReportInt;
   bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].maxReportInt = maxReportInt;
@@ -1372,6 +1732,9 @@ static uint8_t bdb_repAttrCfgRecordsArrayAdd( uint8_t endpoint, uint16_t cluster
   {
     OsalPort_memcpy( bdb_reportingAttrCfgRecordsArray[bdb_reportingAttrCfgRecordsArrayCount].defaultReportableChange, defReportChange, BDBREPORTING_MAX_ANALOG_ATTR_SIZE );
   }
+  uint8_t hash = bdb_repAttrCfgRecordsArrayHash( endpoint, cluster, manuCode, direction, attrID );
+  bdb_reportingAttrCfgRecordsHashNext[bdb_reportingAttrCfgRecordsArrayCount] = bdb_reportingAttrCfgRecordsHashHead[hash];
+  bdb_reportingAttrCfgRecordsHashHead[hash] = bdb_reportingAttrCfgRecordsArrayCount;
   bdb_reportingAttrCfgRecordsArrayCount++;
   return BDBREPORTING_SUCCESS;
 }
@@ -1385,6 +1748,11 @@ static void bdb_repAttrCfgRecordsArrayFreeAll( void )
   OsalPort_free( bdb_reportingAttrCfgRecordsArray );
   bdb_reportingAttrCfgRecordsArrayCount = 0;
   bdb_reportingAttrCfgRecordsArray=NULL;
+  if( bdb_reportingAttrCfgRecordsHashNext != NULL )
+  {
+    OsalPort_free( bdb_reportingAttrCfgRecordsHashNext );
+    bdb_reportingAttrCfgRecordsHashNext = NULL;
+  }
 }
 
 static uint8_t bdb_repAttrCfgRecordsArraySearch( uint8_t endpoint, uint16_t cluster, uint16_t manuCode, uint8_t direction, uint16_t attrID )
@@ -1394,7 +1762,8 @@ static uint8_t bdb_repAttrCfgRecordsArraySearch( uint8_t endpoint, uint16_t clus
   {
     return BDBREPORTING_INVALIDINDEX;
   }
-  for( i=0; i<bdb_reportingAttrCfgRecordsArrayCount; i++ )
+  i = bdb_reportingAttrCfgRecordsHashHead[bdb_repAttrCfgRecordsArrayHash( endpoint, cluster, manuCode, direction, attrID )];
+  while( i != BDBREPORTING_INVALIDINDEX )
   {
     if( bdb_reportingAttrCfgRecordsArray[i].endpoint == endpoint &&
         bdb_reportingAttrCfgRecordsArray[i].cluster == cluster &&
@@ -1404,6 +1773,7 @@ static uint8_t bdb_repAttrCfgRecordsArraySearch( uint8_t endpoint, uint16_t clus
     {
       return i;
     }
+    i = bdb_reportingAttrCfgRecordsHashNext[i];
   }
   return BDBREPORTING_INVALIDINDEX;
 }
@@ -1481,7 +1851,7 @@ static uint8_t bdb_repAttrBuildClusterEndPointArrayBasedOnConfRecordsArray( void
                                                             &consolidatedMinReportInt, &consolidatedMaxReportInt );
       if( status == BDBREPORTING_SUCCESS )
       {
-        status = bdb_clusterEndpointArrayAdd( curEndpoint, curCluster, curManuCode, curDirection, consolidatedMinReportInt, consolidatedMaxReportInt, 0 );
+        status = bdb_clusterEndpointArrayAdd( curEndpoint, curCluster, curManuCode, curDirection, consolidatedMinReportInt, consolidatedMaxReportInt );
         if( status == BDBREPORTING_SUCCESS )
         {
           //disable un-config attribute reporting. add by luoyiming
@@ -1593,6 +1963,7 @@ static void bdb_RepInitAttrCfgRecords( void )
         }
         osal_nv_read( ZCD_NV_BDBREPORTINGCONFIG,0, sizeof( bdbReportAttrCfgData_t )*attrCfgRecordsArrayCount ,bdb_reportingAttrCfgRecordsArray );
         bdb_reportingAttrCfgRecordsArrayCount = attrCfgRecordsArrayCount;
+        bdb_repAttrCfgRecordsArrayIndex( );
       }
   }
 
@@ -1707,6 +2078,7 @@ static uint8_t bdb_RepLoadCfgRecords( void )
   }
   osal_nv_read( ZCD_NV_BDBREPORTINGCONFIG,0,sizeof( bdbReportAttrCfgData_t )*attrCfgRecordsArrayCount ,bdb_reportingAttrCfgRecordsArray );
   bdb_reportingAttrCfgRecordsArrayCount = attrCfgRecordsArrayCount;
+  bdb_repAttrCfgRecordsArrayIndex( );
   return BDBREPORTING_SUCCESS;
 
 }
@@ -1779,18 +2151,7 @@ static void bdb_RepReport( uint8_t specificCLusterEndpointIndex )
         }
       }
 
-      // Trigger callback befor send reporting, don't send reporting if callback returns TRUE, fixed by luoyiming 2019-11-22.
-      uint8_t frameCounter = zcl_getFrameCounter( ); //get current frame counter, uoyiming fix at 2019-11-22.
-      if( ( pBdb_SendReportCmdCallback == NULL ) ||
-          ( FALSE == pBdb_SendReportCmdCallback( clusterEndpointItem->endpoint, &dstAddr, clusterEndpointItem->cluster,
-                                                 pReportCmd, !clusterEndpointItem->direction, BDB_REPORTING_DISABLE_DEFAULT_RSP,
-                                                 clusterEndpointItem->manuCode, frameCounter ) ) )
-      {
-        // If callback is invalid, send reporting in task stack, luoyiming fix at 2019-11-22.
-        zcl_StackSendReportCmd( clusterEndpointItem->endpoint, &dstAddr, clusterEndpointItem->cluster,
-                                pReportCmd, !clusterEndpointItem->direction, BDB_REPORTING_DISABLE_DEFAULT_RSP,
-                                clusterEndpointItem->manuCode, frameCounter );
-      }
+      bdb_RepSendReportFrames( clusterEndpointItem, &dstAddr, pReportCmd );
     }
     if( (pReportCmd != NULL ) )
     {
@@ -1803,6 +2164,129 @@ static void bdb_RepReport( uint8_t specificCLusterEndpointIndex )
   }
 }
 
+/*********************************************************************
+ * @fn      bdb_RepSendReportFrames
+ *
+ * @brief   Sends the attribute records of a cluster-endpoint report, using
+ *          as few Report Attributes frames as fit in the AF MTU
+ *
+ * @param   clusterEndpointItem - cluster-endpoint entry being reported
+ * @param   dstAddr - destination address
+ * @param   pReportCmd - report command with all the attribute records, the
+ *          records are moved within the list as frames are sent
+ *
+ * @return
+ */
+static void bdb_RepSendReportFrames( bdbReportAttrClusterEndpoint_t* clusterEndpointItem, afAddrType_t* dstAddr, zclReportCmd_t* pReportCmd )
+{
+  afDataReqMTU_t mtu;
+  uint16_t maxLen;
+  uint16_t len;
+  uint16_t recLen;
+  uint8_t numAttr = pReportCmd->numAttr;
+  uint8_t numFrameAttr;
+  uint8_t frameCounter;
+
+  mtu.kvp = FALSE;
+  mtu.aps.secure = TRUE;
+  mtu.aps.addressingMode = dstAddr->addrMode;
+  maxLen = afDataReqMTU( &mtu );
+  maxLen -= ( clusterEndpointItem->manuCode != 0 ) ? BDBREPORTING_ZCL_MANU_HDR_LEN : BDBREPORTING_ZCL_HDR_LEN;
+
+  while( numAttr > 0 )
+  {
+    //Take as many records as fit in the frame, at least one
+    len = 0;
+    for( numFrameAttr = 0; numFrameAttr < numAttr; numFrameAttr++ )
+    {
+      recLen = 2 + 1 + zclGetAttrDataLength( pReportCmd->attrList[numFrameAttr].dataType, pReportCmd->attrList[numFrameAttr].attrData );
+      if( ( numFrameAttr > 0 ) && ( len + recLen > maxLen ) )
+      {
+        break;
+      }
+      len += recLen;
+    }
+    pReportCmd->numAttr = numFrameAttr;
+
+    // Trigger callback befor send reporting, don't send reporting if callback returns TRUE, fixed by luoyiming 2019-11-22.
+    frameCounter = zcl_getFrameCounter( ); //get current frame counter, uoyiming fix at 2019-11-22.
+    if( ( pBdb_SendReportCmdCallback == NULL ) ||
+        ( FALSE == pBdb_SendReportCmdCallback( clusterEndpointItem->endpoint, dstAddr, clusterEndpointItem->cluster,
+                                               pReportCmd, !clusterEndpointItem->direction, BDB_REPORTING_DISABLE_DEFAULT_RSP,
+                                               clusterEndpointItem->manuCode, frameCounter ) ) )
+    {
+      // If callback is invalid, send reporting in task stack, luoyiming fix at 2019-11-22.
+      zcl_StackSendReportCmd( clusterEndpointItem->endpoint, dstAddr, clusterEndpointItem->cluster,
+                              pReportCmd, !clusterEndpointItem->direction, BDB_REPORTING_DISABLE_DEFAULT_RSP,
+                              clusterEndpointItem->manuCode, frameCounter );
+    }
+    bdb_reportingCoalesceCounters.framesSent++;
+
+    //Move the records left to the start of the list for the next frame
+    numAttr -= numFrameAttr;
+    if( numAttr > 0 )
+    {
+      memmove( pReportCmd->attrList, &pReportCmd->attrList[numFrameAttr], numAttr * sizeof( zclReport_t ) );
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      bdb_RepQueueCoalescedReport
+ *
+ * @brief   Marks a cluster-endpoint entry to be reported when the coalescing
+ *          window expires, starting the window if it is not running. A
+ *          trigger for an entry already pending is merged into that report.
+ *
+ * @param   index - index of the cluster-endpoint entry
+ *
+ * @return
+ */
+static void bdb_RepQueueCoalescedReport( uint8_t index )
+{
+  if( FLAGS_CHECKFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_PENDING_FLAG_MASK ) == BDBREPORTING_TRUE )
+  {
+    bdb_reportingCoalesceCounters.framesSaved++;
+    return;
+  }
+  FLAGS_TURNONFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_PENDING_FLAG_MASK );
+  bdb_reportingPendingList[bdb_reportingPendingCount++] = index;
+  if( OsalPortTimers_getTimerTimeout( bdb_TaskID, BDB_REPORT_COALESCE_TIMEOUT ) == 0 )
+  {
+    OsalPortTimers_startTimer( bdb_TaskID, BDB_REPORT_COALESCE_TIMEOUT, BDBREPORTING_COALESCE_WINDOW );
+  }
+}
+
+/*********************************************************************
+ * @fn      bdb_RepCancelCoalescedReport
+ *
+ * @brief   Removes a cluster-endpoint entry from the pending reports, used
+ *          when the entry is reported before the coalescing window expires
+ *
+ * @param   index - index of the cluster-endpoint entry
+ *
+ * @return
+ */
+static void bdb_RepCancelCoalescedReport( uint8_t index )
+{
+  uint8_t i;
+
+  if( FLAGS_CHECKFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_PENDING_FLAG_MASK ) == BDBREPORTING_FALSE )
+  {
+    return;
+  }
+  FLAGS_TURNOFFFLAG( bdb_reportingClusterEndpointArray[index].flags, BDBREPORTING_PENDING_FLAG_MASK );
+  for( i=0; i<bdb_reportingPendingCount; i++ )
+  {
+    if( bdb_reportingPendingList[i] == index )
+    {
+      bdb_reportingPendingList[i] = bdb_reportingPendingList[--bdb_reportingPendingCount];
+      break;
+    }
+  }
+  bdb_reportingCoalesceCounters.framesSaved++;
+}
+
 static uint8_t bdb_isAttrValueChangedSurpassDelta( uint8_t datatype, uint8_t* delta, uint8_t* curValue, uint8_t* lastValue )
 {
   uint8_t res = BDBREPORTING_FALSE;
@@ -2005,7 +2489,7 @@ static void bdb_RepSetupReporting( void )
 {
   uint8_t numArrayFlags, i;
   //Stop if reporting timer is active
-  OsalPortTimers_stopTimer( bdb_TaskID, BDB_REPORT_TIMEOUT );
+  bdb_RepStopEventTimer( );
 
   numArrayFlags = bdb_reportingClusterEndpointArrayCount;
   bdbReportFlagsHolder_t* arrayFlags = (bdbReportFlagsHolder_t *)OsalPort_malloc( sizeof( bdbReportFlagsHolder_t )*numArrayFlags );
@@ -2035,15 +2519,43 @@ static void bdb_RepSetupReporting( void )
     uint8_t clusterEndpointIndex = bdb_clusterEndpointArraySearch( arrayFlags[i].endpoint, arrayFlags[i].cluster, arrayFlags[i].manuCode, arrayFlags[i].direction );
     if( clusterEndpointIndex != BDBREPORTING_INVALIDINDEX )
     {
-      bdb_reportingClusterEndpointArray[clusterEndpointIndex].flags = arrayFlags[i].flags;
+      bdb_reportingClusterEndpointArray[clusterEndpointIndex].flags = arrayFlags[i].flags & ~BDBREPORTING_PENDING_FLAG_MASK;
+      bdb_repWheelSchedule( clusterEndpointIndex );
+      if( FLAGS_CHECKFLAG( arrayFlags[i].flags, BDBREPORTING_PENDING_FLAG_MASK ) == BDBREPORTING_TRUE )
+      {
+        //Keep the reportable change that was waiting for the coalescing window
+        bdb_RepQueueCoalescedReport( clusterEndpointIndex );
+      }
     }
   }
   OsalPort_free( arrayFlags );
 }
 
 
+/*********************************************************************
+ * @fn      bdb_RepGetClock
+ *
+ * @brief   Get the current value of the reporting clock, including the
+ *          time already consumed by the running timer
+ *
+ * @return  reporting clock in seconds
+ */
+static uint32_t bdb_RepGetClock( void )
+{
+  uint32_t remainingTimeOfEvent = OsalPortTimers_getTimerTimeout( bdb_TaskID, BDB_REPORT_TIMEOUT );
+  if( remainingTimeOfEvent > 0 )
+  {
+    return bdb_reportingClock + bdb_RepCalculateEventElapsedTime( remainingTimeOfEvent, bdb_reportingNextEventTimeout );
+  }
+  //Timer is not running, the last timeout (if any) has fully expired
+  return bdb_reportingClock + bdb_reportingNextEventTimeout;
+}
+
 static void bdb_RepStopEventTimer( void )
 {
+  //Add the time consumed by the timer to the reporting clock
+  bdb_reportingClock = bdb_RepGetClock( );
+  bdb_reportingNextEventTimeout = 0;
   OsalPortTimers_stopTimer( bdb_TaskID, BDB_REPORT_TIMEOUT );
 }
 
@@ -2302,18 +2814,8 @@ ZStatus_t bdb_RepChangedAttrValue( uint8_t endpoint, uint16_t cluster, uint16_t
     return ZInvalidParameter; //Attr not found in attributes app data
   }
 
-  //Get time of timer if active
-  uint32_t remainingTimeOfEvent = OsalPortTimers_getTimerTimeout( bdb_TaskID, BDB_REPORT_TIMEOUT );
-  uint16_t elapsedTime = 0;
-  uint8_t isTimeRemaining = BDBREPORTING_FALSE;
-  if( remainingTimeOfEvent > 0 )
-  {
-    elapsedTime = bdb_RepCalculateEventElapsedTime( remainingTimeOfEvent, bdb_reportingNextEventTimeout );
-    isTimeRemaining =  BDBREPORTING_TRUE;
-  }
-
   if( bdb_reportingClusterEndpointArray[indexClusterEndpoint].consolidatedMinReportInt != BDBREPORTING_NOLIMIT &&
-     (bdb_reportingClusterEndpointArray[indexClusterEndpoint].timeSinceLastReport + elapsedTime) <= bdb_reportingClusterEndpointArray[indexClusterEndpoint].consolidatedMinReportInt)
+     (bdb_RepGetClock( ) - bdb_reportingClusterEndpointArray[indexClusterEndpoint].lastReportTime) <= bdb_reportingClusterEndpointArray[indexClusterEndpoint].consolidatedMinReportInt)
   {
       //Attr value has changed before minInterval, ommit reporting
       return ZSuccess;
@@ -2334,16 +2836,17 @@ ZStatus_t bdb_RepChangedAttrValue( uint8_t endpoint, uint16_t cluster, uint16_t
     //Attr is discrete, just report without checking the changeValue
   }
 
+#if BDBREPORTING_COALESCE_WINDOW > 0
+  //Report when the coalescing window expires, together with any other change of this cluster-endpoint
+  bdb_RepQueueCoalescedReport( indexClusterEndpoint );
+#else
   //Stop reporting
   bdb_RepStopEventTimer( );
   bdb_RepReport( indexClusterEndpoint );
-  if( isTimeRemaining == BDBREPORTING_TRUE )
-  {
-    bdb_clusterEndpointArrayIncrementAll( elapsedTime, BDBREPORTING_FALSE );
-  }
-  bdb_clusterEndpointArrayUpdateAt( indexClusterEndpoint, 0, BDBREPORTING_IGNORE, BDBREPORTING_IGNORE ); //return time since last report to zero
+  bdb_clusterEndpointArrayUpdateAt( indexClusterEndpoint, BDBREPORTING_IGNORE ); //return time since last report to zero
   //Restart reporting
   bdb_RepStartReporting( );
+#endif
 
   return ZSuccess;
 }
@@ -62,6 +62,12 @@
  * TYPEDEFS
  */
 
+// Counters of the Report Attributes commands sent by the bdb reporting code
+typedef struct
+{
+  uint32_t framesSent;    // Report Attributes frames handed to ZCL or to the app callback
+  uint32_t framesSaved;   // Frames not sent because the trigger was merged into a pending report
+} bdbRepCoalesceCounters_t;
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -88,6 +94,9 @@ extern bool (*pBdb_SendReportCmdCallback)( uint8_t srcEP, afAddrType_t *dstAddr,
                                            zclReportCmd_t *reportCmd, uint8_t direction, uint8_t disableDefaultRsp,
                                            uint16_t manuCode, uint8_t seqNum );
 
+// Report coalescing counters, see BDBREPORTING_COALESCE_WINDOW
+extern bdbRepCoalesceCounters_t bdb_reportingCoalesceCounters;
+
 /*********************************************************************
  * FUNCTIONS
  */
@@ -95,6 +104,7 @@ extern bool (*pBdb_SendReportCmdCallback)( uint8_t srcEP, afAddrType_t *dstAddr,
 void bdb_RepInit( void );
 void bdb_RepConstructReportingData( void );
 void bdb_RepProcessEvent( void );
+void bdb_RepProcessCoalesceEvent( void );
 void bdb_RepStartOrContinueReporting( void );
 void bdb_RepMarkHasBindingInEndpointClusterArray( uint8_t endpoint, uint16_t cluster, uint16_t manuCode,
                                                   uint8_t direction, uint8_t unMark, uint8_t setNoNextIncrementFlag );
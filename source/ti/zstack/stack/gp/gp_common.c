@@ -80,17 +80,46 @@ uint8_t const ppgCommissioningWindow =  180;  //180 seconds by defaut
   CONFIG_ITEM uint8_t zgpSharedKey[SEC_KEY_LEN] = {0xFF};
 #endif
 
+// Number of recently received GPDFs remembered for duplicate filtering,
+// the oldest one is forgotten early when the filter is full
+#if !defined (GP_DUPLICATE_FILTER_ENTRIES)
+  #define GP_DUPLICATE_FILTER_ENTRIES   32
+#endif
+
+// Duplicate filter hash chains, must be a power of 2
+#if !defined (GP_DUPLICATE_FILTER_HASH_SIZE)
+  #define GP_DUPLICATE_FILTER_HASH_SIZE 16
+#endif
+
+// The filter expires frames a whole slot at a time; each frame is kept for
+// gpDuplicateTimeout plus at most one slot period
+#define GP_DUPLICATE_FILTER_SLOTS       4
+#define GP_DUPLICATE_FILTER_SLOT_PERIOD ( gpDuplicateTimeout / GP_DUPLICATE_FILTER_SLOTS )
+
+#define GP_DUPLICATE_FILTER_NONE        0xFF
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Duplicate filter record of a received GPDF
+typedef struct
+{
+  gpdID_t   gpdID;
+  uint32_t  counter;    // Security frame counter, or MAC sequence number
+  uint8_t   secured;    // TRUE if counter is the security frame counter
+  uint8_t   handle;     // dGP stub handle of the GPDF
+  uint8_t   hashNext;
+  uint8_t   slotNext;
+} gp_DupFilterEntry_t;
+
  /*********************************************************************
  * GLOBAL VARIABLES
  */
 
 
-
-//List to filter duplicated packets
+//List of GPDFs passed to MT by the GP stub. The stub appends and releases
+//its own entries; duplicate filtering uses gpDupFilter instead
 gp_DataInd_t        *gp_DataIndList = NULL;
 
 uint8_t gpApplicationAllowChannelChange = FALSE;  //Flag to indicate if application allows or not change channel during GP commissioning
@@ -107,6 +136,24 @@ uint8_t  GPEP_Handle = 0;
 
 #if !defined (DISABLE_GREENPOWER_BASIC_PROXY) && (ZG_BUILD_RTR_TYPE)
 gpCommissioningNotificationMsg_t commissioningNotificationMsg;
+
+// RAM copy of the options and GPD ID of each proxy and sink table entry, so a
+// GPD can be located without reading the tables from NV
+static uint8_t gpProxyTblIndex[GPP_MAX_PROXY_TABLE_ENTRIES][GP_TBL_OPT_AND_GPD_ID_LEN];
+static uint8_t gpSinkTblIndex[GPS_MAX_SINK_TABLE_ENTRIES][GP_TBL_OPT_AND_GPD_ID_LEN];
+static uint8_t gpProxyTblIndexLoaded = FALSE;
+static uint8_t gpSinkTblIndexLoaded = FALSE;
+
+// Duplicate filter: a hash set of the GPDFs received in the last
+// gpDuplicateTimeout, with each record also on the list of the expiry
+// slot current when it was added
+static gp_DupFilterEntry_t gpDupFilter[GP_DUPLICATE_FILTER_ENTRIES];
+static uint8_t gpDupFilterHash[GP_DUPLICATE_FILTER_HASH_SIZE];
+static uint8_t gpDupFilterSlot[GP_DUPLICATE_FILTER_SLOTS + 1];
+static uint8_t gpDupFilterSlotCurr = 0;
+static uint8_t gpDupFilterFree = GP_DUPLICATE_FILTER_NONE;
+static uint8_t gpDupFilterCount = 0;
+static uint8_t gpDupFilterInit = FALSE;
 #if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
 Clock_Struct gpAppDataSendClk;
 Clock_Handle gpAppDataSendClkHandle;
@@ -399,7 +446,13 @@ static ZStatus_t zclGp_ReadWriteAttrCB( uint8_t endpoint, zclAttrRec_t *pAttr, u
 static uint8_t GP_RecoveryKey(uint8_t GPDFKeyType, uint8_t KeyType, uint8_t status, void* Key);
 static void gp_u32CastPointer( uint8_t *data, uint8_t *p );
 static void gp_u8CastPointer( uint8_t *data, uint8_t *p );
-static void gp_DataIndFree( gp_DataInd_t* dataInd, gp_DataInd_t **DataIndList);
+static uint8_t gp_DupFilterHash( gpdID_t *pGpdID, uint32_t counter );
+static void gp_DupFilterSetKey( gp_DupFilterEntry_t *pKey, gp_DataInd_t *gp_DataInd, uint8_t secLvl );
+static uint8_t gp_DupFilterKeyMatch( gp_DupFilterEntry_t *pEntry, gp_DupFilterEntry_t *pKey );
+static void gp_DupFilterRelease( uint8_t i );
+static void gp_DupFilterStartTimer( void );
+static uint8_t* gp_TblIndexGet( uint16_t nvId, uint16_t* pNumEntries );
+static uint8_t gp_TblIndexMatch( uint8_t* pCurr, uint8_t* pNew );
 static void zclGreenPower_initializeClocks(void);
 static void zclSampleAppsGp_ProcessDataSendTimeoutCallback(UArg a0);
 static void zclSampleAppsGp_ProcessExpireDuplicateTimeoutCallback(UArg a0);
@@ -584,40 +637,248 @@ void gp_endpointInit( uint8_t entity )
  * @param   handle - Handler of gp data indication
  *          secLvl - Security level
  *
- * @return  none
+ * @return  The pending data indication if it duplicates a recent frame,
+ *          NULL otherwise
  */
 gp_DataInd_t* gp_DataIndFindDuplicate(uint8_t handle, uint8_t secLvl)
 {
   gp_DataInd_t* temp = NULL;
-  gp_DataInd_t* tempList = NULL;
   temp = gp_DataIndGet(handle);
 
-  if(temp != NULL)
+  if((temp != NULL) && (gp_DuplicateFilterFind(temp, secLvl) == FALSE))
   {
-    tempList = gp_DataIndList;
+    temp = NULL;
+  }
+  return temp;
+}
 
-    while(tempList != NULL)
+/*******************************************************************************
+ * @fn      gp_DuplicateFilterFind
+ *
+ * @brief   Find if a frame duplicates one received in the last
+ *          gpDuplicateTimeout (A.3.6.1.2). Frames match on GPD ID and the
+ *          MAC sequence number, or the security frame counter if secured.
+ *
+ * @param   gp_DataInd - GPDF to look up
+ *          secLvl - Security level
+ *
+ * @return  TRUE if the frame is a duplicate
+ */
+uint8_t gp_DuplicateFilterFind(gp_DataInd_t *gp_DataInd, uint8_t secLvl)
+{
+  gp_DupFilterEntry_t key;
+  uint8_t i;
+
+  if(gpDupFilterInit == FALSE)
+  {
+    return FALSE;
+  }
+
+  gp_DupFilterSetKey(&key, gp_DataInd, secLvl);
+
+  i = gpDupFilterHash[gp_DupFilterHash(&key.gpdID, key.counter)];
+  while(i != GP_DUPLICATE_FILTER_NONE)
+  {
+    //The same frame seen by the sink and then the proxy is not a duplicate
+    if((gp_DupFilterKeyMatch(&gpDupFilter[i], &key) == TRUE) &&
+       (gpDupFilter[i].handle != key.handle))
     {
-      //search for MAC seq num
-      if( (secLvl == 0) &&
-          (temp->SeqNumber == tempList->SeqNumber) &&
-          (temp->appID == tempList->appID) &&
-          (temp->SrcId == tempList->SrcId) &&
-          (temp->SecReqHandling.dGPStubHandle != tempList->SecReqHandling.dGPStubHandle) )
-      {
-          break;
-      }
-      //Other secLevels uses SecFrameCounter
-      else if( (secLvl != 0) &&
-              (temp->GPDSecFrameCounter == tempList->GPDSecFrameCounter) &&
-              (temp->SecReqHandling.dGPStubHandle != tempList->SecReqHandling.dGPStubHandle) )
-      {
-        break;
-      }
-      tempList = tempList->SecReqHandling.next;
+      return TRUE;
     }
+    i = gpDupFilter[i].hashNext;
+  }
+
+  return FALSE;
+}
+
+/*******************************************************************************
+ * @fn      gp_DuplicateFilterAdd
+ *
+ * @brief   Remember a received frame for gpDuplicateTimeout, so that its
+ *          repetitions are filtered.
+ *
+ * @param   gp_DataInd - GPDF received
+ *
+ * @return  none
+ */
+void gp_DuplicateFilterAdd(gp_DataInd_t *gp_DataInd)
+{
+  gp_DupFilterEntry_t key;
+  uint8_t hash;
+  uint8_t slot;
+  uint8_t i;
+
+  if(gpDupFilterInit == FALSE)
+  {
+    zcl_memset(gpDupFilterHash, GP_DUPLICATE_FILTER_NONE, sizeof(gpDupFilterHash));
+    zcl_memset(gpDupFilterSlot, GP_DUPLICATE_FILTER_NONE, sizeof(gpDupFilterSlot));
+    for(i = 0; i < GP_DUPLICATE_FILTER_ENTRIES; i++)
+    {
+      gpDupFilter[i].hashNext = (i + 1 < GP_DUPLICATE_FILTER_ENTRIES) ? (i + 1) : GP_DUPLICATE_FILTER_NONE;
+    }
+    gpDupFilterFree = 0;
+    gpDupFilterSlotCurr = 0;
+    gpDupFilterCount = 0;
+    gpDupFilterInit = TRUE;
+  }
+
+  gp_DupFilterSetKey(&key, gp_DataInd, gp_DataInd->GPDFSecLvl);
+  hash = gp_DupFilterHash(&key.gpdID, key.counter);
+
+  for(i = gpDupFilterHash[hash]; i != GP_DUPLICATE_FILTER_NONE; i = gpDupFilter[i].hashNext)
+  {
+    if(gp_DupFilterKeyMatch(&gpDupFilter[i], &key) == TRUE)
+    {
+      //Already remembered, keep the original expiration
+      return;
+    }
+  }
+
+  if(gpDupFilterCount == GP_DUPLICATE_FILTER_ENTRIES)
+  {
+    //Full, forget the oldest frame
+    slot = gpDupFilterSlotCurr;
+    do
+    {
+      slot = (slot + 1) % (GP_DUPLICATE_FILTER_SLOTS + 1);
+    } while(gpDupFilterSlot[slot] == GP_DUPLICATE_FILTER_NONE);
+
+    i = gpDupFilterSlot[slot];
+    gpDupFilterSlot[slot] = gpDupFilter[i].slotNext;
+    gp_DupFilterRelease(i);
+  }
+
+  i = gpDupFilterFree;
+  gpDupFilterFree = gpDupFilter[i].hashNext;
+  gpDupFilterCount++;
+
+  gpDupFilter[i] = key;
+  gpDupFilter[i].hashNext = gpDupFilterHash[hash];
+  gpDupFilterHash[hash] = i;
+  gpDupFilter[i].slotNext = gpDupFilterSlot[gpDupFilterSlotCurr];
+  gpDupFilterSlot[gpDupFilterSlotCurr] = i;
+
+  if(gpDupFilterCount == 1)
+  {
+    gp_DupFilterStartTimer();
+  }
+}
+
+/*******************************************************************************
+ * @fn      gp_DupFilterSetKey
+ *
+ * @brief   Fill the duplicate filter key of a frame
+ *
+ * @param   pKey - key to fill
+ *          gp_DataInd - GPDF
+ *          secLvl - Security level
+ *
+ * @return  none
+ */
+static void gp_DupFilterSetKey(gp_DupFilterEntry_t *pKey, gp_DataInd_t *gp_DataInd, uint8_t secLvl)
+{
+  zcl_memset(&pKey->gpdID, 0x00, sizeof(gpdID_t));
+  pKey->gpdID.appID = gp_DataInd->appID;
+  if(gp_DataInd->appID == GP_OPT_APP_ID_IEEE)
+  {
+    zcl_memcpy(pKey->gpdID.id.gpdExtAddr, gp_DataInd->srcAddr.addr.extAddr, Z_EXTADDR_LEN);
+  }
+  else
+  {
+    pKey->gpdID.id.srcID = gp_DataInd->SrcId;
+  }
+
+  //Other secLevels uses SecFrameCounter
+  pKey->secured = (secLvl != 0) ? TRUE : FALSE;
+  pKey->counter = pKey->secured ? gp_DataInd->GPDSecFrameCounter : gp_DataInd->SeqNumber;
+  pKey->handle = gp_DataInd->SecReqHandling.dGPStubHandle;
+}
+
+/*******************************************************************************
+ * @fn      gp_DupFilterKeyMatch
+ *
+ * @brief   Compare a duplicate filter record with a key
+ *
+ * @param   pEntry - record
+ *          pKey - key
+ *
+ * @return  TRUE if they match
+ */
+static uint8_t gp_DupFilterKeyMatch(gp_DupFilterEntry_t *pEntry, gp_DupFilterEntry_t *pKey)
+{
+  return ((pEntry->counter == pKey->counter) &&
+          (pEntry->secured == pKey->secured) &&
+          (pEntry->gpdID.appID == pKey->gpdID.appID) &&
+          zcl_memcmp(pEntry->gpdID.id.gpdExtAddr, pKey->gpdID.id.gpdExtAddr, Z_EXTADDR_LEN));
+}
+
+/*******************************************************************************
+ * @fn      gp_DupFilterHash
+ *
+ * @brief   Hash chain of a duplicate filter key
+ *
+ * @param   pGpdID - GPD ID
+ *          counter - Security frame counter or MAC sequence number
+ *
+ * @return  hash chain
+ */
+static uint8_t gp_DupFilterHash(gpdID_t *pGpdID, uint32_t counter)
+{
+  uint8_t hash = (uint8_t)counter;
+  uint8_t i;
+
+  for(i = 0; i < Z_EXTADDR_LEN; i++)
+  {
+    hash = (uint8_t)((hash << 1) ^ (hash >> 7) ^ pGpdID->id.gpdExtAddr[i]);
   }
-  return tempList;
+
+  return (hash ^ (hash >> 4)) & (GP_DUPLICATE_FILTER_HASH_SIZE - 1);
+}
+
+/*******************************************************************************
+ * @fn      gp_DupFilterRelease
+ *
+ * @brief   Release a duplicate filter record already removed from its expiry
+ *          slot: remove it from its hash chain and return it to the free list.
+ *
+ * @param   i - record to release
+ *
+ * @return  none
+ */
+static void gp_DupFilterRelease(uint8_t i)
+{
+  uint8_t *pLink;
+
+  pLink = &gpDupFilterHash[gp_DupFilterHash(&gpDupFilter[i].gpdID, gpDupFilter[i].counter)];
+  while(*pLink != i)
+  {
+    pLink = &gpDupFilter[*pLink].hashNext;
+  }
+  *pLink = gpDupFilter[i].hashNext;
+
+  //Free records are chained through hashNext
+  gpDupFilter[i].hashNext = gpDupFilterFree;
+  gpDupFilterFree = i;
+  gpDupFilterCount--;
+}
+
+/*******************************************************************************
+ * @fn      gp_DupFilterStartTimer
+ *
+ * @brief   Start the duplicate filter expiry slot timer
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void gp_DupFilterStartTimer(void)
+{
+#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
+  Timer_setTimeout(gpAppExpireDuplicateClkHandle, GP_DUPLICATE_FILTER_SLOT_PERIOD);
+  Timer_start(&gpAppExpireDuplicateClk);
+#else
+  OsalPortTimers_startTimer(gp_TaskID, GP_DUPLICATE_FILTERING_TIMEOUT_EVENT, GP_DUPLICATE_FILTER_SLOT_PERIOD);
+#endif
 }
 
  /*********************************************************************
@@ -663,32 +924,168 @@ void gp_PopulateField( uint8_t* pField, uint8_t** pData, uint8_t size )
  * @return      TRUE if the GPD has an entry in current NV vector
  */
 uint8_t gpLookForGpd( uint16_t currEntryId, uint8_t* pNew )
+{
+  uint8_t* pIndex;
+  uint16_t numEntries;
+
+  pIndex = gp_TblIndexGet( ZCL_PORT_PROXY_TABLE_NV_ID, &numEntries );
+
+  if ( currEntryId >= numEntries )
+  {
+    return FALSE;
+  }
+
+  return gp_TblIndexMatch( &pIndex[currEntryId * GP_TBL_OPT_AND_GPD_ID_LEN], pNew );
+}
+
+/*********************************************************************
+ * @fn          gp_writeTblEntry
+ *
+ * @brief       Write a proxy or sink table entry to NV and keep the RAM
+ *              GPD index of the table in sync. Every proxy and sink table
+ *              entry write must go through this function.
+ *
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *              nvIndex - NV index of the entry
+ *              len - number of bytes to write
+ *              pEntry - entry to be written
+ *
+ * @return      status of the NV write
+ */
+uint8_t gp_writeTblEntry( uint16_t nvId, uint16_t nvIndex, uint16_t len, void *pEntry )
 {
   uint8_t status;
+  uint8_t* pIndex;
+  uint16_t numEntries;
 
-  uint8_t newEntry[GP_TBL_OPT_AND_GPD_ID_LEN];
-  uint8_t currEntry[GP_TBL_OPT_AND_GPD_ID_LEN];
+  status = zclport_writeNV( nvId, nvIndex, len, pEntry );
 
-  zcl_memcpy(newEntry, pNew, GP_TBL_OPT_AND_GPD_ID_LEN);
+  pIndex = gp_TblIndexGet( nvId, &numEntries );
+  if ( ( pIndex != NULL ) && ( nvIndex < numEntries ) )
+  {
+    if ( ( status == SUCCESS ) && ( len >= GP_TBL_OPT_AND_GPD_ID_LEN ) )
+    {
+      zcl_memcpy( &pIndex[nvIndex * GP_TBL_OPT_AND_GPD_ID_LEN], pEntry,
+                  GP_TBL_OPT_AND_GPD_ID_LEN );
+    }
+    else
+    {
+      // The NV content is not known anymore, reload it on next use
+      gp_TblIndexInvalidate( nvId );
+    }
+  }
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn          gp_TblIndexFindGpd
+ *
+ * @brief       Find the proxy or sink table entry of a GPD using the RAM
+ *              GPD index
+ *
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *              pNew - table entry array holding the GPD to look for
+ *
+ * @return      NV index of the entry, ZCD_NV_INVALID_INDEX if not found
+ */
+uint16_t gp_TblIndexFindGpd( uint16_t nvId, uint8_t* pNew )
+{
+  uint8_t* pIndex;
+  uint16_t numEntries;
+  uint16_t i;
 
-  status = zclport_readNV(ZCL_PORT_PROXY_TABLE_NV_ID, currEntryId,
-                          0,
-                          GP_TBL_OPT_AND_GPD_ID_LEN,
-                          currEntry);
+  pIndex = gp_TblIndexGet( nvId, &numEntries );
 
-  if((status == SUCCESS) && (GP_TBL_COMP_APPLICATION_ID( newEntry[GP_TBL_OPT], currEntry[GP_TBL_OPT])))
+  for ( i = 0; i < numEntries; i++ )
   {
-    if((GP_GET_APPLICATION_ID(newEntry[GP_TBL_OPT]) == GP_OPT_APP_ID_GPD))
+    if ( gp_TblIndexMatch( &pIndex[i * GP_TBL_OPT_AND_GPD_ID_LEN], pNew ) )
     {
-      status = zcl_memcmp(&newEntry[GP_TBL_SRC_ID], &currEntry[GP_TBL_SRC_ID], sizeof(uint32_t));
+      return i;
     }
-    else if((GP_GET_APPLICATION_ID(newEntry[GP_TBL_OPT]) == GP_OPT_APP_ID_IEEE))
+  }
+  return ZCD_NV_INVALID_INDEX;
+}
+
+/*********************************************************************
+ * @fn          gp_TblIndexFindGpdId
+ *
+ * @brief       Find the proxy or sink table entry of a GPD ID using the RAM
+ *              GPD index
+ *
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *              gpdID - GPD to look for
+ *
+ * @return      NV index of the entry, ZCD_NV_INVALID_INDEX if not found
+ */
+uint16_t gp_TblIndexFindGpdId( uint16_t nvId, gpdID_t* gpdID )
+{
+  uint8_t key[GP_TBL_OPT_AND_GPD_ID_LEN];
+
+  zcl_memset( key, 0, GP_TBL_OPT_AND_GPD_ID_LEN );
+  key[GP_TBL_OPT] = gpdID->appID;
+
+  if ( gpdID->appID == GP_OPT_APP_ID_GPD )
+  {
+    zcl_memcpy( &key[GP_TBL_SRC_ID], &gpdID->id.srcID, sizeof(uint32_t) );
+  }
+  else
+  {
+    zcl_memcpy( &key[GP_TBL_GPD_ID], &gpdID->id.gpdExtAddr, Z_EXTADDR_LEN );
+  }
+
+  return gp_TblIndexFindGpd( nvId, key );
+}
+
+/*********************************************************************
+ * @fn          gp_TblIndexFindEmpty
+ *
+ * @brief       Find the first empty proxy or sink table entry using the RAM
+ *              GPD index
+ *
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *
+ * @return      NV index of the entry, ZCD_NV_INVALID_INDEX if the table is full
+ */
+uint16_t gp_TblIndexFindEmpty( uint16_t nvId )
+{
+  uint8_t* pIndex;
+  uint16_t numEntries;
+  uint16_t emptyEntry = 0xFFFF;
+  uint16_t i;
+
+  pIndex = gp_TblIndexGet( nvId, &numEntries );
+
+  for ( i = 0; i < numEntries; i++ )
+  {
+    if ( zcl_memcmp( &pIndex[i * GP_TBL_OPT_AND_GPD_ID_LEN], &emptyEntry, sizeof(uint16_t) ) )
     {
-      status = zcl_memcmp(&newEntry[GP_TBL_GPD_ID], &currEntry[GP_TBL_GPD_ID], Z_EXTADDR_LEN);
+      return i;
     }
-    return status;
   }
-  return FALSE;
+  return ZCD_NV_INVALID_INDEX;
+}
+
+/*********************************************************************
+ * @fn          gp_TblIndexInvalidate
+ *
+ * @brief       Drop the RAM GPD index of a table, it is reloaded from NV
+ *              on next use
+ *
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *
+ * @return      none
+ */
+void gp_TblIndexInvalidate( uint16_t nvId )
+{
+  if ( nvId == ZCL_PORT_PROXY_TABLE_NV_ID )
+  {
+    gpProxyTblIndexLoaded = FALSE;
+  }
+  else if ( nvId == ZCL_PORT_SINK_TABLE_NV_ID )
+  {
+    gpSinkTblIndexLoaded = FALSE;
+  }
 }
 
 /*********************************************************************
@@ -823,7 +1220,8 @@ void sinkTableCpy(void *dst, void *src)
 * @fn          gp_expireDuplicateFiltering
 *
 * @brief       Process the expiration of the packets in the duplicate filtering
-*              list. Assumption is the first in the queue is the first into expire.
+*              list. Called every GP_DUPLICATE_FILTER_SLOT_PERIOD while the
+*              filter isn't empty, it forgets the frames of the oldest slot.
 *
 * @param       none
 *
@@ -831,40 +1229,27 @@ void sinkTableCpy(void *dst, void *src)
 */
 void gp_expireDuplicateFiltering(void)
 {
-    gp_DataInd_t* temp;
-    uint32_t timeout = 0;
+    uint8_t i;
 
-    temp = gp_DataIndList;
-
-    while(temp != NULL)
+    if(gpDupFilterInit == FALSE)
     {
-        timeout = gp_DataIndList->SecReqHandling.timeout;
-        if(timeout >= temp->SecReqHandling.timeout)
-        {
-            gp_DataInd_t *expired = temp;
+        return;
+    }
 
-            temp = temp->SecReqHandling.next;
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-            gp_DataIndFree(expired, &gp_DataIndList);
-#else
-            gp_DataIndReleaseFromList(expired, &gp_DataIndList);
-#endif
-        }
-        else
-        {
-            temp->SecReqHandling.timeout -= timeout;
-            temp = temp->SecReqHandling.next;
-        }
+    //The slot after the current one was filled GP_DUPLICATE_FILTER_SLOTS
+    //periods ago, reuse it for the frames of the next period
+    gpDupFilterSlotCurr = (gpDupFilterSlotCurr + 1) % (GP_DUPLICATE_FILTER_SLOTS + 1);
+
+    while(gpDupFilterSlot[gpDupFilterSlotCurr] != GP_DUPLICATE_FILTER_NONE)
+    {
+        i = gpDupFilterSlot[gpDupFilterSlotCurr];
+        gpDupFilterSlot[gpDupFilterSlotCurr] = gpDupFilter[i].slotNext;
+        gp_DupFilterRelease(i);
     }
 
-    if((timeout > 0) && (gp_DataIndList != NULL))
+    if(gpDupFilterCount > 0)
     {
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-        Timer_setTimeout(gpAppExpireDuplicateClkHandle, timeout );
-        Timer_start(&gpAppExpireDuplicateClk);
-#else
-        OsalPortTimers_startTimer(gp_TaskID, GP_DUPLICATE_FILTERING_TIMEOUT_EVENT, timeout);
-#endif
+        gp_DupFilterStartTimer();
     }
 }
 
@@ -1501,50 +1886,86 @@ static void gp_u8CastPointer( uint8_t *data, uint8_t *p )
     *(uint8_t*)data |= *(uint8_t*)p;
 }
 
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
 /*********************************************************************
- * @fn          gp_DataIndFree
+ * @fn          gp_TblIndexGet
  *
- * @brief       Releases an element in the list
+ * @brief       Get the RAM GPD index of the proxy or sink table, loading it
+ *              from NV if needed. Entries that cannot be read are indexed as
+ *              empty.
  *
- * @param       dataInd Pointer to the element in the list to be released
+ * @param       nvId - ZCL_PORT_PROXY_TABLE_NV_ID or ZCL_PORT_SINK_TABLE_NV_ID
+ *              pNumEntries - number of entries in the table
  *
- * @param       DataIndList List from which the data ind will be released
+ * @return      pointer to the index, NULL if nvId is not a GP table
+ */
+static uint8_t* gp_TblIndexGet( uint16_t nvId, uint16_t* pNumEntries )
+{
+  uint8_t* pIndex;
+  uint8_t* pLoaded;
+  uint16_t i;
+
+  if ( nvId == ZCL_PORT_PROXY_TABLE_NV_ID )
+  {
+    pIndex = &gpProxyTblIndex[0][0];
+    pLoaded = &gpProxyTblIndexLoaded;
+    *pNumEntries = GPP_MAX_PROXY_TABLE_ENTRIES;
+  }
+  else if ( nvId == ZCL_PORT_SINK_TABLE_NV_ID )
+  {
+    pIndex = &gpSinkTblIndex[0][0];
+    pLoaded = &gpSinkTblIndexLoaded;
+    *pNumEntries = GPS_MAX_SINK_TABLE_ENTRIES;
+  }
+  else
+  {
+    *pNumEntries = 0;
+    return NULL;
+  }
+
+  if ( *pLoaded == FALSE )
+  {
+    for ( i = 0; i < *pNumEntries; i++ )
+    {
+      if ( zclport_readNV( nvId, i, 0, GP_TBL_OPT_AND_GPD_ID_LEN,
+                           &pIndex[i * GP_TBL_OPT_AND_GPD_ID_LEN] ) != SUCCESS )
+      {
+        zcl_memset( &pIndex[i * GP_TBL_OPT_AND_GPD_ID_LEN], 0xFF,
+                    GP_TBL_OPT_AND_GPD_ID_LEN );
+      }
+    }
+    *pLoaded = TRUE;
+  }
+
+  return pIndex;
+}
+
+/*********************************************************************
+ * @fn          gp_TblIndexMatch
  *
- * @return      none
+ * @brief       Compare the GPD ID of an index entry with a table entry
+ *
+ * @param       pCurr - options and GPD ID of the index entry
+ *              pNew - table entry array holding the GPD to look for
+ *
+ * @return      TRUE if both refer to the same GPD
  */
-static void gp_DataIndFree( gp_DataInd_t* dataInd, gp_DataInd_t **DataIndList )
+static uint8_t gp_TblIndexMatch( uint8_t* pCurr, uint8_t* pNew )
 {
-  //Check the first entry
-  if(*DataIndList != NULL)
+  if ( GP_TBL_COMP_APPLICATION_ID( pNew[GP_TBL_OPT], pCurr[GP_TBL_OPT] ) )
   {
-    if(*DataIndList == dataInd)
+    if ( GP_GET_APPLICATION_ID( pNew[GP_TBL_OPT] ) == GP_OPT_APP_ID_GPD )
     {
-      gp_DataInd_t  *next = (*DataIndList)->SecReqHandling.next;
-      zcl_mem_free((uint8_t*)*DataIndList);
-      *DataIndList = next;
+      return zcl_memcmp( &pNew[GP_TBL_SRC_ID], &pCurr[GP_TBL_SRC_ID], sizeof(uint32_t) );
     }
-    else
+    else if ( GP_GET_APPLICATION_ID( pNew[GP_TBL_OPT] ) == GP_OPT_APP_ID_IEEE )
     {
-      gp_DataInd_t  *previous = *DataIndList;
-      gp_DataInd_t  *current  = (*DataIndList)->SecReqHandling.next;
-
-      while((current != NULL) && (previous != NULL))
-      {
-        if(current == dataInd)
-        {
-          gp_DataInd_t  *temp = current;
-          previous->SecReqHandling.next = current->SecReqHandling.next;
-          zcl_mem_free((uint8_t*)temp);
-          return;
-        }
-        previous = current;
-        current = current->SecReqHandling.next;
-      }
+      return zcl_memcmp( &pNew[GP_TBL_GPD_ID], &pCurr[GP_TBL_GPD_ID], Z_EXTADDR_LEN );
     }
   }
+  return FALSE;
 }
 
+#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
 /*******************************************************************************
  * @fn      zclSampleAppsGp_ProcessDataSendTimeoutCallback
  *
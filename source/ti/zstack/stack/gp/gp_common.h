@@ -193,6 +193,16 @@ extern void gp_endpointInit( uint8_t entity );
  */
 extern gp_DataInd_t* gp_DataIndFindDuplicate(uint8_t handle, uint8_t secLvl);
 
+/*
+ * @brief   Find if a frame duplicates one received in the last gpDuplicateTimeout
+ */
+extern uint8_t gp_DuplicateFilterFind(gp_DataInd_t *gp_DataInd, uint8_t secLvl);
+
+/*
+ * @brief   Remember a received frame for duplicate filtering
+ */
+extern void gp_DuplicateFilterAdd(gp_DataInd_t *gp_DataInd);
+
 /*
  * @brief       General function fill the proxy table vector item
  */
@@ -204,6 +214,36 @@ extern void gp_PopulateField( uint8_t* pField, uint8_t** pData, uint8_t size );
  */
 extern uint8_t gpLookForGpd( uint16_t currEntryId, uint8_t* pNew );
 
+/*
+ * @brief       Write a proxy or sink table entry to NV and keep the RAM
+ *              GPD index of the table in sync.
+ */
+extern uint8_t gp_writeTblEntry( uint16_t nvId, uint16_t nvIndex, uint16_t len, void *pEntry );
+
+/*
+ * @brief       Find the proxy or sink table entry of a GPD using the RAM
+ *              GPD index, returns ZCD_NV_INVALID_INDEX if not found.
+ */
+extern uint16_t gp_TblIndexFindGpd( uint16_t nvId, uint8_t* pNew );
+
+/*
+ * @brief       Find the proxy or sink table entry of a GPD ID using the RAM
+ *              GPD index, returns ZCD_NV_INVALID_INDEX if not found.
+ */
+extern uint16_t gp_TblIndexFindGpdId( uint16_t nvId, gpdID_t* gpdID );
+
+/*
+ * @brief       Find the first empty proxy or sink table entry using the RAM
+ *              GPD index, returns ZCD_NV_INVALID_INDEX if the table is full.
+ */
+extern uint16_t gp_TblIndexFindEmpty( uint16_t nvId );
+
+/*
+ * @brief       Drop the RAM GPD index of a table, it is reloaded from NV
+ *              on next use.
+ */
+extern void gp_TblIndexInvalidate( uint16_t nvId );
+
 /*
  * @brief       Primitive from dGP stub to GP EndPoint asking how to process a GPDF.
  */
@@ -221,7 +261,7 @@ extern void sinkTableCpy(void *dst, void *src);
 
 /*
  * @brief       Process the expiration of the packets in the duplicate filtering
- *              list. Assumption is the first in the queue is the first into expire.
+ *              list, one expiry slot at a time.
  */
 extern void gp_expireDuplicateFiltering(void);
 
@@ -156,9 +156,9 @@ void zclGp_GpPairingCommandCB( zclGpPairing_t *pCmd )
     if(gp_getProxyTableByGpId(&gpdID, currEntry, &proxyTableIndex) == ZSuccess)
     {
       gp_ResetProxyTblEntry(currEntry);
-      zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
-                               PROXY_TBL_LEN,
-                               currEntry);
+      gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
+                                PROXY_TBL_LEN,
+                                currEntry);
     }
     return;
   }
@@ -460,10 +460,10 @@ void zclGp_GpResponseCommandCB(zclGpResponse_t *pCmd)
       if(PROXY_TBL_GET_FIRST_TO_FORWARD(ProxyTableEntryTemp[PROXY_TBL_OPT]) == 0)
       {
         PROXY_TBL_SET_FIRST_TO_FORWARD(&ProxyTableEntryTemp[PROXY_TBL_OPT], TRUE);
-        zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID,
-                        NvProxyTableIndex,
-                        PROXY_TBL_LEN,
-                        &ProxyTableEntryTemp);
+        gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID,
+                         NvProxyTableIndex,
+                         PROXY_TBL_LEN,
+                         &ProxyTableEntryTemp);
       }
     }
     //Depends on TempMasterAddress
@@ -501,10 +501,10 @@ void zclGp_GpResponseCommandCB(zclGpResponse_t *pCmd)
        (PROXY_TBL_GET_FIRST_TO_FORWARD(ProxyTableEntryTemp[PROXY_TBL_OPT]) == 1))
     {
         PROXY_TBL_SET_FIRST_TO_FORWARD(&ProxyTableEntryTemp[PROXY_TBL_OPT], FALSE);
-        zclport_writeNV( ZCL_PORT_PROXY_TABLE_NV_ID,
-                         NvProxyTableIndex,
-                         PROXY_TBL_LEN,
-                         ProxyTableEntryTemp );
+        gp_writeTblEntry( ZCL_PORT_PROXY_TABLE_NV_ID,
+                          NvProxyTableIndex,
+                          PROXY_TBL_LEN,
+                          ProxyTableEntryTemp );
     }
     //Also remove any packet to the GPD
     gp_DataReq->Action = 0;
@@ -604,11 +604,14 @@ uint8_t gp_ProxyTblInit(uint8_t resetTable)
    }
    else if((status == SUCCESS) && (resetTable == TRUE))
    {
-     status = zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID, i,
-                              PROXY_TBL_LEN,
-                              emptyEntry );
+     status = gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID, i,
+                               PROXY_TBL_LEN,
+                               emptyEntry );
    }
  }
+
+ // Items may have been created, reload the GPD index from NV
+ gp_TblIndexInvalidate(ZCL_PORT_PROXY_TABLE_NV_ID);
  return status;
 }
 
@@ -661,53 +664,29 @@ void gp_stopCommissioningMode(void)
  */
 uint8_t gp_getProxyTableByGpId(gpdID_t *gpdID, uint8_t *pEntry, uint16_t *NvProxyTableIndex)
 {
-  uint8_t i;
-  uint8_t status;
+  uint16_t i;
 
   if((pEntry == NULL) || (gpdID == NULL) || (NvProxyTableIndex == NULL))
   {
     return ZFailure;
   }
 
-  for(i = 0; i < GPP_MAX_PROXY_TABLE_ENTRIES ; i++)
+  // Locate the entry from the RAM index, only the matching entry is read
+  i = gp_TblIndexFindGpdId(ZCL_PORT_PROXY_TABLE_NV_ID, gpdID);
+  if(i == ZCD_NV_INVALID_INDEX)
   {
-    status = gp_getProxyTableByIndex(i, pEntry);
-    if(status == NV_OPER_FAILED)
-    {
-      // FAIL
-      return ZFailure;
-    }
-
-    // if the entry is empty
-    if(status == NV_INVALID_DATA)
-    {
-      continue;
-    }
+    return ZInvalidParameter;
+  }
 
-    //Check that App ID is the same
-    if(GP_TBL_COMP_APPLICATION_ID(gpdID->appID, pEntry[PROXY_TBL_OPT]))
-    {
-      if((gpdID->appID == GP_OPT_APP_ID_GPD) &&
-        zcl_memcmp( &gpdID->id.srcID, &pEntry[PROXY_TBL_GPD_ID + 4], sizeof(uint32_t)))
-      {
-        // Entry found
-        *NvProxyTableIndex = i;
-        return ZSuccess;
-      }
-      else if((gpdID->appID == GP_OPT_APP_ID_IEEE) &&
-              zcl_memcmp(&gpdID->id.gpdExtAddr, &pEntry[PROXY_TBL_GPD_ID], Z_EXTADDR_LEN))
-      {
-        // Entry found
-        *NvProxyTableIndex = i;
-        return ZSuccess;
-      }
-    }
-    else
-    {
-      continue;
-    }
+  if(gp_getProxyTableByIndex(i, pEntry) != SUCCESS)
+  {
+    // FAIL
+    return ZFailure;
   }
-  return ZInvalidParameter;
+
+  // Entry found
+  *NvProxyTableIndex = i;
+  return ZSuccess;
 }
 
  /*********************************************************************
@@ -756,7 +735,6 @@ uint8_t gp_getProxyTableByIndex( uint16_t nvIndex, uint8_t *pEntry )
  */
 void gp_dataIndProxy(gp_DataInd_t *gp_DataInd)
 {
-  uint32_t   timeout;
   gpdID_t  gpdID;
   uint8_t    pProxyTableEntry[PROXY_TBL_LEN];
   uint16_t   nvIndex = 0;
@@ -805,29 +783,8 @@ void gp_dataIndProxy(gp_DataInd_t *gp_DataInd)
      }
 
   }
-  gp_DataInd->SecReqHandling.timeout = gpDuplicateTimeout;
-  //Consider the current time elapsed to the next timeout
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-  timeout =  Timer_getTimeout(gpAppExpireDuplicateClkHandle);
-#else
-  timeout = OsalPortTimers_getTimerTimeout(gp_TaskID, GP_DUPLICATE_FILTERING_TIMEOUT_EVENT);
-#endif
-
-  if(timeout > 0x00)
-  {
-    gp_DataInd->SecReqHandling.timeout += timeout;
-  }
-  else
-  {
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-  Timer_setTimeout(gpAppExpireDuplicateClkHandle, gp_DataInd->SecReqHandling.timeout);
-  Timer_start(&gpAppExpireDuplicateClk);
-#else
-  OsalPortTimers_startTimer(gp_TaskID,
-                         GP_DUPLICATE_FILTERING_TIMEOUT_EVENT,
-                         gp_DataInd->SecReqHandling.timeout);
-#endif
-  }
+  //Filter the repetitions of this frame A.3.6.1.2
+  gp_DuplicateFilterAdd(gp_DataInd);
 
   gpdID.appID = gp_DataInd->appID;
   if(gp_DataInd->appID == GP_OPT_APP_ID_IEEE)
@@ -846,9 +803,9 @@ void gp_dataIndProxy(gp_DataInd_t *gp_DataInd)
               (uint8_t*)&gp_DataInd->GPDSecFrameCounter,
               sizeof(uint32_t));
 
-    zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID, nvIndex,
-                     PROXY_TBL_LEN,
-                     pProxyTableEntry);
+    gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID, nvIndex,
+                      PROXY_TBL_LEN,
+                      pProxyTableEntry);
   }
 
   if(zgGP_ProxyCommissioningMode == TRUE)
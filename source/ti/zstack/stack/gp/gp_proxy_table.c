@@ -298,7 +298,6 @@ uint8_t pt_ZclReadGetProxyEntry( uint16_t nvId, uint8_t* pData, uint8_t* len )
  */
 uint8_t gp_UpdateProxyTbl( uint8_t* pEntry, uint32_t options, uint8_t conflictResolution )
 {
-  uint8_t i;
   uint8_t newEntry[PROXY_TBL_LEN];
   uint8_t currEntry[PROXY_TBL_LEN];
   uint16_t proxyTableIndex;
@@ -307,23 +306,19 @@ uint8_t gp_UpdateProxyTbl( uint8_t* pEntry, uint32_t options, uint8_t conflictRe
   // Copy the new entry pointer to array
   proxyTableCpy( &newEntry, pEntry );
 
-  for(i = 0; i < GPP_MAX_PROXY_TABLE_ENTRIES ; i++)
+  proxyTableIndex = gp_TblIndexFindGpd(ZCL_PORT_PROXY_TABLE_NV_ID, newEntry);
+
+  if(proxyTableIndex == ZCD_NV_INVALID_INDEX)
   {
-    proxyTableIndex = i;
-    status = gp_getProxyTableByIndex(proxyTableIndex, currEntry);
-    if(status == NV_OPER_FAILED)
-    {
-      // FAIL
-      return status;
-    }
+    proxyTableIndex = gp_TblIndexFindEmpty(ZCL_PORT_PROXY_TABLE_NV_ID);
 
-    // if the entry is empty
-    if((status == NV_INVALID_DATA) && (GP_PAIRING_OPT_ADD_SINK(options) == TRUE))
+    // if there is an empty entry
+    if((proxyTableIndex != ZCD_NV_INVALID_INDEX) && (GP_PAIRING_OPT_ADD_SINK(options) == TRUE))
     {
       // Save new entry
-      status = zclport_writeNV( ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
-                                PROXY_TBL_LEN,
-                                newEntry );
+      status = gp_writeTblEntry( ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
+                                 PROXY_TBL_LEN,
+                                 newEntry );
 
       // Perform address conflict resolution
       if(zcl_memcmp(&_NIB.nwkDevAddress, &newEntry[PROXY_TBL_ALIAS], sizeof(uint16_t))        ||
@@ -354,16 +349,15 @@ uint8_t gp_UpdateProxyTbl( uint8_t* pEntry, uint32_t options, uint8_t conflictRe
       return status;
     }
 
-    if(gpLookForGpd(proxyTableIndex, newEntry))
-    {
-      // Entry found
-      break;
-    }
-    if(i >= GPP_MAX_PROXY_TABLE_ENTRIES)
-    {
-      // No space for new entries
-      return FAILURE;
-    }
+    // No space for new entries
+    return FAILURE;
+  }
+
+  status = gp_getProxyTableByIndex(proxyTableIndex, currEntry);
+  if(status != SUCCESS)
+  {
+    // FAIL
+    return status;
   }
 
   // Remove the entry
@@ -376,9 +370,9 @@ uint8_t gp_UpdateProxyTbl( uint8_t* pEntry, uint32_t options, uint8_t conflictRe
     {
       gp_ResetProxyTblEntry(currEntry);
     }
-    status = zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
-                             PROXY_TBL_LEN,
-                             currEntry);
+    status = gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
+                              PROXY_TBL_LEN,
+                              currEntry);
     return status;
   }
 
@@ -419,9 +413,9 @@ uint8_t gp_UpdateProxyTbl( uint8_t* pEntry, uint32_t options, uint8_t conflictRe
   zcl_memcpy(&currEntry[PROXY_TBL_SEC_FRAME], &newEntry[PROXY_TBL_SEC_FRAME], sizeof(uint32_t));
   currEntry[PROXY_TBL_RADIUS] = newEntry[PROXY_TBL_RADIUS];
   currEntry[PROXY_TBL_SEARCH_COUNTER] = newEntry[PROXY_TBL_SEARCH_COUNTER];
-  status = zclport_writeNV(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
-                           PROXY_TBL_LEN,
-                           currEntry);
+  status = gp_writeTblEntry(ZCL_PORT_PROXY_TABLE_NV_ID, proxyTableIndex,
+                            PROXY_TBL_LEN,
+                            currEntry);
 
   if (zcl_memcmp(&_NIB.nwkDevAddress, &currEntry[PROXY_TBL_ALIAS], sizeof(uint16_t))        ||
       zcl_memcmp(&_NIB.nwkDevAddress, &currEntry[PROXY_TBL_1ST_GRP_ADDR], sizeof(uint16_t)) ||
@@ -763,10 +763,13 @@ uint8_t gp_SinkTblInit(uint8_t resetTable)
     }
     else if((status == SUCCESS) && (resetTable == TRUE))
     {
-      status = zclport_writeNV(ZCL_PORT_SINK_TABLE_NV_ID, i,
-                               SINK_TBL_ENTRY_LEN, emptyEntry );
+      status = gp_writeTblEntry(ZCL_PORT_SINK_TABLE_NV_ID, i,
+                                SINK_TBL_ENTRY_LEN, emptyEntry );
     }
   }
+
+  // Items may have been created, reload the GPD index from NV
+  gp_TblIndexInvalidate(ZCL_PORT_SINK_TABLE_NV_ID);
   return status;
 }
 
@@ -782,60 +785,31 @@ uint8_t gp_SinkTblInit(uint8_t resetTable)
 */
 uint8_t gp_getSinkTableByGpId(gpdID_t *gpdID, uint8_t *pEntry, uint16_t *NvSinkTableIndex)
 {
- uint8_t i;
- uint8_t status;
+ uint16_t i;
  if((pEntry == NULL) || (gpdID == NULL) || (NvSinkTableIndex == NULL))
  {
    return ZFailure;
  }
 
- // Initialize index as invalid
- *NvSinkTableIndex = ZCD_NV_INVALID_INDEX;
-
- for(i = 0; i < GPS_MAX_SINK_TABLE_ENTRIES ; i++)
+ // Locate the entry from the RAM index, only the matching entry is read
+ i = gp_TblIndexFindGpdId(ZCL_PORT_SINK_TABLE_NV_ID, gpdID);
+ if(i == ZCD_NV_INVALID_INDEX)
  {
-   status = gp_getSinkTableByIndex(i, pEntry);
-
-   if(status == NV_OPER_FAILED)
-   {
-     // FAIL
-     return ZMemError;
-   }
-
-   // if the entry is empty
-   if(status == NV_INVALID_DATA)
-   {
-     if(*NvSinkTableIndex == ZCD_NV_INVALID_INDEX)
-     {
-       *NvSinkTableIndex = i;
-     }
-     continue;
-   }
+   // Return the first empty entry, if any
+   *NvSinkTableIndex = gp_TblIndexFindEmpty(ZCL_PORT_SINK_TABLE_NV_ID);
+   return ZInvalidParameter;
+ }
 
-   //Check that App ID is the same
-   if(GP_TBL_COMP_APPLICATION_ID( gpdID->appID, pEntry[SINK_TBL_OPT]))
-   {
-     if((gpdID->appID == GP_OPT_APP_ID_GPD) &&
-         zcl_memcmp(&gpdID->id.srcID, &pEntry[SINK_TBL_SRC_ID], sizeof(uint32_t)))
-     {
-       // Entry found
-       *NvSinkTableIndex = i;
-       return ZSuccess;
-     }
-     else if((gpdID->appID == GP_OPT_APP_ID_IEEE) &&
-              zcl_memcmp(&gpdID->id.gpdExtAddr, &pEntry[SINK_TBL_GPD_ID], Z_EXTADDR_LEN))
-     {
-       // Entry found
-       *NvSinkTableIndex = i;
-       return ZSuccess;
-     }
-   }
-   else
-   {
-     continue;
-   }
+ if(gp_getSinkTableByIndex(i, pEntry) != SUCCESS)
+ {
+   // FAIL
+   *NvSinkTableIndex = ZCD_NV_INVALID_INDEX;
+   return ZMemError;
  }
- return ZInvalidParameter;
+
+ // Entry found
+ *NvSinkTableIndex = i;
+ return ZSuccess;
 }
 
 /*********************************************************************
@@ -1158,7 +1132,6 @@ uint8_t gp_SecurityOperationSink( gp_SecReq_t* pInd, uint8_t* pKeyType, void* pK
 void gp_dataIndSink(gp_DataInd_t *gpDataInd)
 {
   uint8_t    status;
-  uint32_t   timeout;
   gpdID_t  gpdID;
   uint8_t    sinkTableEntry[SINK_TBL_ENTRY_LEN];
   uint16_t   sinkTableEntryIndex = 0;
@@ -1206,32 +1179,12 @@ void gp_dataIndSink(gp_DataInd_t *gpDataInd)
   }
 
   //Find duplicates A.3.6.1.2 Duplicate filtering
-  if(gp_DataIndFindDuplicate(gpDataInd->SecReqHandling.dGPStubHandle, gpDataInd->GPDFSecLvl))
+  if(gp_DuplicateFilterFind(gpDataInd, gpDataInd->GPDFSecLvl))
   {
     return;
   }
 
-  gpDataInd->SecReqHandling.timeout = gpDuplicateTimeout;
-  //Consider the current time elapsed to the next timeout
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-  timeout =  Timer_getTimeout(gpAppExpireDuplicateClkHandle);
-#else
-  timeout = OsalPortTimers_getTimerTimeout(gp_TaskID, GP_DUPLICATE_FILTERING_TIMEOUT_EVENT);
-#endif
-
-  if(timeout)
-  {
-    gpDataInd->SecReqHandling.timeout += timeout;
-  }
-  else
-  {
-#if (defined (USE_ICALL) || defined (OSAL_PORT2TIRTOS))
-  Timer_setTimeout(gpAppExpireDuplicateClkHandle, gpDataInd->SecReqHandling.timeout );
-  Timer_start(&gpAppExpireDuplicateClk);
-#else
-  OsalPortTimers_startTimer(gp_TaskID, GP_DUPLICATE_FILTERING_TIMEOUT_EVENT, gp_DataInd->SecReqHandling.timeout);
-#endif
-  }
+  gp_DuplicateFilterAdd(gpDataInd);
 
   status = gp_getSinkTableByGpId(&gpdID, sinkTableEntry, &sinkTableEntryIndex);
   if((status == ZSuccess) &&
@@ -1252,8 +1205,8 @@ void gp_dataIndSink(gp_DataInd_t *gpDataInd)
       zcl_buffer_uint32(&sinkTableEntry[SINK_TBL_SEC_FRAME], gpDataInd->GPDSecFrameCounter);
 
       //Update Sec Frame counter to sink table entry
-      zclport_writeNV( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableEntryIndex,
-                       SINK_TBL_ENTRY_LEN, sinkTableEntry );
+      gp_writeTblEntry( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableEntryIndex,
+                        SINK_TBL_ENTRY_LEN, sinkTableEntry );
       secNumber = gpDataInd->GPDSecFrameCounter;
     }
 
@@ -1323,8 +1276,8 @@ void gp_dataIndSink(gp_DataInd_t *gpDataInd)
 
       zclGp_SendGpPairing(pNewSinkEntry, GP_ACTION_EXTEND, gpDataInd->GPDSecFrameCounter, zcl_InSeqNum);
       gp_sinkAddProxyEntry(pNewSinkEntry);
-      status = zclport_writeNV( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableEntryIndex,
-                                SINK_TBL_ENTRY_LEN, pNewSinkEntry );
+      status = gp_writeTblEntry( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableEntryIndex,
+                                 SINK_TBL_ENTRY_LEN, pNewSinkEntry );
 
       zcl_mem_free(pNewSinkEntry);
       // To not process this indication in the proxy side
@@ -1785,9 +1738,9 @@ static ZStatus_t zclGp_GpCommissioningNotificationProcess( zclGpCommissioningNot
        (commissioningCmdPayload.gpdOutCounter > frameCounter))
     {
       zcl_memcpy(&pEntry[SINK_TBL_SEC_FRAME], &commissioningCmdPayload.gpdOutCounter, FRAME_COUNTER_LEN);
-      zclport_writeNV( ZCL_PORT_SINK_TABLE_NV_ID, index,
-                       SINK_TBL_ENTRY_LEN,
-                       pEntry );
+      gp_writeTblEntry( ZCL_PORT_SINK_TABLE_NV_ID, index,
+                        SINK_TBL_ENTRY_LEN,
+                        pEntry );
     }
   }
   // No matches and an empty entry was found
@@ -1945,8 +1898,8 @@ static ZStatus_t zclGp_GpSuccessNotificationProcess( zclGpCommissioningNotificat
     Zstackapi_gpCommissioningSucess(gpAppEntity, &msg);
     zclGp_SendGpPairing(pNewSinkEntry, GP_ACTION_EXTEND, pCmd->securityFrameCounter, zcl_InSeqNum);
     gp_sinkAddProxyEntry(pNewSinkEntry);
-    status = zclport_writeNV(ZCL_PORT_SINK_TABLE_NV_ID, index,
-                             SINK_TBL_ENTRY_LEN, pNewSinkEntry);
+    status = gp_writeTblEntry(ZCL_PORT_SINK_TABLE_NV_ID, index,
+                              SINK_TBL_ENTRY_LEN, pNewSinkEntry);
 
      zcl_mem_free(pNewSinkEntry);
   }
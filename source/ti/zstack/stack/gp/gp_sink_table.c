@@ -409,8 +409,8 @@ uint16_t gp_PairingConfigUpdateSinkTbl( gpPairingConfigCmd_t* payload )
 ZStatus_t gp_commissioningSinkTblUpdate(gpdID_t *gpdId, uint8_t ep, uint8_t deviceId, uint8_t *pEntry, uint16_t nvIndex, gpSinkTableOptions_t sinkOptions, gpdCommissioningCmd_t *pCommissioningCmd)
 {
     gp_commissioningSinkEntryParse(gpdId, ep, deviceId, pEntry, sinkOptions, pCommissioningCmd);
-    return zclport_writeNV( ZCL_PORT_SINK_TABLE_NV_ID, nvIndex,
-                            SINK_TBL_ENTRY_LEN, pEntry );
+    return gp_writeTblEntry( ZCL_PORT_SINK_TABLE_NV_ID, nvIndex,
+                             SINK_TBL_ENTRY_LEN, pEntry );
 }
 
 /*********************************************************************
@@ -543,7 +543,6 @@ void gp_commissioningSinkEntryParse(gpdID_t *gpdId, uint8_t ep, uint8_t deviceId
 
 static uint16_t gp_UpdateSinkTbl( uint8_t* pEntry, uint8_t actions )
 {
-  uint8_t i;
   uint8_t newEntry[SINK_TBL_ENTRY_LEN];
   uint8_t currEntry[SINK_TBL_ENTRY_LEN];
   uint16_t sinkTableIndex;
@@ -552,39 +551,30 @@ static uint16_t gp_UpdateSinkTbl( uint8_t* pEntry, uint8_t actions )
   // Copy the new entry pointer to array
   sinkTableCpy(newEntry, pEntry);
 
-  for (i = 0; i < GPS_MAX_SINK_TABLE_ENTRIES ; i++)
-  {
-    sinkTableIndex = i;
-    status = gp_getSinkTableByIndex(sinkTableIndex, currEntry);
-
-    if (status == NV_OPER_FAILED)
-    {
-      // FAIL
-      return ZCD_NV_INVALID_INDEX;
-    }
+  sinkTableIndex = gp_TblIndexFindGpd(ZCL_PORT_SINK_TABLE_NV_ID, newEntry);
 
-    // if the entry is empty
-    if((status == NV_INVALID_DATA) &&
-       (GP_PAIRING_CONFIG_ACTION_IS_EXTEND(actions) ||
-        GP_PAIRING_CONFIG_ACTION_IS_REPLACE(actions)))
-    {
-      status = zclport_writeNV( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
-                                SINK_TBL_ENTRY_LEN,
-                                newEntry );
-      return sinkTableIndex;
-    }
-
-    if ( gpLookForGpd( sinkTableIndex, newEntry ) )
+  if (sinkTableIndex == ZCD_NV_INVALID_INDEX)
+  {
+    if (GP_PAIRING_CONFIG_ACTION_IS_EXTEND(actions) ||
+        GP_PAIRING_CONFIG_ACTION_IS_REPLACE(actions))
     {
-      // Entry found
-      break;
+      sinkTableIndex = gp_TblIndexFindEmpty(ZCL_PORT_SINK_TABLE_NV_ID);
+      if (sinkTableIndex != ZCD_NV_INVALID_INDEX)
+      {
+        status = gp_writeTblEntry( ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
+                                   SINK_TBL_ENTRY_LEN,
+                                   newEntry );
+      }
     }
+    // Either the new entry index or no space for new entries
+    return sinkTableIndex;
+  }
 
-    if ( i >= GPS_MAX_SINK_TABLE_ENTRIES )
-    {
-      // No space for new entries
-      return ZCD_NV_INVALID_INDEX;
-    }
+  status = gp_getSinkTableByIndex(sinkTableIndex, currEntry);
+  if (status != SUCCESS)
+  {
+    // FAIL
+    return ZCD_NV_INVALID_INDEX;
   }
 
   // Remove the entry
@@ -593,9 +583,9 @@ static uint16_t gp_UpdateSinkTbl( uint8_t* pEntry, uint8_t actions )
   {
       gp_ResetSinkTblEntry( currEntry );
 
-    status = zclport_writeNV(ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
-                             SINK_TBL_ENTRY_LEN,
-                             currEntry);
+    status = gp_writeTblEntry(ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
+                              SINK_TBL_ENTRY_LEN,
+                              currEntry);
     return sinkTableIndex;
   }
 
@@ -621,9 +611,9 @@ static uint16_t gp_UpdateSinkTbl( uint8_t* pEntry, uint8_t actions )
     zcl_memcpy(&currEntry[SINK_TBL_SEC_FRAME], &newEntry[SINK_TBL_SEC_FRAME], sizeof(uint32_t));
   }
 
-  status = zclport_writeNV(ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
-                           PROXY_TBL_LEN,
-                           currEntry);
+  status = gp_writeTblEntry(ZCL_PORT_SINK_TABLE_NV_ID, sinkTableIndex,
+                            SINK_TBL_ENTRY_LEN,
+                            currEntry);
 
   return sinkTableIndex;
 }
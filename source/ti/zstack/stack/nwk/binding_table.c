@@ -63,6 +63,24 @@
 #define NV_BIND_REC_SIZE (gBIND_REC_SIZE)
 #define NV_BIND_ITEM_SIZE  (gBIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES)
 
+// Number of hash chains in each binding table index, must be a power of 2
+#ifndef BIND_INDEX_HASH_SIZE
+#define BIND_INDEX_HASH_SIZE  16
+#endif
+
+#define BIND_INDEX_NONE       0xFFFF
+
+// The (srcEP, clusterId) index has a node per cluster slot of each entry
+#define BIND_INDEX_NODES      ( NWK_MAX_BINDING_ENTRIES * MAX_BINDING_CLUSTER_IDS )
+#define BIND_INDEX_NODE( x, slot )  ( (uint16_t)((x) * MAX_BINDING_CLUSTER_IDS + (slot)) )
+#define BIND_INDEX_ENTRY( node )    ( (node) / MAX_BINDING_CLUSTER_IDS )
+#define BIND_INDEX_SLOT( node )     ( (node) % MAX_BINDING_CLUSTER_IDS )
+
+#define BIND_CLUSTER_HASH( ep, clusterID ) \
+  ( ((clusterID) ^ ((clusterID) >> 8) ^ ((uint16_t)(ep) * 7)) & (BIND_INDEX_HASH_SIZE - 1) )
+#define BIND_DST_HASH( dstIdx ) \
+  ( ((dstIdx) ^ ((dstIdx) >> 4)) & (BIND_INDEX_HASH_SIZE - 1) )
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -92,6 +110,8 @@ BindingEntry_t *bindFindEmpty(  bindTableIndex_t* bindTableIndex  );
 uint16_t bindingAddrMgsHelperFind( zAddrType_t *addr );
 uint8_t bindingAddrMgsHelperConvert( uint16_t idx, zAddrType_t *addr );
 void bindAddrMgrLocalLoad( void );
+static void bindIndexBuild( void );
+static uint16_t bindIndexClusterWalk( uint16_t node, uint8_t ep, uint16_t clusterID );
 
 
 /*********************************************************************
@@ -99,6 +119,22 @@ void bindAddrMgrLocalLoad( void );
  */
 static uint8_t bindAddrMgrLocalLoaded = FALSE;
 
+// Binding table indexes, rebuilt on the first lookup after the table changes.
+// bindClusterHead/Next chain the (entry, cluster slot) nodes by
+// (srcEP, clusterId); bindDstHead/Next chain the entries by dstIdx.  Both
+// keep binding table order within a chain.
+static uint16_t bindClusterHead[BIND_INDEX_HASH_SIZE];
+static uint16_t bindClusterNext[BIND_INDEX_NODES];
+static uint16_t bindDstHead[BIND_INDEX_HASH_SIZE];
+static uint16_t bindDstNext[NWK_MAX_BINDING_ENTRIES];
+static uint8_t bindIndexValid = FALSE;
+static uint8_t bindIndexGen = 0;
+
+// bindFind() state, so that callers walking the matches with an increasing
+// skip count resume from the previous match instead of starting over
+static bindIter_t bindFindIter;
+static uint8_t bindFindSkipped = 0xFF;
+
 /*********************************************************************
  * Function Pointers
  */
@@ -155,6 +191,7 @@ void InitBindingTable( void )
   pBindWriteNV = BindWriteNV;
 
   bindAddrMgrLocalLoaded = FALSE;
+  bindIndexValid = FALSE;
 
 #if ( ADDRMGR_CALLBACK_ENABLED == 1 )
   // Register with the address manager
@@ -434,6 +471,8 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
                      clusterIds,
                      numClusterIds * sizeof(uint16_t) );
 
+        bindIndexValid = FALSE;
+
         // Save the record to NV
         osal_nv_write_ex( ZCD_NV_EX_BINDING_TABLE, bindTableIndex,
                          (uint16_t)NV_BIND_REC_SIZE, &BindingTable[bindTableIndex] );
@@ -461,6 +500,7 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
 byte bindRemoveEntry( BindingEntry_t *pBind )
 {
   memset( pBind, 0xFF, gBIND_REC_SIZE );
+  bindIndexValid = FALSE;
 #ifdef BDB_REPORTING
   bdb_RepUpdateMarkBindings();
 #endif
@@ -531,6 +571,7 @@ byte bindRemoveClusterIdFromList( BindingEntry_t *entry, uint16_t clusterId )
         else
         {
           entry->numClusterIds--;
+          bindIndexValid = FALSE;
 
 #ifdef BDB_REPORTING
            numRemoved++;
@@ -577,6 +618,7 @@ byte bindAddClusterIdToList( BindingEntry_t *entry, uint16_t clusterId )
     // Add the new one
     entry->clusterIdList[entry->numClusterIds] = clusterId;
     entry->numClusterIds++;
+    bindIndexValid = FALSE;
     return ( TRUE );
   }
   return ( FALSE );
@@ -597,7 +639,7 @@ BindingEntry_t *bindFindExisting( byte srcEpInt,
                                   zAddrType_t *dstAddr, byte dstEpInt )
 {
   uint16_t dstIdx;
-  bindTableIndex_t x;
+  uint16_t x;
 
   // Find the records in the assoc list
   if ( dstAddr->addrMode == AddrGroup )
@@ -614,8 +656,10 @@ BindingEntry_t *bindFindExisting( byte srcEpInt,
     return ( (BindingEntry_t *)NULL );
   }
 
-  // Start at the beginning
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  bindIndexBuild();
+
+  // Only the entries with this dstIdx
+  for ( x = bindDstHead[BIND_DST_HASH( dstIdx )]; x != BIND_INDEX_NONE; x = bindDstNext[x] )
   {
     if ( (BindingTable[x].srcEP == srcEpInt) )
     {
@@ -784,20 +828,14 @@ byte bindNumBoundTo( zAddrType_t *devAddr, byte devEpInt, byte srcMode )
  */
 uint16_t bindNumReflections( uint8_t ep, uint16_t clusterID )
 {
-  bindTableIndex_t x;
+  bindIter_t iter;
   BindingEntry_t *pBind;
   uint16_t cnt = 0;
-  uint8_t bindEP;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  for ( pBind = bindFindFirst( &iter, ep, clusterID ); pBind != NULL;
+        pBind = bindFindNext( &iter ) )
   {
-    pBind = &BindingTable[x];
-    bindEP = pBind->srcEP;
-
-    if ( (bindEP == ep) && (bindIsClusterIDinList( pBind, clusterID )) )
-    {
-      cnt++;
-    }
+    cnt++;
   }
 
   return ( cnt );
@@ -818,27 +856,211 @@ uint16_t bindNumReflections( uint8_t ep, uint16_t clusterID )
 BindingEntry_t *bindFind( uint8_t ep, uint16_t clusterID, uint8_t skipping )
 {
   BindingEntry_t *pBind;
-  byte skipped = 0;
+  uint8_t skipped;
+
+  if ( (bindFindSkipped != 0xFF) && (skipping == bindFindSkipped + 1)
+      && (bindFindIter.ep == ep) && (bindFindIter.clusterID == clusterID) )
+  {
+    // Next match of the walk the previous call was part of
+    pBind = bindFindNext( &bindFindIter );
+  }
+  else
+  {
+    pBind = bindFindFirst( &bindFindIter, ep, clusterID );
+    for ( skipped = 0; (skipped < skipping) && (pBind != NULL); skipped++ )
+    {
+      pBind = bindFindNext( &bindFindIter );
+    }
+  }
+
+  bindFindSkipped = ( pBind != NULL ) ? skipping : 0xFF;
+
+  return ( pBind );
+}
+
+/*********************************************************************
+ * @fn          bindFindFirst
+ *
+ * @brief       Starts an iteration over the binding entries for a
+ *              source endpoint and cluster ID, in binding table order.
+ *
+ * @param       pIter - iterator to initialize
+ * @param       ep - source endpoint
+ * @param       clusterID - matching clusterID
+ *
+ * @return      pointer to the first binding table entry, NULL if none
+ */
+BindingEntry_t *bindFindFirst( bindIter_t *pIter, uint8_t ep, uint16_t clusterID )
+{
+  bindIndexBuild();
+
+  pIter->ep = ep;
+  pIter->clusterID = clusterID;
+  pIter->gen = bindIndexGen;
+  pIter->node = bindIndexClusterWalk( bindClusterHead[BIND_CLUSTER_HASH( ep, clusterID )],
+                                      ep, clusterID );
+
+  if ( pIter->node == BIND_INDEX_NONE )
+  {
+    return ( (BindingEntry_t *)NULL );
+  }
+
+  return ( &BindingTable[BIND_INDEX_ENTRY( pIter->node )] );
+}
+
+/*********************************************************************
+ * @fn          bindFindNext
+ *
+ * @brief       Continues an iteration started with bindFindFirst().
+ *              If the table changed since the last call, the iteration
+ *              continues with the entries after the last one returned.
+ *
+ * @param       pIter - iterator
+ *
+ * @return      pointer to the next binding table entry, NULL if none
+ */
+BindingEntry_t *bindFindNext( bindIter_t *pIter )
+{
+  uint16_t node;
+  uint16_t last;
+
+  if ( pIter->node == BIND_INDEX_NONE )
+  {
+    return ( (BindingEntry_t *)NULL );
+  }
+
+  bindIndexBuild();
+
+  if ( pIter->gen == bindIndexGen )
+  {
+    node = bindIndexClusterWalk( bindClusterNext[pIter->node],
+                                 pIter->ep, pIter->clusterID );
+  }
+  else
+  {
+    // The index was rebuilt, skip up to the last entry returned
+    last = BIND_INDEX_ENTRY( pIter->node );
+    node = bindIndexClusterWalk( bindClusterHead[BIND_CLUSTER_HASH( pIter->ep, pIter->clusterID )],
+                                 pIter->ep, pIter->clusterID );
+    while ( (node != BIND_INDEX_NONE) && (BIND_INDEX_ENTRY( node ) <= last) )
+    {
+      node = bindIndexClusterWalk( bindClusterNext[node], pIter->ep, pIter->clusterID );
+    }
+    pIter->gen = bindIndexGen;
+  }
+
+  pIter->node = node;
+
+  if ( node == BIND_INDEX_NONE )
+  {
+    return ( (BindingEntry_t *)NULL );
+  }
+
+  return ( &BindingTable[BIND_INDEX_ENTRY( node )] );
+}
+
+/*********************************************************************
+ * @fn          bindIndexClusterWalk
+ *
+ * @brief       Follows a (srcEP, clusterId) index chain to the first
+ *              node that matches.
+ *
+ * @param       node - first node to check
+ * @param       ep - source endpoint
+ * @param       clusterID - matching clusterID
+ *
+ * @return      matching node, BIND_INDEX_NONE if none
+ */
+static uint16_t bindIndexClusterWalk( uint16_t node, uint8_t ep, uint16_t clusterID )
+{
+  BindingEntry_t *pBind;
+
+  while ( node != BIND_INDEX_NONE )
+  {
+    pBind = &BindingTable[BIND_INDEX_ENTRY( node )];
+    if ( (pBind->srcEP == ep) && (pBind->clusterIdList[BIND_INDEX_SLOT( node )] == clusterID) )
+    {
+      break;
+    }
+    node = bindClusterNext[node];
+  }
+
+  return ( node );
+}
+
+/*********************************************************************
+ * @fn          bindIndexBuild
+ *
+ * @brief       Rebuilds the binding table indexes if the table changed
+ *              since they were last built.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+static void bindIndexBuild( void )
+{
   bindTableIndex_t x;
+  BindingEntry_t *pBind;
+  uint16_t hash;
+  uint16_t node;
+  uint8_t numIds;
+  uint8_t slot;
+  uint8_t prev;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  if ( bindIndexValid )
+  {
+    return;
+  }
+
+  memset( bindClusterHead, 0xFF, sizeof( bindClusterHead ) );
+  memset( bindDstHead, 0xFF, sizeof( bindDstHead ) );
+
+  // Walk backwards and push to the front so chains are in table order
+  x = gNWK_MAX_BINDING_ENTRIES;
+  while ( x-- > 0 )
   {
     pBind = &BindingTable[x];
+    if ( pBind->srcEP == NV_BIND_EMPTY )
+    {
+      continue;
+    }
+
+    hash = BIND_DST_HASH( pBind->dstIdx );
+    bindDstNext[x] = bindDstHead[hash];
+    bindDstHead[hash] = x;
+
+    numIds = pBind->numClusterIds;
+    if ( numIds > MAX_BINDING_CLUSTER_IDS )
+    {
+      numIds = MAX_BINDING_CLUSTER_IDS;
+    }
 
-    if ( ( pBind->srcEP == ep) && bindIsClusterIDinList( pBind, clusterID ))
+    slot = numIds;
+    while ( slot-- > 0 )
     {
-      if ( skipped < skipping )
+      // A cluster listed twice in an entry is indexed once
+      for ( prev = 0; prev < slot; prev++ )
       {
-        skipped++;
+        if ( pBind->clusterIdList[prev] == pBind->clusterIdList[slot] )
+        {
+          break;
+        }
       }
-      else
+      if ( prev < slot )
       {
-        return ( pBind );
+        continue;
       }
+
+      node = BIND_INDEX_NODE( x, slot );
+      hash = BIND_CLUSTER_HASH( pBind->srcEP, pBind->clusterIdList[slot] );
+      bindClusterNext[node] = bindClusterHead[hash];
+      bindClusterHead[hash] = node;
     }
   }
 
-  return ( (BindingEntry_t *)NULL );
+  bindIndexGen++;
+  bindIndexValid = TRUE;
 }
 
 /*********************************************************************
@@ -853,12 +1075,14 @@ BindingEntry_t *bindFind( uint8_t ep, uint16_t clusterID, uint8_t skipping )
  */
 void bindAddressClear( uint16_t dstIdx )
 {
-  bindTableIndex_t i;
+  uint16_t i;
 
   if ( dstIdx != INVALID_NODE_ADDR )
   {
+    bindIndexBuild();
+
     // Looks for a specific Idx
-    for ( i = 0; i < gNWK_MAX_BINDING_ENTRIES; i++ )
+    for ( i = bindDstHead[BIND_DST_HASH( dstIdx )]; i != BIND_INDEX_NONE; i = bindDstNext[i] )
     {
       if ( ( BindingTable[i].dstGroupMode != AddrGroup ) &&
            ( BindingTable[i].dstGroupMode == DSTGROUPMODE_ADDR ) &&
@@ -868,7 +1092,7 @@ void bindAddressClear( uint16_t dstIdx )
       }
     }
 
-    if ( i == gNWK_MAX_BINDING_ENTRIES )
+    if ( i == BIND_INDEX_NONE )
     {
       // No binding entry is associated with dstIdx.
       // Remove user binding bit from the address manager entry corresponding to dstIdx.
@@ -897,7 +1121,7 @@ void bindUpdateAddr( uint16_t oldAddr, uint16_t newAddr )
   uint16_t oldIdx;
   uint16_t newIdx;
   zAddrType_t addr;
-  bindTableIndex_t x;
+  uint16_t x;
   BindingEntry_t *pBind;
 
   addr.addrMode = Addr16Bit;
@@ -906,13 +1130,22 @@ void bindUpdateAddr( uint16_t oldAddr, uint16_t newAddr )
   addr.addr.shortAddr = newAddr;
   newIdx = bindingAddrMgsHelperFind( &addr );
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  if ( oldIdx == newIdx )
+  {
+    return;
+  }
+
+  bindIndexBuild();
+
+  // The chain links are left alone until the next rebuild
+  for ( x = bindDstHead[BIND_DST_HASH( oldIdx )]; x != BIND_INDEX_NONE; x = bindDstNext[x] )
   {
     pBind = &BindingTable[x];
 
     if ( pBind->dstIdx == oldIdx )
     {
       pBind->dstIdx = newIdx;
+      bindIndexValid = FALSE;
     }
   }
 }
@@ -1203,6 +1436,8 @@ uint16_t BindRestoreFromNV( void )
       }
     }
   }
+  bindIndexValid = FALSE;
+
   return ( validRecsCount );
 }
 
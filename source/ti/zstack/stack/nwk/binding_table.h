@@ -97,6 +97,16 @@ typedef struct
                       // gMAX_BINDING_CLUSTER_IDS
 } BindingEntry_t;
 
+// Iterator over the binding entries of a source endpoint and cluster ID,
+// see bindFindFirst() and bindFindNext().  The fields are private.
+typedef struct
+{
+  uint8_t  ep;
+  uint16_t clusterID;
+  uint16_t node;          // Index node of the current entry
+  uint8_t  gen;           // Index generation the node belongs to
+} bindIter_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -167,6 +177,18 @@ extern uint16_t bindNumReflections( uint8_t ep, uint16_t clusterID );
  */
 extern BindingEntry_t *bindFind( uint8_t ep, uint16_t clusterID, uint8_t skipping );
 
+/*
+ * Start an iteration over the binding entries for a source endpoint and
+ * cluster ID, in binding table order.  Returns the first entry or NULL.
+ */
+extern BindingEntry_t *bindFindFirst( bindIter_t *pIter, uint8_t ep, uint16_t clusterID );
+
+/*
+ * Continue an iteration started with bindFindFirst().  Returns the next
+ * entry or NULL.  Entries may be added or removed between calls.
+ */
+extern BindingEntry_t *bindFindNext( bindIter_t *pIter );
+
 /*
  * Lookup a binding entry by specific Idx, if none is found
  * clears the BINDING user from Address Manager.
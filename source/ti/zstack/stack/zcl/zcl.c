@@ -145,6 +145,10 @@ typedef struct zclClusterOptionList
   zclOptionRec_t              *options;   // option records
 } zclClusterOptionList;
 
+// Writes a command payload directly into the outgoing frame buffer and
+// returns the number of bytes written
+typedef uint16_t (*zclSerializeCB_t)( uint8_t *pBuf, void *pParam );
+
 typedef void *(*zclParseInProfileCmd_t)( zclParseCmd_t *pCmd );
 typedef uint8_t (*zclProcessInProfileCmd_t)( zclIncoming_t *pInMsg );
 
@@ -155,6 +159,18 @@ typedef struct
 } zclCmdItems_t;
 
 
+#ifdef ZCL_READ
+// Read Attributes command, resolved against the endpoint's sorted
+// attribute list once to size the response and again to serialize it
+typedef struct
+{
+  zclIncoming_t   *pInMsg;
+  zclAttrRecsList *pRec;
+  uint8_t          numAttr;
+  uint16_t        *pAttrID;
+} zclReadBatch_t;
+#endif // ZCL_READ
+
 // List record for external handler for unhandled ZCL Foundation commands/rsps
 typedef struct zclExternalFoundationHandlerList
 {
@@ -226,6 +242,12 @@ struct zclSendExtParam
  */
 static uint8_t *zclBuildHdr( zclFrameHdr_t *hdr, uint8_t *pData );
 static uint8_t zclCalcHdrSize( zclFrameHdr_t *hdr );
+static ZStatus_t zclSendCommandBuf( uint8_t srcEP, afAddrType_t *destAddr,
+                                    uint16_t clusterID, uint8_t cmd, uint8_t specific, uint8_t direction,
+                                    uint8_t disableDefaultRsp, uint16_t manuCode, uint8_t seqNum,
+                                    uint16_t cmdFormatLen, uint8_t *cmdFormat,
+                                    zclSerializeCB_t pfnSerialize, void *pSerializeParam,
+                                    uint8_t isReqFromApp );
 static zclLibPlugin_t *zclFindPlugin( uint16_t clusterID, uint16_t profileID );
 
 #if !defined ( ZCL_STANDALONE )
@@ -238,6 +260,10 @@ static uint8_t zcl_getExternalFoundationHandler( uint8_t endPointId );
 #endif
 
 zclAttrRecsList *zclFindAttrRecsList( uint8_t endpoint );
+static void zclBuildAttrRecsIndex( zclAttrRecsList *pRecsList );
+static uint8_t zclAttrRecsLowerBound( zclAttrRecsList *pRecsList, uint8_t start, uint16_t clusterID, uint16_t attrId );
+static CONST zclAttrRec_t *zclFindAttrRecInList( zclAttrRecsList *pRec, uint8_t *pPos, uint16_t clusterID, uint16_t manuCode,
+                                                 uint8_t direction, uint16_t attrId );
 static zclOptionRec_t *zclFindClusterOption( uint8_t endpoint, uint16_t clusterID );
 static uint8_t zclGetClusterOption( uint8_t endpoint, uint16_t clusterID );
 static void zclSetSecurityOption( uint8_t endpoint, uint16_t clusterID, uint8_t enable );
@@ -257,6 +283,9 @@ static ZStatus_t zclReadAttrDataUsingCB( uint8_t endpoint, zclAttrRec_t *pAttr,
 static ZStatus_t zclAuthorizeRead( uint8_t endpoint, afAddrType_t *srcAddr, zclAttrRec_t *pAttr );
 static void *zclParseInReadRspCmd( zclParseCmd_t *pCmd );
 static uint8_t zclProcessInReadCmd( zclIncoming_t *pInMsg );
+static CONST zclAttrRec_t *zclReadBatchFind( zclReadBatch_t *pBatch, uint8_t i,
+                                            uint8_t *pPos, uint16_t *pPrevAttrId );
+static uint16_t zclSerializeReadBatch( uint8_t *pBuf, void *pParam );
 #endif // ZCL_READ
 
 #ifdef ZCL_WRITE
@@ -887,6 +916,11 @@ ZStatus_t zcl_registerAttrList( uint8_t endpoint, uint8_t numAttr, CONST zclAttr
   pNewItem->pfnAuthorizeCB = NULL;
   pNewItem->numAttributes = numAttr;
   pNewItem->attrs = newAttrList;
+  pNewItem->pAttrIdx = NULL;
+
+  // Build the lookup index once, zclFindAttrRecEx() falls back to a
+  // linear scan if there is no memory for it
+  zclBuildAttrRecsIndex( pNewItem );
 
   // Find spot in list
   if ( attrList == NULL )
@@ -1222,6 +1256,42 @@ ZStatus_t zcl_SendCommandEx( uint8_t srcEP, afAddrType_t *destAddr,
                            uint16_t clusterID, uint8_t cmd, uint8_t specific, uint8_t direction,
                            uint8_t disableDefaultRsp, uint16_t manuCode, uint8_t seqNum,
                            uint16_t cmdFormatLen, uint8_t *cmdFormat, uint8_t isReqFromApp )
+{
+  return ( zclSendCommandBuf( srcEP, destAddr, clusterID, cmd, specific, direction,
+                              disableDefaultRsp, manuCode, seqNum, cmdFormatLen,
+                              cmdFormat, NULL, NULL, isReqFromApp ) );
+}
+
+/*********************************************************************
+ * @fn      zclSendCommandBuf
+ *
+ * @brief   Build the ZCL frame and hand it to AF. The command payload is
+ *          either copied from cmdFormat or, when pfnSerialize is given,
+ *          written by it straight into the frame buffer passed to AF.
+ *
+ * @param   srcEp - source endpoint
+ * @param   destAddr - destination address
+ * @param   clusterID - cluster ID
+ * @param   cmd - command ID
+ * @param   specific - whether the command is Cluster Specific
+ * @param   direction - client/server direction of the command
+ * @param   disableDefaultRsp - disable Default Response command
+ * @param   manuCode - manufacturer code for proprietary extensions to a profile
+ * @param   seqNumber - identification number for the transaction
+ * @param   cmdFormatLen - length of the command to be sent
+ * @param   cmdFormat - command to be sent, unused if pfnSerialize is set
+ * @param   pfnSerialize - writes at most cmdFormatLen bytes of payload, or NULL
+ * @param   pSerializeParam - parameter passed to pfnSerialize
+ * @param   isReqFromApp - Indicates where it comes from application thread or stack thread
+ *
+ * @return  ZSuccess if OK
+ */
+static ZStatus_t zclSendCommandBuf( uint8_t srcEP, afAddrType_t *destAddr,
+                                    uint16_t clusterID, uint8_t cmd, uint8_t specific, uint8_t direction,
+                                    uint8_t disableDefaultRsp, uint16_t manuCode, uint8_t seqNum,
+                                    uint16_t cmdFormatLen, uint8_t *cmdFormat,
+                                    zclSerializeCB_t pfnSerialize, void *pSerializeParam,
+                                    uint8_t isReqFromApp )
 {
   endPointDesc_t *epDesc;
   zclFrameHdr_t hdr;
@@ -1346,7 +1416,14 @@ ZStatus_t zcl_SendCommandEx( uint8_t srcEP, afAddrType_t *destAddr,
     pBuf = zclBuildHdr( &hdr, msgBuf );
 
     // Fill in the command frame
-    zcl_memcpy( pBuf, cmdFormat, cmdFormatLen );
+    if ( pfnSerialize != NULL )
+    {
+      msgLen = (uint16_t)( pBuf - msgBuf ) + pfnSerialize( pBuf, pSerializeParam );
+    }
+    else
+    {
+      zcl_memcpy( pBuf, cmdFormat, cmdFormatLen );
+    }
 
     if(isReqFromApp)
     {
@@ -2913,8 +2990,47 @@ zclAttrRecsList *zclFindAttrRecsList( uint8_t endpoint )
  */
 uint8_t zclFindAttrRecEx( uint8_t endpoint, uint16_t clusterID, uint16_t manuCode, uint8_t direction, uint16_t attrId, zclAttrRec_t *pAttr )
 {
-  uint8_t x;
   zclAttrRecsList *pRec = zclFindAttrRecsList( endpoint );
+  CONST zclAttrRec_t *pFound;
+  uint8_t pos = 0;
+
+  if ( pRec != NULL )
+  {
+    pFound = zclFindAttrRecInList( pRec, &pos, clusterID, manuCode, direction, attrId );
+    if ( pFound != NULL )
+    {
+      *pAttr = *pFound;
+
+      return ( TRUE ); // EMBEDDED RETURN
+    }
+  }
+
+  return ( FALSE );
+}
+
+/*********************************************************************
+ * @fn      zclFindAttrRecInList
+ *
+ * @brief   Find the attribute record that matchs the parameters in an
+ *          endpoint's attribute record list.
+ *
+ * @param   pRec - attribute record list of the endpoint
+ * @param   pPos - in: index position to start searching from, every
+ *                 record before it must sort below the key.
+ *                 out: index position of the first record not below
+ *                 the key, so ascending lookups can continue from it.
+ * @param   clusterID - cluster ID
+ * @param   manuCode - manufacturer code
+ * @param   direction - the direction of attribute
+ * @param   attrId - attribute looking for
+ *
+ * @return  pointer to the registered record, NULL if not found
+ */
+static CONST zclAttrRec_t *zclFindAttrRecInList( zclAttrRecsList *pRec, uint8_t *pPos, uint16_t clusterID, uint16_t manuCode,
+                                                 uint8_t direction, uint16_t attrId )
+{
+  uint8_t x;
+  uint16_t i;
   uint8_t matchManuCode = FALSE;
 
   // match manufacturer-cluster, fixed by luoyiming 2020-01-08
@@ -2924,30 +3040,141 @@ uint8_t zclFindAttrRecEx( uint8_t endpoint, uint16_t clusterID, uint16_t manuCod
     matchManuCode = TRUE;
   }
 
-  if ( pRec != NULL )
+  // Records with the same cluster ID and attribute ID are adjacent in the
+  // index and keep their registration order, so the first one that passes
+  // the manufacturer and direction checks is the same record the linear
+  // scan would return.
+  i = 0;
+  if ( pRec->pAttrIdx != NULL )
   {
-    for ( x = 0; x < pRec->numAttributes; x++ )
+    *pPos = zclAttrRecsLowerBound( pRec, *pPos, clusterID, attrId );
+    i = *pPos;
+  }
+
+  for ( ; i < pRec->numAttributes; i++ )
+  {
+    x = ( pRec->pAttrIdx != NULL ) ? pRec->pAttrIdx[i] : (uint8_t)i;
+
+    if ( pRec->pAttrIdx != NULL &&
+         ( pRec->attrs[x].clusterID != clusterID || pRec->attrs[x].attr.attrId != attrId ) )
     {
-      // match manufacturer attribute at first, luoyiming 2020-01-08
-      if ( ( pRec->attrs[x].attr.accessControl & ACCESS_MANU_ATTR ) && matchManuCode == FALSE )
+      break; // past the matching run
+    }
+
+    // match manufacturer attribute at first, luoyiming 2020-01-08
+    if ( ( pRec->attrs[x].attr.accessControl & ACCESS_MANU_ATTR ) && matchManuCode == FALSE )
+    {
+      continue;
+    }
+    if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
+    {
+      //match direction, fixed by luoyiming 2019-11-16
+      if ( (pRec->attrs[x].attr.accessControl & ACCESS_GLOBAL) ||
+           ( GET_BIT( &(pRec->attrs[x].attr.accessControl), ACCESS_CONTROL_MASK ) == direction ) )
       {
-        continue;
+        return ( &(pRec->attrs[x]) ); // EMBEDDED RETURN
       }
-      if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
-      {
-        //match direction, fixed by luoyiming 2019-11-16
-        if ( (pRec->attrs[x].attr.accessControl & ACCESS_GLOBAL) ||
-             ( GET_BIT( &(pRec->attrs[x].attr.accessControl), ACCESS_CONTROL_MASK ) == direction ) )
-        {
-          *pAttr = pRec->attrs[x];
+    }
+  }
 
-          return ( TRUE ); // EMBEDDED RETURN
-        }
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      zclBuildAttrRecsIndex
+ *
+ * @brief   Build the sorted lookup index of an attribute record list.
+ *          Record indexes are ordered by cluster ID, then attribute ID,
+ *          then position in the registered array (insertion sort is
+ *          stable and runs once per registration).
+ *
+ * @param   pRecsList - attribute record list to index
+ *
+ * @return  none
+ */
+static void zclBuildAttrRecsIndex( zclAttrRecsList *pRecsList )
+{
+  uint8_t i;
+  uint8_t j;
+  uint8_t cur;
+  CONST zclAttrRec_t *pAttrs = pRecsList->attrs;
+
+  if ( pRecsList->pAttrIdx != NULL )
+  {
+    zcl_mem_free( pRecsList->pAttrIdx );
+    pRecsList->pAttrIdx = NULL;
+  }
+
+  if ( pRecsList->numAttributes == 0 )
+  {
+    return;
+  }
+
+  pRecsList->pAttrIdx = zcl_mem_alloc( pRecsList->numAttributes );
+  if ( pRecsList->pAttrIdx == NULL )
+  {
+    return;
+  }
+
+  for ( i = 0; i < pRecsList->numAttributes; i++ )
+  {
+    cur = i;
+    j = i;
+
+    while ( j > 0 )
+    {
+      uint8_t prev = pRecsList->pAttrIdx[j - 1];
+
+      if ( ( pAttrs[prev].clusterID < pAttrs[cur].clusterID ) ||
+           ( ( pAttrs[prev].clusterID == pAttrs[cur].clusterID ) &&
+             ( pAttrs[prev].attr.attrId <= pAttrs[cur].attr.attrId ) ) )
+      {
+        break;
       }
+
+      pRecsList->pAttrIdx[j] = prev;
+      j--;
     }
+
+    pRecsList->pAttrIdx[j] = cur;
   }
+}
 
-  return ( FALSE );
+/*********************************************************************
+ * @fn      zclAttrRecsLowerBound
+ *
+ * @brief   Binary search the sorted index for the first record whose
+ *          (cluster ID, attribute ID) is not less than the given key.
+ *
+ * @param   pRecsList - indexed attribute record list
+ * @param   start - index position to start searching from
+ * @param   clusterID - cluster ID
+ * @param   attrId - attribute ID
+ *
+ * @return  position in pAttrIdx, numAttributes if all records are less
+ */
+static uint8_t zclAttrRecsLowerBound( zclAttrRecsList *pRecsList, uint8_t start, uint16_t clusterID, uint16_t attrId )
+{
+  uint16_t low = start;
+  uint16_t high = pRecsList->numAttributes;
+
+  while ( low < high )
+  {
+    uint16_t mid = ( low + high ) / 2;
+    CONST zclAttrRec_t *pAttr = &(pRecsList->attrs[pRecsList->pAttrIdx[mid]]);
+
+    if ( ( pAttr->clusterID < clusterID ) ||
+         ( ( pAttr->clusterID == clusterID ) && ( pAttr->attr.attrId < attrId ) ) )
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  return ( (uint8_t)low );
 }
 
 #if defined ( ZCL_STANDALONE )
@@ -2974,6 +3201,7 @@ uint8_t zclSetAttrRecList( uint8_t endpoint, uint8_t numAttr, CONST zclAttrRec_t
   {
     pRecsList->numAttributes = numAttr;
     pRecsList->attrs = attrList;
+    zclBuildAttrRecsIndex( pRecsList );
     return ( TRUE );
   }
 
@@ -4771,70 +4999,159 @@ static void *zclParseInDiscAttrsExtRspCmd( zclParseCmd_t *pCmd )
 static uint8_t zclProcessInReadCmd( zclIncoming_t *pInMsg )
 {
   zclReadCmd_t *readCmd;
-  zclReadRspCmd_t *readRspCmd;
+  zclReadBatch_t batch;
+  CONST zclAttrRec_t *pAttr;
   zclAttrRec_t attrRec;
-  uint16_t len;
+  uint16_t len = 0;
+  uint8_t pos = 0;
+  uint16_t prevAttrId = 0;
   uint8_t i;
-  uint8_t attrFound;
 
   readCmd = (zclReadCmd_t *)pInMsg->attrCmd;
 
-  // calculate the length of the response status record
-  len = sizeof( zclReadRspCmd_t ) + (readCmd->numAttr * sizeof( zclReadRspStatus_t ));
-
-  readRspCmd = zcl_mem_alloc( len );
-  if ( readRspCmd == NULL )
-  {
-    return FALSE; // EMBEDDED RETURN
-  }
+  batch.pInMsg = pInMsg;
+  batch.pRec = zclFindAttrRecsList( pInMsg->msg->endPoint );
+  batch.numAttr = readCmd->numAttr;
+  batch.pAttrID = readCmd->attrID;
 
-  readRspCmd->numAttr = readCmd->numAttr;
+  // Size the response. Authorization is only checked while serializing,
+  // so this is an upper bound: a record that fails it is status only.
   for ( i = 0; i < readCmd->numAttr; i++ )
   {
-    zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
+    len += 2 + 1; // Attribute ID + Status
 
-    statusRec->attrID = readCmd->attrID[i];
-    
-    attrFound = zclFindAttrRecEx( pInMsg->msg->endPoint, pInMsg->msg->clusterId, pInMsg->hdr.manuCode,
-                                  pInMsg->hdr.fc.direction, readCmd->attrID[i], &attrRec );//match manucode and direction, fixed by luoyiming 2019-11-16
-    
-    //Validate the attribute is found and the access control
-    if ( attrFound == TRUE ) //direction has been matched in zclFindAttrRecEx, fixed by luoyiming 2019-11-16
+    pAttr = zclReadBatchFind( &batch, i, &pos, &prevAttrId );
+    if ( ( pAttr != NULL ) && zcl_AccessCtrlRead( pAttr->attr.accessControl ) )
     {
-      if ( zcl_AccessCtrlRead( attrRec.attr.accessControl ) )
+      attrRec = *pAttr;
+
+      len++; // Attribute Data Type length
+
+      // Attribute Data length
+      if ( attrRec.attr.dataPtr != NULL )
       {
-        statusRec->status = zclAuthorizeRead( pInMsg->msg->endPoint,
-                                              &(pInMsg->msg->srcAddr), &attrRec );
-        if ( statusRec->status == ZCL_STATUS_SUCCESS )
-        {
-          statusRec->data = attrRec.attr.dataPtr;
-          statusRec->dataType = attrRec.attr.dataType;
-          // fixed by luoyiming, 2020-01-07
-          if ( statusRec->data == NULL )
-          {
-            // record attribute pointer for NULL attribute, luoyiming 2020-01-07
-            statusRec->pAttr = &attrRec;
-          }
-        }
+        len += zclGetAttrDataLength( attrRec.attr.dataType, attrRec.attr.dataPtr );
       }
       else
       {
-        statusRec->status = ZCL_STATUS_WRITE_ONLY;
+        len += zclGetAttrDataLengthUsingCB( pInMsg->msg->endPoint, &attrRec );
       }
     }
+  }
+
+  // Build and send Read Response command, the records are resolved again
+  // and serialized straight into the frame buffer handed to AF
+  zclSendCommandBuf( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr), pInMsg->msg->clusterId,
+                     ZCL_CMD_READ_RSP, FALSE, !pInMsg->hdr.fc.direction, true,
+                     pInMsg->hdr.manuCode, pInMsg->hdr.transSeqNum, len, NULL,
+                     zclSerializeReadBatch, &batch, TRUE );
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      zclReadBatchFind
+ *
+ * @brief   Find the registered record of one attribute of a Read
+ *          Attributes command. Ascending attribute IDs (the usual case)
+ *          continue the index search from the previous hit instead of
+ *          the start of the list.
+ *
+ * @param   pBatch - Read Attributes command being processed
+ * @param   i - index of the attribute in the command
+ * @param   pPos - search position, 0 before the first attribute
+ * @param   pPrevAttrId - previous attribute ID, 0 before the first attribute
+ *
+ * @return  registered record, NULL if unsupported
+ */
+static CONST zclAttrRec_t *zclReadBatchFind( zclReadBatch_t *pBatch, uint8_t i,
+                                            uint8_t *pPos, uint16_t *pPrevAttrId )
+{
+  zclIncoming_t *pInMsg = pBatch->pInMsg;
+
+  if ( pBatch->pAttrID[i] < *pPrevAttrId )
+  {
+    *pPos = 0;
+  }
+  *pPrevAttrId = pBatch->pAttrID[i];
+
+  if ( pBatch->pRec == NULL )
+  {
+    return ( NULL );
+  }
+
+  //match manucode and direction, fixed by luoyiming 2019-11-16
+  return ( zclFindAttrRecInList( pBatch->pRec, pPos, pInMsg->msg->clusterId, pInMsg->hdr.manuCode,
+                                 pInMsg->hdr.fc.direction, pBatch->pAttrID[i] ) );
+}
+
+/*********************************************************************
+ * @fn      zclSerializeReadBatch
+ *
+ * @brief   Resolve the attributes of a Read Attributes command and
+ *          serialize them as Read Attributes Response records.
+ *
+ * @param   pBuf - where to write the response records
+ * @param   pParam - pointer to the zclReadBatch_t built by zclProcessInReadCmd
+ *
+ * @return  number of bytes written
+ */
+static uint16_t zclSerializeReadBatch( uint8_t *pBuf, void *pParam )
+{
+  zclReadBatch_t *pBatch = (zclReadBatch_t *)pParam;
+  zclIncoming_t *pInMsg = pBatch->pInMsg;
+  uint8_t *pStart = pBuf;
+  CONST zclAttrRec_t *pAttr;
+  zclAttrRec_t attrRec;
+  uint8_t status;
+  uint8_t pos = 0;
+  uint16_t prevAttrId = 0;
+  uint8_t i;
+
+  for ( i = 0; i < pBatch->numAttr; i++ )
+  {
+    pAttr = zclReadBatchFind( pBatch, i, &pos, &prevAttrId );
+
+    //Validate the attribute is found and the access control
+    if ( pAttr == NULL )
+    {
+      status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+    else if ( zcl_AccessCtrlRead( pAttr->attr.accessControl ) )
+    {
+      attrRec = *pAttr;
+      status = zclAuthorizeRead( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr), &attrRec );
+    }
     else
     {
-      statusRec->status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+      status = ZCL_STATUS_WRITE_ONLY;
     }
-  }
 
-  // Build and send Read Response command
-  zcl_SendReadRsp( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr), pInMsg->msg->clusterId,
-                   readRspCmd, !pInMsg->hdr.fc.direction, true,
-                   pInMsg->hdr.manuCode, pInMsg->hdr.transSeqNum );
-  zcl_mem_free( readRspCmd );
+    *pBuf++ = LO_UINT16( pBatch->pAttrID[i] );
+    *pBuf++ = HI_UINT16( pBatch->pAttrID[i] );
+    *pBuf++ = status;
 
-  return TRUE;
+    if ( status == ZCL_STATUS_SUCCESS )
+    {
+      *pBuf++ = attrRec.attr.dataType;
+
+      if ( attrRec.attr.dataPtr != NULL )
+      {
+        // Copy attribute data to the buffer to be sent out
+        pBuf = zclSerializeData( attrRec.attr.dataType, attrRec.attr.dataPtr, pBuf );
+      }
+      else
+      {
+        uint16_t dataLen;
+
+        // Read attribute data directly into the buffer to be sent out
+        zclReadAttrDataUsingCB( pInMsg->msg->endPoint, &attrRec, pBuf, &dataLen );
+        pBuf += dataLen;
+      }
+    }
+  }
+
+  return ( (uint16_t)( pBuf - pStart ) );
 }
 #endif // ZCL_READ
 
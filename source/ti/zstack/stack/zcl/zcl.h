@@ -1198,6 +1198,7 @@ typedef struct zclAttrRecsList
   zclAuthorizeCB_t       pfnAuthorizeCB;//!< Authorize Read or Write operation
   uint8_t                  numAttributes; //!< Number of the following records
   CONST zclAttrRec_t     *attrs;        //!< attribute records
+  uint8_t                  *pAttrIdx;     //!< record indexes sorted by cluster ID and attribute ID, NULL if not built
 } zclAttrRecsList;
 
 /*!
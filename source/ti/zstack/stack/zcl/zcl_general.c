@@ -62,9 +62,22 @@
 #define zclGeneral_ScenesRemaingCapacity() ( ZCL_GEN_MAX_SCENES - zclGeneral_CountAllScenes() )
 #endif // ZCL_SCENES
 
+#ifdef ZCL_ALARMS
+// Index bucket of an (alarmCode, clusterID) pair
+#define zclGeneral_AlarmHashKey( code, clusterID ) \
+  ( ( (code) ^ LO_UINT16( clusterID ) ^ HI_UINT16( clusterID ) ) & ( ZCL_GEN_ALARM_HASH_SIZE - 1 ) )
+#endif // ZCL_ALARMS
+
 /*********************************************************************
  * CONSTANTS
  */
+// Number of (alarmCode, clusterID) index buckets per endpoint, power of 2
+#if !defined ( ZCL_GEN_ALARM_HASH_SIZE )
+#define ZCL_GEN_ALARM_HASH_SIZE    8
+#endif
+
+// Empty index bucket / end of bucket chain
+#define ZCL_GEN_ALARM_NONE         0xFF
 
 /*********************************************************************
  * TYPEDEFS
@@ -83,12 +96,25 @@ typedef struct zclGenSceneItem
   zclGeneral_Scene_t        scene;    // Scene info
 } zclGenSceneItem_t;
 
-typedef struct zclGenAlarmItem
+typedef struct
 {
-  struct zclGenAlarmItem    *next;
-  uint8_t                     endpoint; // Used to link it into the endpoint descriptor
+  uint8_t                     inUse;    // FALSE once the alarm has been reset
+  uint8_t                     hashNext; // Next slot in the same index bucket
   zclGeneral_Alarm_t        alarm;    // Alarm info
-} zclGenAlarmItem_t;
+} zclGenAlarmSlot_t;
+
+// Alarm table of one endpoint: a ring of slots kept in insertion order, so
+// the earliest alarm is always found at the head
+typedef struct zclGenAlarmRing
+{
+  struct zclGenAlarmRing    *next;
+  uint8_t                     endpoint; // Used to link it into the endpoint descriptor
+  uint8_t                     head;     // Slot of the earliest alarm
+  uint8_t                     span;     // Slots from head to tail, including reset ones
+  uint8_t                     count;    // Alarms in the table
+  uint8_t                     hash[ZCL_GEN_ALARM_HASH_SIZE]; // (alarmCode, clusterID) index
+  zclGenAlarmSlot_t         slot[ZCL_GEN_MAX_ALARMS];
+} zclGenAlarmRing_t;
 
 // Scene NV types
 typedef struct
@@ -124,7 +150,7 @@ static ZStatus_t (*zclGenUnsupportCallback)(zclIncoming_t* pInMsg) = NULL;
 #endif // ZCL_SCENES
 
 #ifdef ZCL_ALARMS
-static zclGenAlarmItem_t *zclGenAlarmTable = (zclGenAlarmItem_t *)NULL;
+static zclGenAlarmRing_t *zclGenAlarmTable = (zclGenAlarmRing_t *)NULL;
 #endif // ZCL_ALARMS
 
 /*********************************************************************
@@ -168,6 +194,11 @@ static ZStatus_t zclGeneral_ProcessInLevelControl( zclIncoming_t *pInMsg, zclGen
 #ifdef ZCL_ALARMS
 static ZStatus_t zclGeneral_ProcessInAlarmsServer( zclIncoming_t *pInMsg, zclGeneral_AppCallbacks_t *pCBs );
 static ZStatus_t zclGeneral_ProcessInAlarmsClient( zclIncoming_t *pInMsg, zclGeneral_AppCallbacks_t *pCBs );
+static zclGenAlarmRing_t *zclGeneral_FindAlarmRing( uint8_t endpoint );
+static uint8_t zclGeneral_FindAlarmSlot( zclGenAlarmRing_t *pRing, uint8_t alarmCode, uint16_t clusterID );
+static void zclGeneral_RemoveAlarmSlot( zclGenAlarmRing_t *pRing, uint8_t idx );
+static void zclGeneral_CompactAlarmRing( zclGenAlarmRing_t *pRing );
+static void zclGeneral_FreeAlarmRing( zclGenAlarmRing_t *pRing );
 #endif // ZCL_ALARMS
 
 // Location cluster
@@ -2259,6 +2290,46 @@ zclGeneral_Scene_t *zclGeneral_FindScene( uint8_t endpoint, uint16_t groupID, ui
 }
 #endif // ZCL_STANDALONE
 
+#if !defined ( ZCL_STANDALONE )
+/*********************************************************************
+ * @fn      zclGeneral_RecallSceneFast
+ *
+ * @brief   Recall a scene with endpoint and sceneID, passing the scene
+ *          table entry straight to the recall callback
+ *
+ * @param   endpoint -
+ * @param   groupID - what group the scene belongs to
+ * @param   sceneID - ID to look for scene
+ * @param   srcAddr - source address of the recall request
+ * @param   pfnRecall - application callback applying the extension fields
+ *
+ * @return  TRUE if the scene was found and recalled, FALSE otherwise
+ */
+uint8_t zclGeneral_RecallSceneFast( uint8_t endpoint, uint16_t groupID, uint8_t sceneID,
+                                    afAddrType_t *srcAddr, zclGCB_SceneRecallReq_t pfnRecall )
+{
+  zclGeneral_Scene_t *pScene;
+  zclSceneReq_t req;
+
+  if ( pfnRecall == NULL )
+  {
+    return ( FALSE );
+  }
+
+  pScene = zclGeneral_FindScene( endpoint, groupID, sceneID );
+  if ( pScene == NULL )
+  {
+    return ( FALSE );
+  }
+
+  req.srcAddr = srcAddr;
+  req.scene = pScene;
+  pfnRecall( &req );
+
+  return ( TRUE );
+}
+#endif // ZCL_STANDALONE
+
 #if !defined ( ZCL_STANDALONE )
 /*********************************************************************
  * @fn      zclGeneral_FindAllScenesForGroup
@@ -2776,16 +2847,8 @@ static ZStatus_t zclGeneral_ProcessInScenesServer( zclIncoming_t *pInMsg,
       break;
 
     case COMMAND_SCENE_RECALL:
-      pScene = zclGeneral_FindScene( pInMsg->msg->endPoint, scene.groupID, scene.ID );
-      if ( pScene && pCBs->pfnSceneRecallReq )
-      {
-        zclSceneReq_t req;
-
-        req.srcAddr = &(pInMsg->msg->srcAddr);
-        req.scene = pScene;
-
-        pCBs->pfnSceneRecallReq( &req );
-      }
+      zclGeneral_RecallSceneFast( pInMsg->msg->endPoint, scene.groupID, scene.ID,
+                                  &(pInMsg->msg->srcAddr), pCBs->pfnSceneRecallReq );
       // No response
       break;
 
@@ -3261,10 +3324,184 @@ static ZStatus_t zclGeneral_ProcessInLevelControl( zclIncoming_t *pInMsg,
 #endif // ZCL_LEVEL_CTRL
 
 #ifdef ZCL_ALARMS
+/*********************************************************************
+ * @fn      zclGeneral_FindAlarmRing
+ *
+ * @brief   Find the alarm table of an endpoint
+ *
+ * @param   endpoint -
+ *
+ * @return  pointer to the alarm table, NULL if the endpoint has none
+ */
+static zclGenAlarmRing_t *zclGeneral_FindAlarmRing( uint8_t endpoint )
+{
+  zclGenAlarmRing_t *pRing = zclGenAlarmTable;
+
+  while ( pRing && pRing->endpoint != endpoint )
+  {
+    pRing = pRing->next;
+  }
+
+  return ( pRing );
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_FindAlarmSlot
+ *
+ * @brief   Look up an alarm in the (alarmCode, clusterID) index. If the
+ *          same alarm was added more than once the earliest one is found.
+ *
+ * @param   pRing - alarm table of the endpoint
+ * @param   alarmCode -
+ * @param   clusterID -
+ *
+ * @return  slot index, ZCL_GEN_ALARM_NONE if not found
+ */
+static uint8_t zclGeneral_FindAlarmSlot( zclGenAlarmRing_t *pRing, uint8_t alarmCode, uint16_t clusterID )
+{
+  uint8_t idx = pRing->hash[zclGeneral_AlarmHashKey( alarmCode, clusterID )];
+  uint8_t found = ZCL_GEN_ALARM_NONE;
+  uint8_t foundAge = 0xFF;
+  uint8_t age;
+
+  while ( idx != ZCL_GEN_ALARM_NONE )
+  {
+    if ( pRing->slot[idx].alarm.code == alarmCode &&
+         pRing->slot[idx].alarm.clusterID == clusterID )
+    {
+      // Distance from the head is the position in insertion order
+      age = ( idx + ZCL_GEN_MAX_ALARMS - pRing->head ) % ZCL_GEN_MAX_ALARMS;
+      if ( age < foundAge )
+      {
+        found = idx;
+        foundAge = age;
+      }
+    }
+    idx = pRing->slot[idx].hashNext;
+  }
+
+  return ( found );
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_RemoveAlarmSlot
+ *
+ * @brief   Remove an alarm from the index and release its slot. The head
+ *          and tail are moved past any released slots so the earliest
+ *          alarm stays at the head.
+ *
+ * @param   pRing - alarm table of the endpoint
+ * @param   idx - slot to remove
+ *
+ * @return  none
+ */
+static void zclGeneral_RemoveAlarmSlot( zclGenAlarmRing_t *pRing, uint8_t idx )
+{
+  zclGenAlarmSlot_t *pSlot = &pRing->slot[idx];
+  uint8_t *pLink = &pRing->hash[zclGeneral_AlarmHashKey( pSlot->alarm.code, pSlot->alarm.clusterID )];
+
+  // Unlink it from its index bucket
+  while ( *pLink != idx )
+  {
+    pLink = &pRing->slot[*pLink].hashNext;
+  }
+  *pLink = pSlot->hashNext;
+
+  pSlot->inUse = FALSE;
+  pRing->count--;
+
+  if ( pRing->count == 0 )
+  {
+    pRing->head = 0;
+    pRing->span = 0;
+    return;
+  }
+
+  // Drop released slots from the head
+  while ( pRing->slot[pRing->head].inUse == FALSE )
+  {
+    pRing->head = ( pRing->head + 1 ) % ZCL_GEN_MAX_ALARMS;
+    pRing->span--;
+  }
+
+  // Drop released slots from the tail
+  while ( pRing->slot[( pRing->head + pRing->span - 1 ) % ZCL_GEN_MAX_ALARMS].inUse == FALSE )
+  {
+    pRing->span--;
+  }
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_CompactAlarmRing
+ *
+ * @brief   Close the holes left by alarms reset from the middle of the
+ *          table, keeping insertion order, and rebuild the index.
+ *
+ * @param   pRing - alarm table of the endpoint
+ *
+ * @return  none
+ */
+static void zclGeneral_CompactAlarmRing( zclGenAlarmRing_t *pRing )
+{
+  zclGenAlarmSlot_t *pSlot;
+  uint8_t key;
+  uint8_t from;
+  uint8_t to;
+  uint8_t i;
+
+  zcl_memset( pRing->hash, ZCL_GEN_ALARM_NONE, sizeof( pRing->hash ) );
+
+  to = pRing->head;
+  for ( i = 0; i < pRing->span; i++ )
+  {
+    from = ( pRing->head + i ) % ZCL_GEN_MAX_ALARMS;
+    if ( pRing->slot[from].inUse )
+    {
+      if ( from != to )
+      {
+        pRing->slot[to] = pRing->slot[from];
+        pRing->slot[from].inUse = FALSE;
+      }
+
+      pSlot = &pRing->slot[to];
+      key = zclGeneral_AlarmHashKey( pSlot->alarm.code, pSlot->alarm.clusterID );
+      pSlot->hashNext = pRing->hash[key];
+      pRing->hash[key] = to;
+
+      to = ( to + 1 ) % ZCL_GEN_MAX_ALARMS;
+    }
+  }
+
+  pRing->span = pRing->count;
+}
+
+/*********************************************************************
+ * @fn      zclGeneral_FreeAlarmRing
+ *
+ * @brief   Unlink the alarm table of an endpoint and free it
+ *
+ * @param   pRing - alarm table of the endpoint
+ *
+ * @return  none
+ */
+static void zclGeneral_FreeAlarmRing( zclGenAlarmRing_t *pRing )
+{
+  zclGenAlarmRing_t **ppLink = &zclGenAlarmTable;
+
+  while ( *ppLink != pRing )
+  {
+    ppLink = &(*ppLink)->next;
+  }
+  *ppLink = pRing->next;
+
+  zcl_mem_free( pRing );
+}
+
 /*********************************************************************
  * @fn      zclGeneral_AddAlarm
  *
- * @brief   Add an alarm for a cluster
+ * @brief   Add an alarm for a cluster. If the alarm table of the endpoint
+ *          is full the earliest alarm is discarded.
  *
  * @param   endpoint -
  * @param   alarm - new alarm item
@@ -3273,35 +3510,53 @@ static ZStatus_t zclGeneral_ProcessInLevelControl( zclIncoming_t *pInMsg,
  */
 ZStatus_t zclGeneral_AddAlarm( uint8_t endpoint, zclGeneral_Alarm_t *alarm )
 {
-  zclGenAlarmItem_t *pNewItem;
-  zclGenAlarmItem_t *pLoop;
+  zclGenAlarmRing_t *pRing;
+  zclGenAlarmSlot_t *pSlot;
+  uint8_t key;
+  uint8_t idx;
 
-  // Fill in the new profile list
-  pNewItem = zcl_mem_alloc( sizeof( zclGenAlarmItem_t ) );
-  if ( pNewItem == NULL )
-    return ( ZMemError );
+  pRing = zclGeneral_FindAlarmRing( endpoint );
+  if ( pRing == NULL )
+  {
+    // First alarm on this endpoint
+    pRing = zcl_mem_alloc( sizeof( zclGenAlarmRing_t ) );
+    if ( pRing == NULL )
+      return ( ZMemError );
 
-  // Fill in the plugin record.
-  pNewItem->next = (zclGenAlarmItem_t *)NULL;
-  pNewItem->endpoint =  endpoint;
-  zcl_memcpy( (uint8_t*)(&pNewItem->alarm), (uint8_t*)alarm, sizeof ( zclGeneral_Alarm_t ) );
+    zcl_memset( pRing, 0, sizeof( zclGenAlarmRing_t ) );
+    zcl_memset( pRing->hash, ZCL_GEN_ALARM_NONE, sizeof( pRing->hash ) );
+    pRing->endpoint = endpoint;
 
-  // Find spot in list
-  if (  zclGenAlarmTable == NULL )
-  {
-    zclGenAlarmTable = pNewItem;
+    pRing->next = zclGenAlarmTable;
+    zclGenAlarmTable = pRing;
   }
-  else
-  {
-    // Look for end of list
-    pLoop = zclGenAlarmTable;
-    while ( pLoop->next != NULL )
-      pLoop = pLoop->next;
 
-    // Put new item at end of list
-    pLoop->next = pNewItem;
+  if ( pRing->span == ZCL_GEN_MAX_ALARMS )
+  {
+    if ( pRing->count == ZCL_GEN_MAX_ALARMS )
+    {
+      // Table full, discard the earliest alarm
+      zclGeneral_RemoveAlarmSlot( pRing, pRing->head );
+    }
+    else
+    {
+      // Tail has caught up with the head, reuse the reset slots
+      zclGeneral_CompactAlarmRing( pRing );
+    }
   }
 
+  idx = ( pRing->head + pRing->span ) % ZCL_GEN_MAX_ALARMS;
+  pRing->span++;
+  pRing->count++;
+
+  pSlot = &pRing->slot[idx];
+  pSlot->inUse = TRUE;
+  zcl_memcpy( (uint8_t*)(&pSlot->alarm), (uint8_t*)alarm, sizeof ( zclGeneral_Alarm_t ) );
+
+  key = zclGeneral_AlarmHashKey( alarm->code, alarm->clusterID );
+  pSlot->hashNext = pRing->hash[key];
+  pRing->hash[key] = idx;
+
   return ( ZSuccess );
 }
 
@@ -3311,25 +3566,22 @@ ZStatus_t zclGeneral_AddAlarm( uint8_t endpoint, zclGeneral_Alarm_t *alarm )
  * @brief   Find an alarm with alarmCode and clusterID
  *
  * @param   endpoint -
- * @param   groupID - what group the scene belongs to
- * @param   sceneID - ID to look for scene
+ * @param   alarmCode -
+ * @param   clusterID -
  *
  * @return  a pointer to the alarm information, NULL if not found
  */
 zclGeneral_Alarm_t *zclGeneral_FindAlarm( uint8_t endpoint, uint8_t alarmCode, uint16_t clusterID )
 {
-  zclGenAlarmItem_t *pLoop;
+  zclGenAlarmRing_t *pRing;
+  uint8_t idx;
 
-  // Look for the alarm
-  pLoop = zclGenAlarmTable;
-  while ( pLoop )
+  pRing = zclGeneral_FindAlarmRing( endpoint );
+  if ( pRing )
   {
-    if ( pLoop->endpoint == endpoint &&
-         pLoop->alarm.code == alarmCode && pLoop->alarm.clusterID == clusterID )
-    {
-      return ( &(pLoop->alarm) );
-    }
-    pLoop = pLoop->next;
+    idx = zclGeneral_FindAlarmSlot( pRing, alarmCode, clusterID );
+    if ( idx != ZCL_GEN_ALARM_NONE )
+      return ( &(pRing->slot[idx].alarm) );
   }
 
   return ( (zclGeneral_Alarm_t *)NULL );
@@ -3338,7 +3590,8 @@ zclGeneral_Alarm_t *zclGeneral_FindAlarm( uint8_t endpoint, uint8_t alarmCode, u
 /*********************************************************************
  * @fn      zclGeneral_FindEarliestAlarm
  *
- * @brief   Find an alarm with the earliest timestamp
+ * @brief   Find the earliest alarm. Alarms are kept in the order they
+ *          were added, so this is the one at the head of the table.
  *
  * @param   endpoint -
  *
@@ -3346,26 +3599,11 @@ zclGeneral_Alarm_t *zclGeneral_FindAlarm( uint8_t endpoint, uint8_t alarmCode, u
  */
 zclGeneral_Alarm_t *zclGeneral_FindEarliestAlarm( uint8_t endpoint )
 {
-  zclGenAlarmItem_t *pLoop;
-  zclGenAlarmItem_t earliestAlarm;
-  zclGenAlarmItem_t *pEarliestAlarm = &earliestAlarm;
-
-  pEarliestAlarm->alarm.timeStamp = 0xFFFFFFFF;
-
-  // Look for alarm with earliest time
-  pLoop = zclGenAlarmTable;
-  while ( pLoop )
-  {
-    if ( pLoop->endpoint == endpoint &&
-         pLoop->alarm.timeStamp < pEarliestAlarm->alarm.timeStamp )
-    {
-      pEarliestAlarm = pLoop;
-    }
-    pLoop = pLoop->next;
-  }
+  zclGenAlarmRing_t *pRing;
 
-  if ( pEarliestAlarm->alarm.timeStamp != 0xFFFFFFFF )
-    return ( &(pEarliestAlarm->alarm) );
+  pRing = zclGeneral_FindAlarmRing( endpoint );
+  if ( pRing && pRing->count )
+    return ( &(pRing->slot[pRing->head].alarm) );
 
   // No alarm
   return ( (zclGeneral_Alarm_t *)NULL );
@@ -3380,38 +3618,32 @@ zclGeneral_Alarm_t *zclGeneral_FindEarliestAlarm( uint8_t endpoint )
  * @param   alarmCode -
  * @param   clusterID -
  *
- * @return  TRUE if removed, FALSE if not found
+ * @return  none
  */
 void zclGeneral_ResetAlarm( uint8_t endpoint, uint8_t alarmCode, uint16_t clusterID )
 {
-  zclGenAlarmItem_t *pLoop;
-  zclGenAlarmItem_t *pPrev;
+  zclGenAlarmRing_t *pRing;
+  uint8_t idx;
 
-  // Look for end of list
-  pLoop = zclGenAlarmTable;
-  pPrev = NULL;
-  while ( pLoop )
-  {
-    if ( pLoop->endpoint == endpoint &&
-         pLoop->alarm.code == alarmCode && pLoop->alarm.clusterID == clusterID )
-    {
-      if ( pPrev == NULL )
-        zclGenAlarmTable = pLoop->next;
-      else
-        pPrev->next = pLoop->next;
+  pRing = zclGeneral_FindAlarmRing( endpoint );
+  if ( pRing == NULL )
+    return;
 
-      // Free the memory
-      zcl_mem_free( pLoop );
+  idx = zclGeneral_FindAlarmSlot( pRing, alarmCode, clusterID );
+  if ( idx == ZCL_GEN_ALARM_NONE )
+    return;
 
-      // Notify the Application so that if the alarm condition still active then
-      // a new notification will be generated, and a new alarm record will be
-      // added to the alarm log
-      // zclGeneral_NotifyReset( alarmCode, clusterID ); // callback function?
-      return;
-    }
-    pPrev = pLoop;
-    pLoop = pLoop->next;
+  zclGeneral_RemoveAlarmSlot( pRing, idx );
+  if ( pRing->count == 0 )
+  {
+    // Free the memory
+    zclGeneral_FreeAlarmRing( pRing );
   }
+
+  // Notify the Application so that if the alarm condition still active then
+  // a new notification will be generated, and a new alarm record will be
+  // added to the alarm log
+  // zclGeneral_NotifyReset( alarmCode, clusterID ); // callback function?
 }
 
 /*********************************************************************
@@ -3426,34 +3658,13 @@ void zclGeneral_ResetAlarm( uint8_t endpoint, uint8_t alarmCode, uint16_t cluste
  */
 void zclGeneral_ResetAllAlarms( uint8_t endpoint, uint8_t notifyApp )
 {
-  zclGenAlarmItem_t *pLoop;
-  zclGenAlarmItem_t *pPrev;
-  zclGenAlarmItem_t *pNext;
+  zclGenAlarmRing_t *pRing;
 
-  // Look for end of list
-  pLoop = zclGenAlarmTable;
-  pPrev = NULL;
-  while ( pLoop )
+  pRing = zclGeneral_FindAlarmRing( endpoint );
+  if ( pRing )
   {
-    if (  pLoop->endpoint == endpoint )
-    {
-      if ( pPrev == NULL )
-        zclGenAlarmTable = pLoop->next;
-      else
-        pPrev->next = pLoop->next;
-
-      pNext = pLoop->next;
-
-      // Free the memory
-      zcl_mem_free( pLoop );
-
-      pLoop = pNext;
-    }
-    else
-    {
-      pPrev = pLoop;
-      pLoop = pLoop->next;
-    }
+    // Free the memory
+    zclGeneral_FreeAlarmRing( pRing );
   }
 
   if ( notifyApp )
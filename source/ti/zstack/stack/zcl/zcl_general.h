@@ -1752,6 +1752,16 @@ extern "C"
 #warning: "According to latest ZCL version 7, secction 3.7.2.3.2 Maximum Number of Scenes: The number of scenes capable of being stored in the table is defined by the profile in which this cluster is used. The default maximum, in the absence of specification by the profile, is 16."
 #endif
 
+// The maximum number of entries in the Alarm table of each endpoint. When
+// the table is full the earliest alarm is discarded to make room.
+#if !defined ( ZCL_GEN_MAX_ALARMS )
+#define ZCL_GEN_MAX_ALARMS                               16
+#endif
+
+#if (ZCL_GEN_MAX_ALARMS > 254)
+#error "ZCL_GEN_MAX_ALARMS must not exceed 254"
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -2664,6 +2674,13 @@ extern ZStatus_t zclGeneral_AddScene( uint8_t endpoint, zclGeneral_Scene_t *scen
  */
 extern zclGeneral_Scene_t *zclGeneral_FindScene( uint8_t endpoint, uint16_t groupID, uint8_t sceneID );
 
+/*!
+ * Recall a scene with endpoint and sceneID, passing it straight to the
+ * recall callback without going through the endpoint's scene buffer
+ */
+extern uint8_t zclGeneral_RecallSceneFast( uint8_t endpoint, uint16_t groupID, uint8_t sceneID,
+                                           afAddrType_t *srcAddr, zclGCB_SceneRecallReq_t pfnRecall );
+
 /*!
  * Get all the scenes with groupID
  */
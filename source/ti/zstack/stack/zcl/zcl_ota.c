@@ -74,6 +74,13 @@
  * MACROS
  */
 
+// Size of the write-behind buffer used to stage downloaded image data before
+// programming it into external flash.  Defaults to one SPI flash program page;
+// must divide EFL_PAGE_SIZE so every erase sector starts on a buffer boundary.
+#if !defined OTA_WRITE_BEHIND_LEN
+#define OTA_WRITE_BEHIND_LEN        256
+#endif
+
 /******************************************************************************
  * CONSTANTS
  */
@@ -176,6 +183,11 @@ static const uint8_t zclOTA_HdrMagic[] = {0x1E, 0xF1, 0xEE, 0x0B};
 
 imgHdr_t oad_imgHdr = {0};
 uint16_t   oad_imgHdr_pos = 0;
+
+// Write-behind buffer for the external flash image section
+static uint8_t  zclOTA_WriteBuf[OTA_WRITE_BEHIND_LEN];
+static uint16_t zclOTA_WriteBufLen;
+static uint32_t zclOTA_WriteBufAddr;
 #endif // (defined OTA_CLIENT) && (OTA_CLIENT == TRUE)
 
 /******************************************************************************
@@ -198,8 +210,9 @@ zclOptionRec_t zclOta_Options[ZCL_OTA_MAX_OPTIONS] =
 #endif // OTA_HA
 
 #if (defined OTA_CLIENT) && (OTA_CLIENT == TRUE)
-static uint8_t oadEraseExtFlashPages(uint8_t imgStartPage, uint8_t imgPageLen);
 static uint8_t oadCheckDL(uint8_t imagePage);
+static uint8_t oadWriteBehind(uint8_t *pBuf, uint32_t len);
+static uint8_t oadWriteBehindFlush(void);
 #endif
 
 /******************************************************************************
@@ -992,9 +1005,6 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                         //Search for a metadata header to fit the Zigbee image
                         ExtImageInfo_t oad_imgHdrFactoryNew;
 
-                        //OAD binary pages required to store the binary
-                        uint8_t   binaryPagesLen   = 0;
-
                         // Read the factory new metadata page
                         readFlash(EFL_ADDR_META_FACT_IMG, (uint8_t *)&oad_imgHdrFactoryNew, EFL_METADATA_LEN);
 
@@ -1020,15 +1030,9 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                         //Address at which the Zigbee binary starts
                         binaryAddrStart = binaryAddrOffset;
 
-                        binaryPagesLen = EXT_FLASH_PAGE(oad_imgHdr.fixedHdr.len) + 1;
-
-                        //Erase the image space for the incoming binary
-                        if(oadEraseExtFlashPages(EXT_FLASH_PAGE(binaryAddrOffset) , binaryPagesLen))
-                        {
-                            flash_close();
-                            //Something went wrong...
-                            return ZCL_STATUS_ABORT;
-                        }
+                        //The image pages are erased one by one as the write-behind buffer reaches them
+                        zclOTA_WriteBufAddr = binaryAddrStart;
+                        zclOTA_WriteBufLen = 0;
 
                         //Erase the header file after the Factory New metadata header
                         if(eraseFlashPg(EXT_FLASH_PAGE(EFL_ADDR_META_FACT_IMG + EFL_PAGE_SIZE) != FLASH_SUCCESS))
@@ -1058,7 +1062,7 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                             }
 
                         //Also write the OAD header into the external flash binary section
-                        if(writeFlashPg(EXT_FLASH_PAGE(binaryAddrOffset), 0,  (uint8_t *)&oad_imgHdr, sizeof (imgHdr_t)) != FLASH_SUCCESS)
+                        if(oadWriteBehind((uint8_t *)&oad_imgHdr, sizeof (imgHdr_t)) != FLASH_SUCCESS)
                         {
                             flash_close();
                             //Something went wrong...
@@ -1068,7 +1072,7 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                         binaryAddrOffset += sizeof (imgHdr_t);
 
                         //add the remaining payload image into the image section
-                        if(writeFlashPg(EXT_FLASH_PAGE(binaryAddrOffset), binaryAddrOffset & (~EXTFLASH_PAGE_MASK), &pData[i], len - i ) != FLASH_SUCCESS)
+                        if(oadWriteBehind(&pData[i], len - i) != FLASH_SUCCESS)
                         {
                             flash_close();
                             //Something went wrong...
@@ -1108,7 +1112,7 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                         if(binaryAddrOffset + len < binaryAddrStart + oad_imgHdr.fixedHdr.len)
                         {
                             //add the image payload into the image section
-                            if(writeFlashPg(EXT_FLASH_PAGE(binaryAddrOffset), binaryAddrOffset & (~EXTFLASH_PAGE_MASK), &pData[i], len ) != FLASH_SUCCESS)
+                            if(oadWriteBehind(&pData[i], len) != FLASH_SUCCESS)
                             {
                                 flash_close();
                                 //Something went wrong...
@@ -1123,8 +1127,9 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
                             uint32_t remaining;
                             remaining = oad_imgHdr.fixedHdr.len - (binaryAddrOffset - binaryAddrStart);
 
-                            //add the image payload into the image section
-                            if(writeFlashPg(EXT_FLASH_PAGE(binaryAddrOffset), binaryAddrOffset & (~EXTFLASH_PAGE_MASK), &pData[i],  remaining ) != FLASH_SUCCESS)
+                            //add the image payload into the image section and program whatever is still buffered
+                            if((oadWriteBehind(&pData[i], remaining) != FLASH_SUCCESS) ||
+                               (oadWriteBehindFlush() != FLASH_SUCCESS))
                             {
                                 flash_close();
                                 //Something went wrong...
@@ -1200,36 +1205,80 @@ uint8_t zclOTA_ProcessImageData ( uint8_t *pData, uint8_t len )
 }
 
 /*********************************************************************
- * @fn      oadEraseExtFlashPages
+ * @fn      oadWriteBehind
+ *
+ * @brief   Stage image data in the write-behind buffer, programming the
+ *          buffer into external flash each time it fills up.
  *
- * @brief   This function erases external flash pages
+ * @param   pBuf - data to append to the image section
+ * @param   len  - length of the data
  *
- * @param   imgStartPage - image start page on external flash
- * @param   imgPageLen   - image length in pages
-  *
- * @return  ZSuccess on successful erasure else
- *          ZFailure
+ * @return  FLASH_SUCCESS or FLASH_FAILURE
  */
-static uint8_t oadEraseExtFlashPages(uint8_t imgStartPage, uint8_t imgPageLen)
+static uint8_t oadWriteBehind(uint8_t *pBuf, uint32_t len)
 {
-    uint8_t status = ZSuccess;
-
-    for (uint8_t i = 0; i < imgPageLen; i++)
+    while (len > 0)
     {
-       uint8_t flashStat = eraseFlashPg(imgStartPage);
-        if(flashStat == FLASH_FAILURE)
+        uint16_t chunk = OTA_WRITE_BEHIND_LEN - zclOTA_WriteBufLen;
+
+        if (chunk > len)
         {
-            // If we fail to pre-erase, then halt the OAD process
-            status = ZFailure;
-            break;
+            chunk = (uint16_t)len;
+        }
+
+        OsalPort_memcpy(&zclOTA_WriteBuf[zclOTA_WriteBufLen], pBuf, chunk);
+        zclOTA_WriteBufLen += chunk;
+        pBuf += chunk;
+        len -= chunk;
+
+        if (zclOTA_WriteBufLen == OTA_WRITE_BEHIND_LEN)
+        {
+            if (oadWriteBehindFlush() != FLASH_SUCCESS)
+            {
+                return FLASH_FAILURE;
+            }
         }
-        imgStartPage++;
     }
-    return status;
+
+    return FLASH_SUCCESS;
 }
 
+/*********************************************************************
+ * @fn      oadWriteBehindFlush
+ *
+ * @brief   Program the write-behind buffer into external flash, erasing
+ *          the page first when the buffer starts a new page.
+ *
+ * @param   none
+ *
+ * @return  FLASH_SUCCESS or FLASH_FAILURE
+ */
+static uint8_t oadWriteBehindFlush(void)
+{
+    uint8_t status = FLASH_SUCCESS;
+
+    if (zclOTA_WriteBufLen == 0)
+    {
+        return status;
+    }
+
+    if ((zclOTA_WriteBufAddr & (~EXTFLASH_PAGE_MASK)) == 0)
+    {
+        status = eraseFlashPg(EXT_FLASH_PAGE(zclOTA_WriteBufAddr));
+    }
 
+    if (status == FLASH_SUCCESS)
+    {
+        status = writeFlashPg(EXT_FLASH_PAGE(zclOTA_WriteBufAddr),
+                              zclOTA_WriteBufAddr & (~EXTFLASH_PAGE_MASK),
+                              zclOTA_WriteBuf, zclOTA_WriteBufLen);
+    }
+
+    zclOTA_WriteBufAddr += zclOTA_WriteBufLen;
+    zclOTA_WriteBufLen = 0;
 
+    return status;
+}
 
 /*********************************************************************
  * @fn      oadCheckDL
@@ -52,6 +52,7 @@
 #include <ti/drivers/Power.h>
 #include <ti/drivers/power/PowerCC26XX.h>
 #include <string.h>
+#include <stddef.h>
 #include <inc/hw_ints.h>
 
 #include "zstackapi.h"
@@ -96,6 +97,15 @@ typedef struct zclGenSceneNVItem
     uint8_t endpoint;
     zclGeneral_Scene_t scene;
 }zclGenSceneNVItem_t;
+
+// RAM directory entry of a scene NV record, endpoint is 0xFF if the
+// record is empty
+typedef struct
+{
+    uint8_t endpoint;
+    uint8_t sceneID;
+    uint16_t groupID;
+}zclGenSceneDirEntry_t;
 #endif
 
 // multiple endpoint for ZCL handler external, added by luoyiming 2020-02-08
@@ -148,6 +158,10 @@ static zstack_sysNwkInfoReadRsp_t nwkInfo =
 
 #if defined (ZCL_SCENES)
 static uint8_t lastFindSceneEndpoint = 0xFF;
+
+// RAM directory of the scene NV records, indexed by NV sub ID
+static zclGenSceneDirEntry_t sceneDir[ZCL_GEN_MAX_SCENES];
+static bool sceneDirLoaded = false;
 #endif
 
 // Function pointer for applications to ZCL Handle External
@@ -1105,6 +1119,115 @@ static bool sceneRecEmpty(zclGenSceneNVItem_t *pNvItem)
     return(true);
 }
 
+/*********************************************************************
+ * @fn      sceneDirSet
+ *
+ * @brief   Update the RAM directory entry of a scene NV record
+ *
+ * @param   x - NV sub ID of the record
+ * @param   pNvItem - pointer to scene NV record
+ */
+static void sceneDirSet(uint16_t x, zclGenSceneNVItem_t *pNvItem)
+{
+    if(sceneRecEmpty(pNvItem))
+    {
+        sceneDir[x].endpoint = 0xFF;
+        sceneDir[x].sceneID = 0xFF;
+        sceneDir[x].groupID = 0xFFFF;
+    }
+    else
+    {
+        sceneDir[x].endpoint = pNvItem->endpoint;
+        sceneDir[x].sceneID = pNvItem->scene.ID;
+        sceneDir[x].groupID = pNvItem->scene.groupID;
+    }
+}
+
+/*********************************************************************
+ * @fn      sceneDirLoad
+ *
+ * @brief   Fill the RAM directory from the scene NV records, once.
+ *          Records that can't be read are treated as empty.
+ */
+static void sceneDirLoad(void)
+{
+    uint16_t x;
+    zclGenSceneNVItem_t nvItem;
+
+    if(sceneDirLoaded == false)
+    {
+        for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
+        {
+            if(zclport_readNV(zclSceneNVID, x, 0,
+                              sizeof(zclGenSceneNVItem_t), &nvItem) != SUCCESS)
+            {
+                memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
+            }
+            sceneDirSet(x, &nvItem);
+        }
+        sceneDirLoaded = true;
+    }
+}
+
+/*********************************************************************
+ * @fn      sceneDirFind
+ *
+ * @brief   Find a scene NV record in the RAM directory
+ *
+ * @param   endpoint - endpoint filter, 0xFF for any endpoint
+ * @param   groupID - what group the scene belongs to
+ * @param   sceneID - ID to look for scene
+ *
+ * @return  NV sub ID of the record, ZCL_GEN_MAX_SCENES if not found
+ */
+static uint16_t sceneDirFind(uint8_t endpoint, uint16_t groupID,
+                             uint8_t sceneID)
+{
+    uint16_t x;
+
+    sceneDirLoad();
+
+    for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
+    {
+        if( (sceneDir[x].endpoint != 0xFF)
+            && ( (sceneDir[x].endpoint == endpoint) || (endpoint == 0xFF) )
+            && (sceneDir[x].groupID == groupID)
+            && (sceneDir[x].sceneID == sceneID) )
+        {
+            break;
+        }
+    }
+    return(x);
+}
+
+/*********************************************************************
+ * @fn      sceneRecWrite
+ *
+ * @brief   Write a scene NV record and update the RAM directory
+ *
+ * @param   x - NV sub ID of the record
+ * @param   pNvItem - pointer to scene NV record
+ *
+ * @return  status of the NV write
+ */
+static uint8_t sceneRecWrite(uint16_t x, zclGenSceneNVItem_t *pNvItem)
+{
+    uint8_t status;
+
+    status = zclport_writeNV(zclSceneNVID, x,
+                             sizeof(zclGenSceneNVItem_t), pNvItem);
+    if(status == SUCCESS)
+    {
+        sceneDirSet(x, pNvItem);
+    }
+    else
+    {
+        // The record content is unknown, reload the directory on next use
+        sceneDirLoaded = false;
+    }
+    return(status);
+}
+
 /*********************************************************************
  * @fn      zclGeneral_ScenesInit
  *
@@ -1121,6 +1244,9 @@ void zclGeneral_ScenesInit(void)
         zclport_initializeNVItem(zclSceneNVID, x,
                                  sizeof(zclGenSceneNVItem_t), &temp);
     }
+
+    // Records may have been created, reload the directory on next use
+    sceneDirLoaded = false;
 }
 
 /*********************************************************************
@@ -1136,20 +1262,17 @@ void zclGeneral_RemoveAllScenes(uint8_t endpoint, uint16_t groupID)
     uint16_t x;
     zclGenSceneNVItem_t nvItem;
 
+    sceneDirLoad();
+
     for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
     {
-        if(zclport_readNV(zclSceneNVID, x, 0,
-                          sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
+        if( (sceneDir[x].endpoint != 0xFF)
+            && ( (sceneDir[x].endpoint == endpoint) || (endpoint == 0xFF) )
+            && (sceneDir[x].groupID == groupID) )
         {
-            if( (sceneRecEmpty(&nvItem) == false)
-                && ( (nvItem.endpoint == endpoint) || (endpoint == 0xFF) )
-                && (nvItem.scene.groupID == groupID) )
-            {
-                // Remove the item by setting it all to 0xFF
-                memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
-                zclport_writeNV(zclSceneNVID, x,
-                                sizeof(zclGenSceneNVItem_t), &nvItem);
-            }
+            // Remove the item by setting it all to 0xFF
+            memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
+            sceneRecWrite(x, &nvItem);
         }
     }
 }
@@ -1170,32 +1293,22 @@ uint8_t zclGeneral_RemoveScene(uint8_t endpoint, uint16_t groupID, uint8_t scene
     uint16_t x;
     zclGenSceneNVItem_t nvItem;
 
-    for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
+    x = sceneDirFind(endpoint, groupID, sceneID);
+    if(x == ZCL_GEN_MAX_SCENES)
     {
-        if(zclport_readNV(zclSceneNVID, x, 0,
-                          sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
-        {
-            if( (sceneRecEmpty(&nvItem) == false)
-                && ( (nvItem.endpoint == endpoint) || (endpoint == 0xFF) )
-                && (nvItem.scene.groupID == groupID)
-                && (nvItem.scene.ID == sceneID) )
-            {
-                // Remove the item by setting it all to 0xFF
-                memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
-                if(zclport_writeNV(zclSceneNVID, x,
-                                   sizeof(zclGenSceneNVItem_t),
-                                   &nvItem) == SUCCESS)
-                {
-                    return(TRUE);
-                }
-                else
-                {
-                    return(FALSE);
-                }
-            }
-        }
+        return(FALSE);
+    }
+
+    // Remove the item by setting it all to 0xFF
+    memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
+    if(sceneRecWrite(x, &nvItem) == SUCCESS)
+    {
+        return(TRUE);
+    }
+    else
+    {
+        return(FALSE);
     }
-    return(FALSE);
 }
 
 /*********************************************************************
@@ -1213,30 +1326,22 @@ zclGeneral_Scene_t *zclGeneral_FindScene(uint8_t endpoint, uint16_t groupID,
                                          uint8_t sceneID)
 {
     uint16_t x;
-    zclGenSceneNVItem_t nvItem;
     zclPort_entityEPDesc_t *pEPDesc = zclPortFind(endpoint);
 
     if(pEPDesc != NULL)
     {
-        for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
+        x = sceneDirFind(endpoint, groupID, sceneID);
+        if(x < ZCL_GEN_MAX_SCENES)
         {
-            if(zclport_readNV(zclSceneNVID, x, 0,
-                              sizeof(zclGenSceneNVItem_t),
-                              &nvItem) == SUCCESS)
+            // Only the matching record is read, straight into the temp area
+            if(zclport_readNV(zclSceneNVID, x,
+                              offsetof(zclGenSceneNVItem_t, scene),
+                              sizeof(zclGeneral_Scene_t),
+                              &(pEPDesc->scene)) == SUCCESS)
             {
-                if( (sceneRecEmpty(&nvItem) == false)
-                    && ( (nvItem.endpoint == endpoint) || (endpoint == 0xFF) )
-                    && (nvItem.scene.groupID == groupID)
-                    && (nvItem.scene.ID == sceneID) )
-                {
-                    lastFindSceneEndpoint = endpoint;
-
-                    // Copy to a temp area
-                    OsalPort_memcpy( &(pEPDesc->scene), &(nvItem.scene),
-                            sizeof(zclGeneral_Scene_t) );
-
-                    return( &(pEPDesc->scene) );
-                }
+                lastFindSceneEndpoint = endpoint;
+
+                return( &(pEPDesc->scene) );
             }
         }
     }
@@ -1244,6 +1349,55 @@ zclGeneral_Scene_t *zclGeneral_FindScene(uint8_t endpoint, uint16_t groupID,
     return( (zclGeneral_Scene_t *)NULL );
 }
 
+/*********************************************************************
+ * @fn      zclGeneral_RecallSceneFast
+ *
+ * @brief   Recall a scene: read the scene record once and hand it to the
+ *          application's recall callback. The endpoint's temporary scene
+ *          buffer and the pending zclGeneral_ScenesSave() state are left
+ *          untouched.
+ *
+ * @param   endpoint - endpoint filter to find scene
+ * @param   groupID - what group the scene belongs to
+ * @param   sceneID - ID to look for scene
+ * @param   srcAddr - source address of the recall request
+ * @param   pfnRecall - application callback applying the extension fields
+ *
+ * @return  TRUE if the scene was found and recalled, FALSE otherwise
+ */
+uint8_t zclGeneral_RecallSceneFast(uint8_t endpoint, uint16_t groupID,
+                                   uint8_t sceneID, afAddrType_t *srcAddr,
+                                   zclGCB_SceneRecallReq_t pfnRecall)
+{
+    uint16_t x;
+    zclGeneral_Scene_t scene;
+    zclSceneReq_t req;
+
+    if(pfnRecall == NULL)
+    {
+        return(FALSE);
+    }
+
+    x = sceneDirFind(endpoint, groupID, sceneID);
+    if(x == ZCL_GEN_MAX_SCENES)
+    {
+        return(FALSE);
+    }
+
+    if(zclport_readNV(zclSceneNVID, x,
+                      offsetof(zclGenSceneNVItem_t, scene),
+                      sizeof(zclGeneral_Scene_t), &scene) != SUCCESS)
+    {
+        return(FALSE);
+    }
+
+    req.srcAddr = srcAddr;
+    req.scene = &scene;
+    pfnRecall( &req );
+
+    return(TRUE);
+}
+
 /*********************************************************************
  * @fn      zclGeneral_AddScene
  *
@@ -1260,19 +1414,11 @@ ZStatus_t zclGeneral_AddScene(uint8_t endpoint, zclGeneral_Scene_t *scene)
     zclGenSceneNVItem_t nvItem;
 
     // See if the item exists already
-    for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
+    x = sceneDirFind(endpoint, scene->groupID, scene->ID);
+    if( (x < ZCL_GEN_MAX_SCENES) && (sceneDir[x].endpoint != endpoint) )
     {
-        if(zclport_readNV(zclSceneNVID, x, 0,
-                          sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
-        {
-            if( (sceneRecEmpty(&nvItem) == false)
-                && (nvItem.endpoint == endpoint)
-                && (nvItem.scene.groupID == scene->groupID)
-                && (nvItem.scene.ID == scene->ID) )
-            {
-                break;
-            }
-        }
+        // A wildcard endpoint never matches an existing record
+        x = ZCL_GEN_MAX_SCENES;
     }
 
     // Find an empty slot
@@ -1280,14 +1426,9 @@ ZStatus_t zclGeneral_AddScene(uint8_t endpoint, zclGeneral_Scene_t *scene)
     {
         for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
         {
-            if(zclport_readNV(zclSceneNVID, x, 0,
-                              sizeof(zclGenSceneNVItem_t),
-                              &nvItem) == SUCCESS)
+            if(sceneDir[x].endpoint == 0xFF)
             {
-                if( sceneRecEmpty(&nvItem) )
-                {
-                    break;
-                }
+                break;
             }
         }
     }
@@ -1298,11 +1439,11 @@ ZStatus_t zclGeneral_AddScene(uint8_t endpoint, zclGeneral_Scene_t *scene)
     }
 
     // Item found or empty slot found
+    memset( &nvItem, 0xFF, sizeof(zclGenSceneNVItem_t) );
     nvItem.endpoint = endpoint;
     OsalPort_memcpy( &(nvItem.scene), scene, sizeof(zclGeneral_Scene_t) );
 
-    if(zclport_writeNV(zclSceneNVID, x,
-                       sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
+    if(sceneRecWrite(x, &nvItem) == SUCCESS)
     {
         return(ZSuccess);
     }
@@ -1322,18 +1463,15 @@ ZStatus_t zclGeneral_AddScene(uint8_t endpoint, zclGeneral_Scene_t *scene)
 uint8_t zclGeneral_CountAllScenes(void)
 {
     uint16_t x;
-    zclGenSceneNVItem_t nvItem;
     uint8_t cnt = 0;
 
+    sceneDirLoad();
+
     for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
     {
-        if(zclport_readNV(zclSceneNVID, x, 0,
-                          sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
+        if(sceneDir[x].endpoint != 0xFF)
         {
-            if(sceneRecEmpty(&nvItem) == false)
-            {
-                cnt++;
-            }
+            cnt++;
         }
     }
 
@@ -1354,20 +1492,17 @@ uint8_t zclGeneral_FindAllScenesForGroup(uint8_t endpoint, uint16_t groupID,
                                        uint8_t *sceneList)
 {
     uint16_t x;
-    zclGenSceneNVItem_t nvItem;
     uint8_t cnt = 0;
 
+    sceneDirLoad();
+
     for(x = 0; x < ZCL_GEN_MAX_SCENES; x++)
     {
-        if(zclport_readNV(zclSceneNVID, x, 0,
-                          sizeof(zclGenSceneNVItem_t), &nvItem) == SUCCESS)
+        if( (sceneDir[x].endpoint != 0xFF)
+            && (sceneDir[x].endpoint == endpoint) &&
+            (sceneDir[x].groupID == groupID) )
         {
-            if( (sceneRecEmpty(&nvItem) == false)
-                && (nvItem.endpoint == endpoint) &&
-                (nvItem.scene.groupID == groupID) )
-            {
-                sceneList[cnt++] = nvItem.scene.ID;
-            }
+            sceneList[cnt++] = sceneDir[x].sceneID;
         }
     }
     return(cnt);
@@ -71,6 +71,11 @@
 /*******************************************************************************
  * CONSTANTS
  */
+// Number of buckets in the zone IEEE address hash, must be a power of 2
+#define ZCL_SS_ZONE_HASH_SIZE       32
+
+// End of a zone IEEE address hash chain
+#define ZCL_SS_ZONE_NONE            0xFF
 
 /*******************************************************************************
  * TYPEDEFS
@@ -84,8 +89,8 @@ typedef struct zclSSCBRec
 
 typedef struct zclSS_ZoneItem
 {
-  struct zclSS_ZoneItem   *next;
   uint8_t                   endpoint; // Used to link it into the endpoint descriptor
+  uint8_t                   hashNext; // Next zone ID in the IEEE address hash chain
   IAS_ACE_ZoneTable_t     zone;     // Zone info
 } zclSS_ZoneItem_t;
 
@@ -106,7 +111,11 @@ static uint8_t zclSSPluginRegisted = FALSE;
 static ZStatus_t (*zclSSUnsupportCallback)(zclIncoming_t* pInMsg) = NULL;
 
 #if defined(ZCL_ZONE) || defined(ZCL_ACE)
+// Zone table indexed by zone ID, allocated when the first zone enrolls
 static zclSS_ZoneItem_t *zclSS_ZoneTable = (zclSS_ZoneItem_t *)NULL;
+static uint16_t zclSS_ZoneIDMap[16];                    // Bit per zone ID in use
+static uint8_t zclSS_ZoneCount = 0;
+static uint8_t zclSS_ZoneHash[ZCL_SS_ZONE_HASH_SIZE];  // First zone ID per IEEE address bucket
 #endif // ZCL_ZONE || ZCL_ACE
 
 /*******************************************************************************
@@ -170,6 +179,12 @@ static uint8_t zclSS_ZoneIDAvailable( uint8_t zoneID );
 static uint8_t zclSS_Parse_UTF8String( uint8_t *pBuf, UTF8String_t *pString, uint8_t maxLen );
 #endif  // ZCL_ACE
 
+#if defined(ZCL_ZONE) || defined(ZCL_ACE)
+static uint8_t zclSS_ZoneHashKey( uint8_t *ieeeAddr );
+static void zclSS_ZoneHashAdd( uint8_t zoneID );
+static void zclSS_ZoneHashRemove( uint8_t zoneID );
+#endif // ZCL_ZONE || ZCL_ACE
+
 /******************************************************************************
  * @fn      zclSS_RegisterCmdCallbacks
  *
@@ -1348,38 +1363,37 @@ static ZStatus_t zclSS_ProcessInACECmdsClient( zclIncoming_t *pInMsg,
 static ZStatus_t zclSS_AddZone( uint8_t endpoint, IAS_ACE_ZoneTable_t *zone )
 {
   zclSS_ZoneItem_t *pNewItem;
-  zclSS_ZoneItem_t *pLoop;
 
-  // Fill in the new profile list
-  pNewItem = zcl_mem_alloc( sizeof( zclSS_ZoneItem_t ) );
-  if ( pNewItem == NULL )
+  if ( zone->zoneID > ZCL_SS_MAX_ZONE_ID )
   {
-    return ( ZMemError );
+    return ( ZInvalidParameter );
   }
 
-  // Fill in the plugin record.
-  pNewItem->next = (zclSS_ZoneItem_t *)NULL;
-  pNewItem->endpoint = endpoint;
-  zcl_memcpy( (uint8_t*)&(pNewItem->zone), (uint8_t*)zone, sizeof ( IAS_ACE_ZoneTable_t ));
-
-  // Find spot in list
-  if (  zclSS_ZoneTable == NULL )
-  {
-    zclSS_ZoneTable = pNewItem;
-  }
-  else
+  // Allocate the table on the first enrollment
+  if ( zclSS_ZoneTable == NULL )
   {
-    // Look for end of list
-    pLoop = zclSS_ZoneTable;
-    while ( pLoop->next != NULL )
+    zclSS_ZoneTable = zcl_mem_alloc( sizeof( zclSS_ZoneItem_t ) * ( ZCL_SS_MAX_ZONE_ID + 1 ) );
+    if ( zclSS_ZoneTable == NULL )
     {
-      pLoop = pLoop->next;
+      return ( ZMemError );
     }
 
-    // Put new item at end of list
-    pLoop->next = pNewItem;
+    zcl_memset( zclSS_ZoneIDMap, 0, sizeof( zclSS_ZoneIDMap ) );
+    zcl_memset( zclSS_ZoneHash, ZCL_SS_ZONE_NONE, sizeof( zclSS_ZoneHash ) );
+    zclSS_ZoneCount = 0;
   }
 
+  // Fill in the zone record
+  pNewItem = &zclSS_ZoneTable[zone->zoneID];
+  pNewItem->endpoint = endpoint;
+  pNewItem->hashNext = ZCL_SS_ZONE_NONE;
+  zcl_memcpy( (uint8_t*)&(pNewItem->zone), (uint8_t*)zone, sizeof ( IAS_ACE_ZoneTable_t ));
+
+  zclSS_ZoneIDMap[zone->zoneID >> 4] |= ( 0x01 << ( zone->zoneID & 0x0F ) );
+  zclSS_ZoneCount++;
+
+  zclSS_ZoneHashAdd( zone->zoneID );
+
   return ( ZSuccess );
 }
 
@@ -1394,17 +1408,7 @@ static ZStatus_t zclSS_AddZone( uint8_t endpoint, IAS_ACE_ZoneTable_t *zone )
  */
 uint8_t zclSS_CountAllZones( void )
 {
-  zclSS_ZoneItem_t *pLoop;
-  uint8_t cnt = 0;
-
-  // Look for end of list
-  pLoop = zclSS_ZoneTable;
-  while ( pLoop )
-  {
-    cnt++;
-    pLoop = pLoop->next;
-  }
-  return ( cnt );
+  return ( zclSS_ZoneCount );
 }
 
 /*********************************************************************
@@ -1460,18 +1464,11 @@ static uint8_t zclSS_GetNextFreeZoneID( void )
  */
 static uint8_t zclSS_ZoneIDAvailable( uint8_t zoneID )
 {
-  zclSS_ZoneItem_t *pLoop;
-
   if ( zoneID < ZCL_SS_MAX_ZONE_ID )
   {
-    pLoop = zclSS_ZoneTable;
-    while ( pLoop )
+    if ( zclSS_ZoneIDMap[zoneID >> 4] & ( 0x01 << ( zoneID & 0x0F ) ) )
     {
-      if ( pLoop->zone.zoneID == zoneID  )
-      {
-        return ( FALSE );
-      }
-      pLoop = pLoop->next;
+      return ( FALSE );
     }
 
     // Zone ID not in use
@@ -1495,17 +1492,57 @@ static uint8_t zclSS_ZoneIDAvailable( uint8_t zoneID )
  */
 IAS_ACE_ZoneTable_t *zclSS_FindZone( uint8_t endpoint, uint8_t zoneID )
 {
-  zclSS_ZoneItem_t *pLoop;
+  if ( ( zclSS_ZoneTable != NULL ) && ( zoneID <= ZCL_SS_MAX_ZONE_ID ) &&
+       ( zclSS_ZoneIDMap[zoneID >> 4] & ( 0x01 << ( zoneID & 0x0F ) ) ) &&
+       ( zclSS_ZoneTable[zoneID].endpoint == endpoint ) )
+  {
+    return ( &(zclSS_ZoneTable[zoneID].zone) );
+  }
+
+  return ( (IAS_ACE_ZoneTable_t *)NULL );
+}
+
+/*********************************************************************
+ * @fn      zclSS_FindZoneByAddr
+ *
+ * @brief   Find a zone with endpoint and Device IEEE Address
+ *
+ * @param   endpoint - endpoint of zone
+ * @param   ieeeAddr - Device IEEE Address
+ *
+ * @return  a pointer to the zone information, NULL if not found
+ */
+IAS_ACE_ZoneTable_t *zclSS_FindZoneByAddr( uint8_t endpoint, uint8_t *ieeeAddr )
+{
+  uint8_t zoneID;
+  uint8_t i;
+
+  if ( zclSS_ZoneTable == NULL )
+  {
+    return ( (IAS_ACE_ZoneTable_t *)NULL );
+  }
 
-  // Look for end of list
-  pLoop = zclSS_ZoneTable;
-  while ( pLoop )
+  zoneID = zclSS_ZoneHash[zclSS_ZoneHashKey( ieeeAddr )];
+  while ( zoneID != ZCL_SS_ZONE_NONE )
   {
-    if ( ( pLoop->endpoint == endpoint ) && ( pLoop->zone.zoneID == zoneID )  )
+    zclSS_ZoneItem_t *pItem = &zclSS_ZoneTable[zoneID];
+
+    if ( pItem->endpoint == endpoint )
     {
-      return ( &(pLoop->zone) );
+      for ( i = 0; i < Z_EXTADDR_LEN; i++ )
+      {
+        if ( pItem->zone.zoneAddress[i] != ieeeAddr[i] )
+        {
+          break;
+        }
+      }
+
+      if ( i == Z_EXTADDR_LEN )
+      {
+        return ( &(pItem->zone) );
+      }
     }
-    pLoop = pLoop->next;
+    zoneID = pItem->hashNext;
   }
 
   return ( (IAS_ACE_ZoneTable_t *)NULL );
@@ -1523,35 +1560,23 @@ IAS_ACE_ZoneTable_t *zclSS_FindZone( uint8_t endpoint, uint8_t zoneID )
  */
 uint8_t zclSS_RemoveZone( uint8_t endpoint, uint8_t zoneID )
 {
-  zclSS_ZoneItem_t *pLoop;
-  zclSS_ZoneItem_t *pPrev;
-
-  // Look for end of list
-  pLoop = zclSS_ZoneTable;
-  pPrev = NULL;
-  while ( pLoop )
+  if ( zclSS_FindZone( endpoint, zoneID ) == NULL )
   {
-    if ( pLoop->endpoint == endpoint && pLoop->zone.zoneID == zoneID )
-    {
-      if ( pPrev == NULL )
-      {
-        zclSS_ZoneTable = pLoop->next;
-      }
-      else
-      {
-        pPrev->next = pLoop->next;
-      }
+    return ( FALSE );
+  }
 
-      // Free the memory
-      zcl_mem_free( pLoop );
+  zclSS_ZoneHashRemove( zoneID );
 
-      return ( TRUE );
-    }
-    pPrev = pLoop;
-    pLoop = pLoop->next;
+  zclSS_ZoneIDMap[zoneID >> 4] &= ~( 0x01 << ( zoneID & 0x0F ) );
+
+  // Free the memory once the last zone is gone
+  if ( --zclSS_ZoneCount == 0 )
+  {
+    zcl_mem_free( zclSS_ZoneTable );
+    zclSS_ZoneTable = (zclSS_ZoneItem_t *)NULL;
   }
 
-  return ( FALSE );
+  return ( TRUE );
 }
 
 /*********************************************************************
@@ -1573,9 +1598,94 @@ void zclSS_UpdateZoneAddress( uint8_t endpoint, uint8_t zoneID, uint8_t *ieeeAdd
 
   if ( pZone != NULL )
   {
-    // Update the zone address
+    // Update the zone address and move the zone to its new hash bucket
+    zclSS_ZoneHashRemove( zoneID );
     zcl_cpyExtAddr( pZone->zoneAddress, ieeeAddr );
+    zclSS_ZoneHashAdd( zoneID );
+  }
+}
+
+/*********************************************************************
+ * @fn      zclSS_ZoneHashKey
+ *
+ * @brief   Hash a Device IEEE Address into a zone hash bucket
+ *
+ * @param   ieeeAddr - Device IEEE Address
+ *
+ * @return  bucket index
+ */
+static uint8_t zclSS_ZoneHashKey( uint8_t *ieeeAddr )
+{
+  uint8_t key = 0;
+  uint8_t i;
+
+  for ( i = 0; i < Z_EXTADDR_LEN; i++ )
+  {
+    key ^= ieeeAddr[i];
+  }
+
+  return ( key & ( ZCL_SS_ZONE_HASH_SIZE - 1 ) );
+}
+
+/*********************************************************************
+ * @fn      zclSS_ZoneHashAdd
+ *
+ * @brief   Link a zone into the IEEE address hash. Zones whose address
+ *          is still unknown are not hashed.
+ *
+ * @param   zoneID - ID of a zone in the table
+ *
+ * @return  none
+ */
+static void zclSS_ZoneHashAdd( uint8_t zoneID )
+{
+  zclSS_ZoneItem_t *pItem = &zclSS_ZoneTable[zoneID];
+  uint8_t key;
+  uint8_t i;
+
+  for ( i = 0; i < Z_EXTADDR_LEN; i++ )
+  {
+    if ( pItem->zone.zoneAddress[i] != zclSS_UknownIeeeAddress[i] )
+    {
+      break;
+    }
+  }
+
+  if ( i == Z_EXTADDR_LEN )
+  {
+    pItem->hashNext = ZCL_SS_ZONE_NONE;
+    return;
+  }
+
+  key = zclSS_ZoneHashKey( pItem->zone.zoneAddress );
+  pItem->hashNext = zclSS_ZoneHash[key];
+  zclSS_ZoneHash[key] = zoneID;
+}
+
+/*********************************************************************
+ * @fn      zclSS_ZoneHashRemove
+ *
+ * @brief   Unlink a zone from the IEEE address hash
+ *
+ * @param   zoneID - ID of a zone in the table
+ *
+ * @return  none
+ */
+static void zclSS_ZoneHashRemove( uint8_t zoneID )
+{
+  uint8_t *pLink = &zclSS_ZoneHash[zclSS_ZoneHashKey( zclSS_ZoneTable[zoneID].zone.zoneAddress )];
+
+  while ( *pLink != ZCL_SS_ZONE_NONE )
+  {
+    if ( *pLink == zoneID )
+    {
+      *pLink = zclSS_ZoneTable[zoneID].hashNext;
+      break;
+    }
+    pLink = &zclSS_ZoneTable[*pLink].hashNext;
   }
+
+  zclSS_ZoneTable[zoneID].hashNext = ZCL_SS_ZONE_NONE;
 }
 #endif // ZCL_ZONE || ZCL_ACE
 
@@ -2056,24 +2166,24 @@ static ZStatus_t zclSS_ProcessInCmd_ACE_GetZoneIDMap( zclIncoming_t *pInMsg, zcl
   ZStatus_t stat = ZFailure;
   uint16_t zoneIDMap[16];
   uint16_t mapSection;
-  uint8_t zoneID;
   uint8_t i, j;
 
+  // Start from the map of allocated Zone IDs and drop the zones that
+  // belong to other endpoints
+  zcl_memcpy( zoneIDMap, zclSS_ZoneIDMap, sizeof( zoneIDMap ) );
+
   for ( i = 0; i < 16; i++ )
   {
-    mapSection = 0;
+    mapSection = zoneIDMap[i];
 
-    // Find out Zone IDs that are allocated for this map section
-    for ( j = 0; j < 16; j++ )
+    for ( j = 0; mapSection != 0; j++, mapSection >>= 1 )
     {
-      zoneID = 16 * i + j;
-      if ( zclSS_FindZone( pInMsg->msg->endPoint, zoneID ) != NULL )
+      if ( ( mapSection & 0x01 ) &&
+           ( zclSS_ZoneTable[16 * i + j].endpoint != pInMsg->msg->endPoint ) )
       {
-        // Set the corresponding bit
-        mapSection |= ( 0x01 << j );
+        zoneIDMap[i] &= ~( 0x01 << j );
       }
     }
-    zoneIDMap[i] = mapSection;
   }
 
   if ( pCBs->pfnACE_GetZoneIDMap )
@@ -1050,6 +1050,15 @@ extern uint8_t zclSS_RemoveZone( uint8_t endpoint, uint8_t zoneID );
  * @return  a pointer to the zone information, NULL if not found
  */
 extern IAS_ACE_ZoneTable_t *zclSS_FindZone( uint8_t endpoint, uint8_t zoneID );
+
+
+/*!
+ * @param   endpoint - endpoint of zone to be found
+ * @param   ieeeAddr - Device IEEE Address, as set by zclSS_UpdateZoneAddress
+ *
+ * @return  a pointer to the zone information, NULL if not found
+ */
+extern IAS_ACE_ZoneTable_t *zclSS_FindZoneByAddr( uint8_t endpoint, uint8_t *ieeeAddr );
 #endif // ZCL_ZONE || ZCL_ACE
 /** @} End ZCL_ZONE_COMMANDS */
 
@@ -80,6 +80,13 @@ extern "C"
   #define ZDSECMGR_STORED_DEVICES 3
 #endif
 
+// number of chains in the EXT address index of the entry table, power of 2
+#if !defined ( ZDSECMGR_ENTRY_HASH_SIZE )
+  #define ZDSECMGR_ENTRY_HASH_SIZE 32
+#endif
+
+#define ZDSECMGR_ENTRY_HASH_NONE 0xFFFF
+
 // Joining Device Policies: r21 spec 4.9.1
 // This boolean indicates whether the device will request a new Trust Center Link key after joining.
 // TC link key cannot be requested if join is performed on distributed nwk
@@ -114,6 +121,13 @@ typedef struct
   uint8_t           devStatus;
 } ZDSecMgrDevice_t;
 
+// EXT address index node, one per ZDSecMgrEntries[] element
+typedef struct
+{
+  uint8_t           extAddr[Z_EXTADDR_LEN];
+  uint16_t          next;
+} ZDSecMgrEntryHash_t;
+
 /******************************************************************************
  * EXTERNAL VARIABLES
  */
@@ -151,6 +165,16 @@ uint8_t ZDSecMgrTCAuthenticated = FALSE;
 
 ZDSecMgrEntry_t* ZDSecMgrEntries  = NULL;
 
+// EXT address index of ZDSecMgrEntries, rebuilt from the Address Manager
+// on the first lookup after the entries are (re)loaded
+static ZDSecMgrEntryHash_t* ZDSecMgrEntryHashNodes = NULL;
+static uint16_t ZDSecMgrEntryHashHead[ZDSECMGR_ENTRY_HASH_SIZE];
+static uint8_t ZDSecMgrEntryHashValid = FALSE;
+
+// RAM copy of ZCD_NV_TCLK_SEED, cleared whenever the seed is regenerated
+static uint8_t ZDSecMgrTclkSeed[SEC_KEY_LEN];
+static uint8_t ZDSecMgrTclkSeedValid = FALSE;
+
 void ZDSecMgrAddrMgrCB( uint8_t update, AddrMgrEntry_t* newEntry, AddrMgrEntry_t* oldEntry );
 
 uint8_t ZDSecMgrPermitJoiningEnabled;
@@ -219,6 +243,11 @@ ZStatus_t ZDSecMgrEntryLookupExtGetIndex( uint8_t* extAddr, ZDSecMgrEntry_t** en
 ZStatus_t ZDSecMgrEntryLookupAMIGetIndex( uint16_t ami, uint16_t* entryIndex );
 void ZDSecMgrEntryFree( ZDSecMgrEntry_t* entry );
 ZStatus_t ZDSecMgrEntryNew( ZDSecMgrEntry_t** entry );
+static uint16_t ZDSecMgrEntryHashKey( uint8_t* extAddr );
+static void ZDSecMgrEntryHashBuild( void );
+static void ZDSecMgrEntryHashAdd( uint16_t index, uint8_t* extAddr );
+static void ZDSecMgrEntryHashRemove( uint16_t index );
+static ZStatus_t ZDSecMgrEntryHashLookup( uint8_t* extAddr, uint16_t* entryIndex );
 ZStatus_t ZDSecMgrAuthenticationSet( uint8_t* extAddr, ZDSecMgr_Authentication_Option option );
 void ZDSecMgrApsLinkKeyInit(uint8_t setDefault);
 #if defined ( NV_RESTORE )
@@ -441,8 +470,13 @@ void ZDSecMgrEntryInit(uint8_t state)
 
       ZDSecMgrEntries[index].keyNvId = SEC_NO_KEY_NV_ID;
     }
+
+    // without the index, lookups fall back to the Address Manager
+    ZDSecMgrEntryHashNodes = OsalPort_malloc(sizeof(ZDSecMgrEntryHash_t) * gZDSECMGR_ENTRY_MAX);
   }
 
+  ZDSecMgrEntryHashValid = FALSE;
+
 #if defined NV_RESTORE
   if (state == ZDO_INITDEV_RESTORED_NETWORK_STATE)
   {
@@ -545,16 +579,16 @@ ZStatus_t ZDSecMgrEntryLookupAMI( uint16_t ami, ZDSecMgrEntry_t** entry )
 ZStatus_t ZDSecMgrEntryLookupExt( uint8_t* extAddr, ZDSecMgrEntry_t** entry )
 {
   ZStatus_t status;
-  uint16_t    ami;
+  uint16_t  index;
 
   // initialize results
   *entry = NULL;
-  status = ZNwkUnknownDevice;
 
-  // lookup address index
-  if ( ZDSecMgrExtAddrLookup( extAddr, &ami ) == ZSuccess )
+  status = ZDSecMgrEntryHashLookup( extAddr, &index );
+
+  if ( status == ZSuccess )
   {
-    status = ZDSecMgrEntryLookupAMI( ami, entry );
+    *entry = &ZDSecMgrEntries[index];
   }
 
   return status;
@@ -572,26 +606,210 @@ ZStatus_t ZDSecMgrEntryLookupExt( uint8_t* extAddr, ZDSecMgrEntry_t** entry )
  */
 ZStatus_t ZDSecMgrEntryLookupExtGetIndex( uint8_t* extAddr, ZDSecMgrEntry_t** entry, uint16_t* entryIndex )
 {
-  uint16_t ami;
   uint16_t index;
 
+  if ( ZDSecMgrEntryHashLookup( extAddr, &index ) == ZSuccess )
+  {
+    // return successful results
+    *entry = &ZDSecMgrEntries[index];
+    *entryIndex = index;
+
+    return ZSuccess;
+  }
+
+  return ZNwkUnknownDevice;
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryHashKey
+ *
+ * @brief       Index chain of an EXT address.
+ *
+ * @param       extAddr - [in] EXT address
+ *
+ * @return      uint16_t - chain number
+ */
+static uint16_t ZDSecMgrEntryHashKey( uint8_t* extAddr )
+{
+  // the low order bytes vary the most between devices
+  return ( ( extAddr[0] ^ ((uint16_t)extAddr[1] << 3) ^ extAddr[2] ^ ((uint16_t)extAddr[3] << 5) )
+           & ( ZDSECMGR_ENTRY_HASH_SIZE - 1 ) );
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryHashBuild
+ *
+ * @brief       Rebuild the EXT address index of the entry table from the
+ *              Address Manager, if it isn't up to date.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+static void ZDSecMgrEntryHashBuild( void )
+{
+  AddrMgrEntry_t addrEntry;
+  uint16_t       index;
+  uint16_t       key;
+
+  if ( ZDSecMgrEntryHashValid == TRUE )
+  {
+    return;
+  }
+
+  memset( ZDSecMgrEntryHashHead, 0xFF, sizeof( ZDSecMgrEntryHashHead ) );
+
+  for ( index = 0; index < gZDSECMGR_ENTRY_MAX; index++ )
+  {
+    if ( ZDSecMgrEntries[index].ami != INVALID_NODE_ADDR )
+    {
+      addrEntry.user  = ADDRMGR_USER_SECURITY;
+      addrEntry.index = ZDSecMgrEntries[index].ami;
+
+      if ( AddrMgrEntryGet( &addrEntry ) == TRUE )
+      {
+        key = ZDSecMgrEntryHashKey( addrEntry.extAddr );
+
+        AddrMgrExtAddrSet( ZDSecMgrEntryHashNodes[index].extAddr, addrEntry.extAddr );
+        ZDSecMgrEntryHashNodes[index].next = ZDSecMgrEntryHashHead[key];
+        ZDSecMgrEntryHashHead[key] = index;
+      }
+    }
+  }
+
+  ZDSecMgrEntryHashValid = TRUE;
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryHashAdd
+ *
+ * @brief       Add an entry to the EXT address index.
+ *
+ * @param       index   - [in] entry table index
+ * @param       extAddr - [in] EXT address of the entry
+ *
+ * @return      none
+ */
+static void ZDSecMgrEntryHashAdd( uint16_t index, uint8_t* extAddr )
+{
+  uint16_t key;
+
+  if ( ( ZDSecMgrEntryHashNodes == NULL ) || ( ZDSecMgrEntryHashValid == FALSE ) )
+  {
+    // picked up by the next rebuild
+    return;
+  }
+
+  ZDSecMgrEntryHashRemove( index );
+
+  key = ZDSecMgrEntryHashKey( extAddr );
+
+  AddrMgrExtAddrSet( ZDSecMgrEntryHashNodes[index].extAddr, extAddr );
+  ZDSecMgrEntryHashNodes[index].next = ZDSecMgrEntryHashHead[key];
+  ZDSecMgrEntryHashHead[key] = index;
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryHashRemove
+ *
+ * @brief       Remove an entry from the EXT address index.
+ *
+ * @param       index - [in] entry table index
+ *
+ * @return      none
+ */
+static void ZDSecMgrEntryHashRemove( uint16_t index )
+{
+  uint16_t* pLink;
+
+  if ( ( ZDSecMgrEntryHashNodes == NULL ) || ( ZDSecMgrEntryHashValid == FALSE ) )
+  {
+    return;
+  }
+
+  pLink = &ZDSecMgrEntryHashHead[ZDSecMgrEntryHashKey( ZDSecMgrEntryHashNodes[index].extAddr )];
+
+  while ( *pLink != ZDSECMGR_ENTRY_HASH_NONE )
+  {
+    if ( *pLink == index )
+    {
+      *pLink = ZDSecMgrEntryHashNodes[index].next;
+      break;
+    }
+
+    pLink = &ZDSecMgrEntryHashNodes[*pLink].next;
+  }
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryHashLookup
+ *
+ * @brief       Lookup entry table index using specified EXT address.
+ *
+ * @param       extAddr    - [in] EXT address
+ * @param       entryIndex - [out] valid index to the entry table
+ *
+ * @return      ZStatus_t
+ */
+static ZStatus_t ZDSecMgrEntryHashLookup( uint8_t* extAddr, uint16_t* entryIndex )
+{
+  AddrMgrEntry_t addrEntry;
+  uint16_t       ami;
+  uint16_t       index;
+
+  // verify data is available
+  if ( ZDSecMgrEntries == NULL )
+  {
+    return ZNwkUnknownDevice;
+  }
+
+  if ( ZDSecMgrEntryHashNodes != NULL )
+  {
+    ZDSecMgrEntryHashBuild();
+
+    index = ZDSecMgrEntryHashHead[ZDSecMgrEntryHashKey( extAddr )];
+
+    while ( ( index != ZDSECMGR_ENTRY_HASH_NONE ) &&
+            ( AddrMgrExtAddrEqual( ZDSecMgrEntryHashNodes[index].extAddr, extAddr ) == FALSE ) )
+    {
+      index = ZDSecMgrEntryHashNodes[index].next;
+    }
+
+    if ( index == ZDSECMGR_ENTRY_HASH_NONE )
+    {
+      return ZNwkUnknownDevice;
+    }
+
+    // make sure the Address Manager still maps the entry to this device
+    addrEntry.user  = ADDRMGR_USER_SECURITY;
+    addrEntry.index = ZDSecMgrEntries[index].ami;
+
+    if ( ( addrEntry.index != INVALID_NODE_ADDR ) &&
+         ( AddrMgrEntryGet( &addrEntry ) == TRUE ) &&
+         ( AddrMgrExtAddrEqual( addrEntry.extAddr, extAddr ) == TRUE ) )
+    {
+      *entryIndex = index;
+
+      return ZSuccess;
+    }
+
+    // stale, drop it and search the slow way
+    ZDSecMgrEntryHashRemove( index );
+  }
+
   // lookup address index
   if ( ZDSecMgrExtAddrLookup( extAddr, &ami ) == ZSuccess )
   {
-    // verify data is available
-    if ( ZDSecMgrEntries != NULL )
+    for ( index = 0; index < gZDSECMGR_ENTRY_MAX ; index++ )
     {
-      for ( index = 0; index < gZDSECMGR_ENTRY_MAX ; index++ )
+      if ( ZDSecMgrEntries[index].ami == ami )
       {
-        if ( ZDSecMgrEntries[index].ami == ami )
-        {
-          // return successful results
-          *entry = &ZDSecMgrEntries[index];
-          *entryIndex = index;
+        ZDSecMgrEntryHashAdd( index, extAddr );
 
-          // break from loop
-          return ZSuccess;
-        }
+        // return successful results
+        *entryIndex = index;
+
+        return ZSuccess;
       }
     }
   }
@@ -668,6 +886,8 @@ void ZDSecMgrEntryFree( ZDSecMgrEntry_t* entry )
     OsalPort_free(pApsLinkKey);
   }
 
+  ZDSecMgrEntryHashRemove( (uint16_t)( entry - ZDSecMgrEntries ) );
+
   // marking the entry as INVALID_NODE_ADDR
   entry->ami = INVALID_NODE_ADDR;
 
@@ -1885,6 +2105,11 @@ void ZDSecMgrTransportKeyInd( ZDO_TransportKeyInd_t* ind )
       }
     }
 
+    if ( entry != NULL )
+    {
+      ZDSecMgrEntryHashAdd( (uint16_t)( entry - ZDSecMgrEntries ), ind->srcExtAddr );
+    }
+
     ZDSecMgrLinkKeySet( ind->srcExtAddr, ind->key );
 
 #if defined NV_RESTORE
@@ -2122,6 +2347,10 @@ void ZDSecMgrGenerateSeed(uint8_t SetDefault)
   }
 
   memset(SeedKey,0,SEC_KEY_LEN);
+
+  //Reload the cached seed on the next key derivation
+  memset(ZDSecMgrTclkSeed,0,SEC_KEY_LEN);
+  ZDSecMgrTclkSeedValid = FALSE;
 }
 
 
@@ -2141,16 +2370,21 @@ void ZDSecMgrGenerateSeed(uint8_t SetDefault)
 void ZDSecMgrGenerateKeyFromSeed(uint8_t *extAddr, uint8_t shift, uint8_t *key)
 {
   uint8_t i;
-  uint8_t tempKey[SEC_KEY_LEN];
 
   if((key != NULL) && (extAddr != NULL))
   {
-    //Read the key
-    osal_nv_read(ZCD_NV_TCLK_SEED,0,SEC_KEY_LEN,tempKey);
+    //Read the seed once, it only changes through ZDSecMgrGenerateSeed()
+    if(ZDSecMgrTclkSeedValid == FALSE)
+    {
+      if(osal_nv_read(ZCD_NV_TCLK_SEED,0,SEC_KEY_LEN,ZDSecMgrTclkSeed) == SUCCESS)
+      {
+        ZDSecMgrTclkSeedValid = TRUE;
+      }
+    }
 
     //shift the seed
-    OsalPort_memcpy(key, &tempKey[shift], SEC_KEY_LEN - shift);
-    OsalPort_memcpy(&key[SEC_KEY_LEN - shift], tempKey, shift);
+    OsalPort_memcpy(key, &ZDSecMgrTclkSeed[shift], SEC_KEY_LEN - shift);
+    OsalPort_memcpy(&key[SEC_KEY_LEN - shift], ZDSecMgrTclkSeed, shift);
 
     //Create the key from the seed
     for(i = 0; i < Z_EXTADDR_LEN; i++)
@@ -2704,6 +2938,8 @@ ZStatus_t ZDSecMgrAddLinkKey( uint16_t shortAddr, uint8_t *extAddr, uint8_t *key
       return ZBufferFull;
     }
   }
+
+  ZDSecMgrEntryHashAdd( (uint16_t)( entry - ZDSecMgrEntries ), extAddr );
   // Write the link key
   APSME_LinkKeySet( extAddr, key );
 
@@ -71,6 +71,31 @@
  *                                               CONSTANTS
  ********************************************************************************************************/
 
+/* Number of preallocated MAC event message slots (at most 32) */
+#if !defined ( ZMAC_EVT_RING_SIZE )
+#define ZMAC_EVT_RING_SIZE        8
+#endif
+
+/* Beacon payload bytes a slot can hold; larger events fall back to the heap */
+#if !defined ( ZMAC_EVT_SLOT_SDU_LEN )
+#define ZMAC_EVT_SLOT_SDU_LEN     16
+#endif
+
+/* Slot payload size, sized for a beacon notify with its PAN descriptor and payload */
+#define ZMAC_EVT_SLOT_LEN         ( sizeof(macMlmeBeaconNotifyInd_t) + sizeof(macPanDesc_t) + ZMAC_EVT_SLOT_SDU_LEN )
+
+/* Number of beacon sources remembered per scan to drop repeated beacons */
+#if !defined ( ZMAC_BEACON_DEDUP_SIZE )
+#define ZMAC_BEACON_DEDUP_SIZE    16
+#endif
+
+/* Offset of the extended PAN ID in a Zigbee beacon payload */
+#define ZMAC_BEACON_EPID_OFFSET   3
+
+#if ( ZMAC_EVT_RING_SIZE < 1 ) || ( ZMAC_EVT_RING_SIZE > 32 )
+#error "ZMAC_EVT_RING_SIZE must be between 1 and 32"
+#endif
+
 /* Lookup table for size of structures. Must match with the order of MAC callback events */
 const uint8_t CODE zmacCBSizeTable [] = {
   0,
@@ -94,10 +119,51 @@ const uint8_t CODE zmacCBSizeTable [] = {
   0                                 // MAC_MLME_WS_ASYNC_IND       18  WiSUN Async frame indication
 };
 
+/********************************************************************************************************
+ *                                               TYPEDEFS
+ ********************************************************************************************************/
+
+/* MAC event slot, laid out like a buffer from OsalPort_msgAllocate() */
+typedef struct
+{
+  OsalPort_MsgHdr hdr;
+  uint32_t data[( ZMAC_EVT_SLOT_LEN + 3 ) / 4];
+} zmacEvtSlot_t;
+
+/* Source of a beacon already passed up during the current scan */
+typedef struct
+{
+  sAddr_t  coordAddress;
+  uint8_t  extPanId[Z_EXTADDR_LEN];
+} zmacBeaconSeen_t;
+
 /********************************************************************************************************
  *                                               LOCALS
  ********************************************************************************************************/
 
+/* MAC event ring, filled by the MAC callback and released when NWK deallocates the message */
+static zmacEvtSlot_t zmacEvtRing[ZMAC_EVT_RING_SIZE];
+static uint32_t zmacEvtRingUsed = 0;       // Bit per slot in use
+static uint8_t zmacEvtRingNext = 0;        // Next slot to try
+static uint8_t zmacEvtRingInUse = 0;
+static uint8_t zmacEvtRingHighWater = 0;   // Most slots ever in use at once
+static uint16_t zmacEvtRingFallbacks = 0;  // Events allocated from the heap instead
+static bool zmacEvtRingRegistered = false;
+
+static uint8_t *ZMacEventAlloc( uint16_t len );
+static void ZMacEventRelease( uint8_t *pMsg );
+
+/* Beacon filter predicate, installed while NWK/BDB is discovering networks */
+static ZMacBeaconFilter_t pZMacBeaconFilter = NULL;
+
+/* Beacon sources seen during the current scan */
+static zmacBeaconSeen_t zmacBeaconSeen[ZMAC_BEACON_DEDUP_SIZE];
+static uint8_t zmacBeaconSeenCnt = 0;
+
+static uint8_t *ZMacBeaconExtPanId( macBeaconData_t *pBeaconData );
+static bool ZMacBeaconRepeated( macBeaconData_t *pBeaconData );
+static void ZMacBeaconRecord( macBeaconData_t *pBeaconData );
+
 /* LQI Adjustment Mode */
 static ZMacLqiAdjust_t lqiAdjMode = LQI_ADJ_OFF;
 
@@ -143,6 +209,12 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
   macCbackEvent_t *msgPtr;
   bool gpDataCnf = false;
 
+  /* A scan is over, beacons from the next scan are new again */
+  if (event == MAC_MLME_SCAN_CNF)
+  {
+    zmacBeaconSeenCnt = 0;
+  }
+
   /* If the Network layer will handle a new MAC callback, a non-zero value must be entered in the
    * corresponding location in the zmacCBSizeTable[] - thus the table acts as "should handle"?
    */
@@ -192,6 +264,14 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
           /* Drop the message */
           return;
       }
+
+      /* While discovering, drop non-candidate and repeated beacons before anything is allocated */
+      if ( (pZMacBeaconFilter != NULL) &&
+           ( (pZMacBeaconFilter( &pData->beaconNotifyInd ) == FALSE) ||
+             ZMacBeaconRepeated( &pData->beaconNotifyInd.info.beaconData ) ) )
+      {
+          return;
+      }
       tmp += sizeof(macPanDesc_t) + pData->beaconNotifyInd.info.beaconData.sduLength;
     }
     else if (event == MAC_MLME_SCAN_CNF)
@@ -213,7 +293,7 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
       }
     }
 
-    if ( !(msgPtr = (macCbackEvent_t *)OsalPort_msgAllocate(tmp)) )
+    if ( !(msgPtr = (macCbackEvent_t *)ZMacEventAlloc(tmp)) )
     {
       // Not enough memory. If data confirm - try again
       if ((event == MAC_MCPS_DATA_CNF) && (pData->dataCnf.pDataReq != NULL))
@@ -225,7 +305,7 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
         HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
         MAP_mac_msg_deallocate( (uint8_t**)&(pData->dataCnf.pDataReq) );
-        if ( !(msgPtr = (macCbackEvent_t *)OsalPort_msgAllocate(tmp)) )
+        if ( !(msgPtr = (macCbackEvent_t *)ZMacEventAlloc(tmp)) )
         {
           // Still no allocation, something is wrong
           HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
@@ -372,7 +452,12 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
     }
     else
     {
-      OsalPort_msgSend( NWK_TaskID, (uint8_t *)msgPtr );
+      if ( ( OsalPort_msgSend( NWK_TaskID, (uint8_t *)msgPtr ) == OsalPort_SUCCESS ) &&
+           ( event == MAC_MLME_BEACON_NOTIFY_IND ) && ( pZMacBeaconFilter != NULL ) )
+      {
+        // Only a beacon that was passed up suppresses its repeats
+        ZMacBeaconRecord( &pData->beaconNotifyInd.info.beaconData );
+      }
     }
   }
 
@@ -386,6 +471,230 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
   }
 }
 
+/********************************************************************************************************
+ * @fn      ZMacSetBeaconFilter
+ *
+ * @brief   Install the predicate used to drop beacons before they are queued to NWK
+ *
+ * @param   pfnFilter - returns FALSE for beacons that are not join candidates,
+ *                      NULL to pass up every beacon
+ *
+ * @return  none
+ ********************************************************************************************************/
+void ZMacSetBeaconFilter( ZMacBeaconFilter_t pfnFilter )
+{
+  pZMacBeaconFilter = pfnFilter;
+  zmacBeaconSeenCnt = 0;
+}
+
+/********************************************************************************************************
+ * @fn      ZMacBeaconExtPanId
+ *
+ * @brief   Find the extended PAN ID in the payload of a Zigbee beacon
+ *
+ * @param   pBeaconData - beacon PAN descriptor and payload
+ *
+ * @return  pointer to the extended PAN ID, NULL if the beacon does not carry one
+ ********************************************************************************************************/
+static uint8_t *ZMacBeaconExtPanId( macBeaconData_t *pBeaconData )
+{
+  if ( ( pBeaconData->pPanDesc == NULL ) || ( pBeaconData->pSdu == NULL ) ||
+       ( pBeaconData->sduLength < ( ZMAC_BEACON_EPID_OFFSET + Z_EXTADDR_LEN ) ) )
+  {
+    return ( NULL );
+  }
+
+  return ( &pBeaconData->pSdu[ZMAC_BEACON_EPID_OFFSET] );
+}
+
+/********************************************************************************************************
+ * @fn      ZMacBeaconRepeated
+ *
+ * @brief   Check whether a beacon from the same network and source was already passed up
+ *          during this scan. Networks that share a PAN ID are told apart by their
+ *          extended PAN ID.
+ *
+ * @param   pBeaconData - beacon PAN descriptor and payload
+ *
+ * @return  TRUE if the beacon is a repeat
+ ********************************************************************************************************/
+static bool ZMacBeaconRepeated( macBeaconData_t *pBeaconData )
+{
+  zmacBeaconSeen_t *pSeen;
+  sAddr_t *pAddr;
+  uint8_t *pExtPanId = ZMacBeaconExtPanId( pBeaconData );
+  uint8_t i;
+
+  if ( pExtPanId == NULL )
+  {
+    return ( false );
+  }
+
+  pAddr = &pBeaconData->pPanDesc->coordAddress;
+
+  for ( i = 0; i < zmacBeaconSeenCnt; i++ )
+  {
+    pSeen = &zmacBeaconSeen[i];
+
+    if ( (pSeen->coordAddress.addrMode == pAddr->addrMode) &&
+         OsalPort_memcmp( pSeen->extPanId, pExtPanId, Z_EXTADDR_LEN ) )
+    {
+      if ( pSeen->coordAddress.addrMode == SADDR_MODE_SHORT )
+      {
+        if ( pSeen->coordAddress.addr.shortAddr == pAddr->addr.shortAddr )
+        {
+          return ( true );
+        }
+      }
+      else if ( OsalPort_memcmp( pSeen->coordAddress.addr.extAddr,
+                                 pAddr->addr.extAddr, SADDR_EXT_LEN ) )
+      {
+        return ( true );
+      }
+    }
+  }
+
+  return ( false );
+}
+
+/********************************************************************************************************
+ * @fn      ZMacBeaconRecord
+ *
+ * @brief   Remember the network and source of a beacon that was passed up during this scan
+ *
+ * @param   pBeaconData - beacon PAN descriptor and payload
+ *
+ * @return  none
+ ********************************************************************************************************/
+static void ZMacBeaconRecord( macBeaconData_t *pBeaconData )
+{
+  zmacBeaconSeen_t *pSeen;
+  uint8_t *pExtPanId = ZMacBeaconExtPanId( pBeaconData );
+
+  // Once the table is full, further sources are passed up without tracking
+  if ( ( pExtPanId != NULL ) && ( zmacBeaconSeenCnt < ZMAC_BEACON_DEDUP_SIZE ) )
+  {
+    pSeen = &zmacBeaconSeen[zmacBeaconSeenCnt++];
+    pSeen->coordAddress = pBeaconData->pPanDesc->coordAddress;
+    OsalPort_memcpy( pSeen->extPanId, pExtPanId, Z_EXTADDR_LEN );
+  }
+}
+
+/********************************************************************************************************
+ * @fn      ZMacEventAlloc
+ *
+ * @brief   Allocate a message for a MAC callback event. The next free slot of the
+ *          preallocated event ring is used when the event fits; the heap is only
+ *          used when the ring is exhausted or the event is too large for a slot.
+ *
+ * @param   len - message length
+ *
+ * @return  pointer to the message, NULL if there is no memory
+ ********************************************************************************************************/
+static uint8_t *ZMacEventAlloc( uint16_t len )
+{
+  halIntState_t intState;
+  uint8_t *pMsg = NULL;
+  uint8_t i;
+
+  if ( !zmacEvtRingRegistered )
+  {
+    zmacEvtRingRegistered = true;
+    OsalPort_msgPoolRegister( (uint8_t *)zmacEvtRing, (uint8_t *)&zmacEvtRing[ZMAC_EVT_RING_SIZE],
+                              ZMacEventRelease );
+  }
+
+  if ( len <= ZMAC_EVT_SLOT_LEN )
+  {
+    HAL_ENTER_CRITICAL_SECTION( intState );
+
+    for ( i = 0; i < ZMAC_EVT_RING_SIZE; i++ )
+    {
+      uint8_t idx = zmacEvtRingNext;
+
+      if ( ++zmacEvtRingNext == ZMAC_EVT_RING_SIZE )
+      {
+        zmacEvtRingNext = 0;
+      }
+
+      if ( (zmacEvtRingUsed & ((uint32_t)1 << idx)) == 0 )
+      {
+        zmacEvtSlot_t *pSlot = &zmacEvtRing[idx];
+
+        zmacEvtRingUsed |= ((uint32_t)1 << idx);
+        if ( ++zmacEvtRingInUse > zmacEvtRingHighWater )
+        {
+          zmacEvtRingHighWater = zmacEvtRingInUse;
+        }
+
+        pSlot->hdr.next = NULL;
+        pSlot->hdr.len = len;
+        pSlot->hdr.dest_id = OsalPort_TASK_NO_TASK;
+        pMsg = (uint8_t *)pSlot->data;
+        break;
+      }
+    }
+
+    HAL_EXIT_CRITICAL_SECTION( intState );
+  }
+
+  if ( pMsg == NULL )
+  {
+    zmacEvtRingFallbacks++;
+    pMsg = OsalPort_msgAllocate( len );
+  }
+
+  return ( pMsg );
+}
+
+/********************************************************************************************************
+ * @fn      ZMacEventRelease
+ *
+ * @brief   Return a MAC event ring slot. Called by OsalPort_msgDeallocate() once the
+ *          consumer of the event is done with it.
+ *
+ * @param   pMsg - message inside the event ring
+ *
+ * @return  none
+ ********************************************************************************************************/
+static void ZMacEventRelease( uint8_t *pMsg )
+{
+  halIntState_t intState;
+  uint8_t idx = (uint8_t)((pMsg - (uint8_t *)zmacEvtRing) / sizeof( zmacEvtSlot_t ));
+
+  HAL_ENTER_CRITICAL_SECTION( intState );
+
+  if ( zmacEvtRingUsed & ((uint32_t)1 << idx) )
+  {
+    zmacEvtRingUsed &= ~((uint32_t)1 << idx);
+    zmacEvtRingInUse--;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );
+}
+
+/********************************************************************************************************
+ * @fn      ZMacEventRingStats
+ *
+ * @brief   Return the MAC event ring usage counters
+ *
+ * @param   pHighWater - filled with the most ring slots ever in use at once
+ * @param   pFallbacks - filled with the number of events allocated from the heap
+ *
+ * @return  none
+ ********************************************************************************************************/
+void ZMacEventRingStats( uint8_t *pHighWater, uint16_t *pFallbacks )
+{
+  if ( pHighWater != NULL )
+  {
+    *pHighWater = zmacEvtRingHighWater;
+  }
+  if ( pFallbacks != NULL )
+  {
+    *pFallbacks = zmacEvtRingFallbacks;
+  }
+}
+
 /********************************************************************************************************
  * @fn      MAC_CbackCheckPending
  *
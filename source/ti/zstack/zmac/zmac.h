@@ -485,6 +485,9 @@ typedef struct
 
 typedef uint8_t (*applySecCB_t)( uint8_t len, uint8_t *msdu );
 
+/* Beacon filter predicate, returns FALSE to drop a beacon before it is queued to NWK */
+typedef uint8_t (*ZMacBeaconFilter_t)( macMlmeBeaconNotifyInd_t *pBeacon );
+
 typedef enum
 {
   LQI_ADJ_OFF = 0,
@@ -670,6 +673,17 @@ typedef enum
    */
   extern ZMacLqiAdjust_t ZMacLqiAdjustMode( ZMacLqiAdjust_t mode );
 
+  /*
+   * This function returns the MAC event ring high-water mark and the
+   * number of events that fell back to heap allocation.
+   */
+  extern void ZMacEventRingStats( uint8_t *pHighWater, uint16_t *pFallbacks );
+
+  /*
+   * This function installs the beacon filter used during network discovery.
+   */
+  extern void ZMacSetBeaconFilter( ZMacBeaconFilter_t pfnFilter );
+
   /*
    * This function sends out an enhanced active scan request
    */